@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vbase64.h"
+
+/*
+ * Microbenchmark of the embedded image base64 decoder.
+ * "legacy" is the decoder the parser used before (decodes into a
+ * std::string which was copied once more into the asset).
+ */
+
+static constexpr const unsigned char B64index[256] = {
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  62, 63, 62, 62, 63, 52, 53, 54, 55, 56, 57,
+    58, 59, 60, 61, 0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  3,  4,  5,  6,
+    7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 0,  0,  0,  0,  63, 0,  26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
+    37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51};
+
+static std::string legacyDecode(const char *data, const size_t len)
+{
+    auto         p = reinterpret_cast<const unsigned char *>(data);
+    int          pad = len > 0 && (len % 4 || p[len - 1] == '=');
+    const size_t L = ((len + 3) / 4 - pad) * 4;
+    std::string  str(L / 4 * 3 + pad, '\0');
+
+    for (size_t i = 0, j = 0; i < L; i += 4) {
+        int n = B64index[p[i]] << 18 | B64index[p[i + 1]] << 12 |
+                B64index[p[i + 2]] << 6 | B64index[p[i + 3]];
+        str[j++] = n >> 16;
+        str[j++] = n >> 8 & 0xFF;
+        str[j++] = n & 0xFF;
+    }
+    if (pad) {
+        int n = B64index[p[L]] << 18 | B64index[p[L + 1]] << 12;
+        str[str.size() - 1] = n >> 16;
+
+        if (len > L + 2 && p[L + 2] != '=') {
+            n |= B64index[p[L + 2]] << 6;
+            str.push_back(n >> 8 & 0xFF);
+        }
+    }
+    return str;
+}
+
+static std::string encode(const std::vector<uint8_t> &in)
+{
+    static const char *table =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    size_t      i = 0;
+    for (; i + 3 <= in.size(); i += 3) {
+        uint32_t n = in[i] << 16 | in[i + 1] << 8 | in[i + 2];
+        out += table[n >> 18];
+        out += table[(n >> 12) & 63];
+        out += table[(n >> 6) & 63];
+        out += table[n & 63];
+    }
+    if (i < in.size()) {
+        uint32_t n = in[i] << 16 | (i + 1 < in.size() ? in[i + 1] << 8 : 0);
+        out += table[n >> 18];
+        out += table[(n >> 12) & 63];
+        out += (i + 1 < in.size()) ? table[(n >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+
+template <typename Fn>
+static double measure(size_t iterations, Fn fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; i++) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() /
+           iterations;
+}
+
+int main(int argc, char **argv)
+{
+    size_t size = (argc > 1) ? size_t(atol(argv[1])) : 4 * 1024 * 1024;
+    size_t iterations = (argc > 2) ? size_t(atol(argv[2])) : 20;
+
+    std::vector<uint8_t> raw(size);
+    std::mt19937         rng(7);
+    for (auto &c : raw) c = uint8_t(rng());
+    auto input = encode(raw);
+
+    std::vector<uint8_t> buffer(vBase64DecodedSize(input.size()));
+    size_t               decoded = 0;
+
+    std::string legacy;
+    double legacyTime = measure(iterations, [&] {
+        // decode + the copy into the asset done by the old parser
+        std::string tmp = legacyDecode(input.c_str(), input.size());
+        legacy = tmp;
+    });
+    double scalarTime = measure(iterations, [&] {
+        decoded = vBase64DecodeScalar(input.c_str(), input.size(), buffer.data());
+    });
+    bool scalarOk = decoded == raw.size() && !memcmp(buffer.data(), raw.data(), decoded);
+    double simdTime = measure(iterations, [&] {
+        decoded = vBase64Decode(input.c_str(), input.size(), buffer.data());
+    });
+    bool simdOk = decoded == raw.size() && !memcmp(buffer.data(), raw.data(), decoded);
+    bool legacyOk = legacy.size() == raw.size() && !memcmp(legacy.data(), raw.data(), raw.size());
+
+    std::cout << "base64 input " << input.size() << " bytes, " << iterations
+              << " iterations\n";
+    std::cout << "legacy : " << legacyTime << " ms " << (legacyOk ? "ok" : "MISMATCH") << "\n";
+    std::cout << "scalar : " << scalarTime << " ms " << (scalarOk ? "ok" : "MISMATCH") << "\n";
+    std::cout << "simd   : " << simdTime << " ms " << (simdOk ? "ok" : "MISMATCH")
+              << " (" << legacyTime / simdTime << "x)\n";
+
+    return (legacyOk && scalarOk && simdOk) ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "vinterpolator.h"
+
+/*
+ * Microbenchmark of the keyframe easing evaluation, solving the bezier
+ * (the default) against the lookup tables enabled by LOTTIE_EASING_LUT.
+ * The curves are the usual After Effects / bodymovin easings.
+ */
+
+struct Curve {
+    float x1, y1, x2, y2;
+};
+
+static const Curve curves[] = {
+    {0.333f, 0.0f, 0.667f, 1.0f},  {0.42f, 0.0f, 0.58f, 1.0f},
+    {0.167f, 0.167f, 0.833f, 0.833f}, {0.25f, 0.1f, 0.25f, 1.0f},
+    {0.55f, 0.055f, 0.675f, 0.19f}, {0.215f, 0.61f, 0.355f, 1.0f},
+    {0.68f, -0.55f, 0.265f, 1.55f}, {0.9f, 0.0f, 0.1f, 1.0f},
+};
+
+template <typename Fn>
+static double measure(size_t iterations, Fn fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; i++) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    size_t samples = (argc > 1) ? size_t(atol(argv[1])) : 1000;
+    size_t iterations = (argc > 2) ? size_t(atol(argv[2])) : 200;
+
+    std::vector<std::unique_ptr<VInterpolator>> exact, table;
+    size_t                                       tables = 0;
+    for (const auto &c : curves) {
+        exact.emplace_back(new VInterpolator(c.x1, c.y1, c.x2, c.y2));
+        table.emplace_back(new VInterpolator(c.x1, c.y1, c.x2, c.y2));
+        tables += table.back()->buildTable();
+    }
+
+    // progress of a keyframe segment played frame by frame.
+    std::vector<float> progress(samples);
+    for (size_t i = 0; i < samples; i++) progress[i] = float(i) / samples;
+
+    float maxError = 0;
+    for (size_t c = 0; c < exact.size(); c++) {
+        for (auto t : progress)
+            maxError = std::max(
+                maxError, std::fabs(exact[c]->value(t) - table[c]->value(t)));
+    }
+
+    auto run = [&](const std::vector<std::unique_ptr<VInterpolator>> &list) {
+        float sum = 0;
+        double time = measure(iterations, [&] {
+            for (const auto &i : list)
+                for (auto t : progress) sum += i->value(t);
+        });
+        if (sum == -1) std::cout << sum;  // keep the loop
+        return time;
+    };
+    double exactTime = run(exact);
+    double tableTime = run(table);
+    double evals = double(samples) * exact.size() * iterations;
+
+    std::cout << exact.size() << " curves (" << tables << " with table), "
+              << samples << " samples, " << iterations << " iterations\n";
+    std::cout << "bezier : " << evals / exactTime / 1000 << " M values/s\n";
+    std::cout << "table  : " << evals / tableTime / 1000 << " M values/s ("
+              << exactTime / tableTime << "x)\n";
+    std::cout << "max error : " << maxError << "\n";
+
+    return 0;
+}
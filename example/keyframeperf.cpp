@@ -0,0 +1,127 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rlottie.h"
+
+/*
+ * Benchmark of the keyframe segment lookup. It renders a generated document
+ * whose layers animate the path, position, scale, rotation and opacity
+ * through many short keyframes, every frame in playback order and then in
+ * a scattered order that defeats the lookup cursor.
+ */
+
+static void keyframes(std::ostringstream &out, size_t count, size_t dim,
+                      float phase)
+{
+    out << "{\"a\":1,\"k\":[";
+    for (size_t k = 0; k <= count; k++) {
+        if (k) out << ",";
+        out << "{\"t\":" << k << ",\"s\":[";
+        for (size_t d = 0; d < dim; d++) {
+            if (d) out << ",";
+            out << 50 + 40 * std::sin(phase + k * 0.7f + d);
+        }
+        out << "]";
+        // the last keyframe only gives the end value of the one before.
+        if (k < count)
+            out << ",\"i\":{\"x\":[0.5],\"y\":[1]},"
+                   "\"o\":{\"x\":[0.5],\"y\":[0]}";
+        out << "}";
+    }
+    out << "]}";
+}
+
+static void pathKeyframes(std::ostringstream &out, size_t count, float phase)
+{
+    out << "{\"a\":1,\"k\":[";
+    for (size_t k = 0; k <= count; k++) {
+        if (k) out << ",";
+        out << "{\"t\":" << k << ",\"s\":[{\"c\":true,\"i\":[";
+        for (int p = 0; p < 8; p++) out << (p ? "," : "") << "[0,0]";
+        out << "],\"o\":[";
+        for (int p = 0; p < 8; p++) out << (p ? "," : "") << "[0,0]";
+        out << "],\"v\":[";
+        for (int p = 0; p < 8; p++) {
+            float a = p * 0.785f;
+            float r = 4 + std::sin(phase + k * 0.3f + p);
+            out << (p ? "," : "") << "[" << r * std::cos(a) << ","
+                << r * std::sin(a) << "]";
+        }
+        out << "]}]";
+        if (k < count)
+            out << ",\"i\":{\"x\":0.5,\"y\":1},\"o\":{\"x\":0.5,\"y\":0}";
+        out << "}";
+    }
+    out << "]}";
+}
+
+static std::string document(size_t layers, size_t count)
+{
+    std::ostringstream out;
+    out << "{\"v\":\"5.5.2\",\"fr\":60,\"ip\":0,\"op\":" << count
+        << ",\"w\":200,\"h\":200,\"layers\":[";
+    for (size_t l = 0; l < layers; l++) {
+        float phase = float(l);
+        out << (l ? "," : "") << "{\"ty\":4,\"ind\":" << l + 1
+            << ",\"ip\":0,\"op\":" << count << ",\"st\":0,\"ks\":{\"o\":";
+        keyframes(out, count, 1, phase);
+        out << ",\"r\":";
+        keyframes(out, count, 1, phase + 1);
+        out << ",\"p\":";
+        keyframes(out, count, 2, phase + 2);
+        out << ",\"a\":{\"a\":0,\"k\":[0,0]},\"s\":";
+        keyframes(out, count, 2, phase + 3);
+        out << "},\"shapes\":[{\"ty\":\"sh\",\"ks\":";
+        pathKeyframes(out, count, phase);
+        out << "},{\"ty\":\"fl\",\"c\":{\"a\":0,\"k\":[1,0,0,1]},"
+               "\"o\":{\"a\":0,\"k\":100}}]}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+static double render(rlottie::Animation &animation,
+                     const std::vector<size_t> &frames)
+{
+    std::vector<uint32_t> buffer(200 * 200);
+    rlottie::Surface      surface(buffer.data(), 200, 200, 200 * 4);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto frame : frames) animation.renderSync(frame, surface);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    size_t layers = (argc > 1) ? size_t(atol(argv[1])) : 20;
+    size_t count = (argc > 2) ? size_t(atol(argv[2])) : 3000;
+
+    auto animation = rlottie::Animation::loadFromData(
+        document(layers, count), "keyframeperf", "", false);
+    if (!animation) {
+        std::cout << "failed to load the generated document\n";
+        return 1;
+    }
+
+    std::vector<size_t> sequential(animation->totalFrame());
+    for (size_t i = 0; i < sequential.size(); i++) sequential[i] = i;
+
+    // a stride coprime with the frame count visits every frame once.
+    std::vector<size_t> scattered(sequential.size());
+    size_t              stride = 7919;
+    while (sequential.size() % stride == 0) stride++;
+    for (size_t i = 0; i < scattered.size(); i++)
+        scattered[i] = (i * stride) % scattered.size();
+
+    std::cout << layers << " layers, " << count << " keyframes a property, "
+              << sequential.size() << " frames\n";
+    std::cout << "sequential : " << render(*animation, sequential) << " ms\n";
+    std::cout << "scattered  : " << render(*animation, scattered) << " ms\n";
+
+    return 0;
+}
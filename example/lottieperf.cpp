@@ -37,9 +37,10 @@ jsonFiles(const std::string &dirName)
 class Renderer
 {
 public:
-    explicit Renderer(const std::string& filename)
+    explicit Renderer(const std::string& filename, bool bake)
     {
         _animation = rlottie::Animation::loadFromFile(filename);
+        if (bake) _baked = _animation->bakeTimeline();
         _frames = _animation->totalFrame();
         _buffer = std::make_unique<uint32_t[]>(100 * 100);
         _surface = rlottie::Surface(_buffer.get(), 100, 100, 100 * 4);
@@ -58,11 +59,13 @@ public:
     {
         if (_future.valid()) _future.get();
     }
+    size_t baked() const { return _baked; }
 private:
     std::unique_ptr<uint32_t[]>         _buffer;
     std::unique_ptr<rlottie::Animation> _animation;
     size_t                              _frames{0};
     size_t                              _cur{0};
+    size_t                              _baked{0};
     rlottie::Surface                   _surface;
     std::future<rlottie::Surface>      _future;
 };
@@ -70,14 +73,16 @@ private:
 class PerfTest
 {
 public:
-    explicit PerfTest(size_t resourceCount, size_t iterations):
-        _resourceCount(resourceCount), _iterations(iterations)
+    explicit PerfTest(size_t resourceCount, size_t iterations, bool bake):
+        _resourceCount(resourceCount), _iterations(iterations), _bake(bake)
     {
         _resourceList = jsonFiles(std::string(DEMO_DIR));
     }
     void test(bool async)
     {
+        auto setupStart = std::chrono::high_resolution_clock::now();
         setup();
+        std::chrono::duration<double, std::milli> setupTime = std::chrono::high_resolution_clock::now() - setupStart;
         std::cout<<" Test Started : .... \n";
         auto start = std::chrono::high_resolution_clock::now();
         benchmark(async);
@@ -88,6 +93,12 @@ public:
         std::cout<< " \t Resource Rendered per Frame : "<< _resourceCount <<"\n";
         std::cout<< " \t Render Buffer Size          : (100 X 100) \n";
         std::cout<< " \t Render Mode                 : "<< (async ? "Async" : "Sync")<<"\n";
+        if (_bake) {
+            size_t baked = 0;
+            for (const auto &e : _renderers) baked += e->baked();
+            std::cout<< " \t Baked Timeline Memory       : "<< baked / 1024 <<"KB\n";
+        }
+        std::cout<< " \t Load Time                   : "<< setupTime.count()<<"ms\n";
         std::cout<< " \t Total Frames Rendered       : "<< _iterations<<"\n";
         std::cout<< " \t Total Render Time           : "<< secs.count()<<"sec\n";
         std::cout<< " \t Avrage Time per Resource    : "<< millisecs.count() / (_iterations * _resourceCount)<<"ms\n";
@@ -99,7 +110,7 @@ private:
     {
         for (auto i = 0u; i < _resourceCount; i++) {
             auto index = i % _resourceList.size();
-            _renderers.push_back(std::make_unique<Renderer>(_resourceList[index]));
+            _renderers.push_back(std::make_unique<Renderer>(_resourceList[index], _bake));
         }
     }
 
@@ -118,6 +129,7 @@ private:
 private:
     size_t  _resourceCount;
     size_t  _iterations;
+    bool    _bake;
 
     std::vector<std::string>                 _resourceList;
     std::vector<std::unique_ptr<Renderer>>   _renderers;
@@ -125,7 +137,7 @@ private:
 
 static int help()
 {
-    std::cout<<"\nUsage : ./perf [--sync] [-c] [resource count] [-i] [iteration count] \n";
+    std::cout<<"\nUsage : ./perf [--sync] [--bake] [-c] [resource count] [-i] [iteration count] \n";
     std::cout<<"\nExample : ./perf -c 50 -i 100 \n";
     std::cout<<"\n\t runs perf test for 100 iterations. renders 50 resource per iteration\n\n";
     return 0;
@@ -134,6 +146,7 @@ int
 main(int argc, char ** argv)
 {
     bool async = true;
+    bool bake = false;
     size_t resourceCount = 250;
     size_t iterations = 500;
     auto index = 0;
@@ -145,6 +158,8 @@ main(int argc, char ** argv)
           return help();
       } else if (!strcmp(option,"--sync")) {
           async = false;
+      } else if (!strcmp(option,"--bake")) {
+          bake = true;
       } else if (!strcmp(option,"-c")) {
          resourceCount = (index < argc) ? atoi(argv[index]) : resourceCount;
          index++;
@@ -154,7 +169,7 @@ main(int argc, char ** argv)
       }
    }
 
-    PerfTest obj(resourceCount, iterations);
+    PerfTest obj(resourceCount, iterations, bake);
     obj.test(async);
     return 0;
 }
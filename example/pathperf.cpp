@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "vpath.h"
+
+/*
+ * Microbenchmark of the shape morphing kernels, the keyframe lerp of the
+ * bezier points into a VPath and the transform of the final path, point by
+ * point (the old code path) against the bulk kernels of VPath / VMatrix.
+ */
+
+template <typename Fn>
+static double measure(size_t iterations, Fn fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; i++) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void lerpPointwise(const std::vector<VPointF> &start,
+                          const std::vector<VPointF> &end, float t,
+                          VPath &result)
+{
+    result.reset();
+    size_t size = start.size();
+    result.reserve(size + 1, size / 3 + 2);
+    result.moveTo(start[0] + t * (end[0] - start[0]));
+    for (size_t i = 1; i < size; i += 3) {
+        result.cubicTo(start[i] + t * (end[i] - start[i]),
+                       start[i + 1] + t * (end[i + 1] - start[i + 1]),
+                       start[i + 2] + t * (end[i + 2] - start[i + 2]));
+    }
+    result.close();
+}
+
+static void mapPointwise(const VPath &path, const VMatrix &m, VPath &result)
+{
+    result.reset();
+    result.reserve(path.points().size(), path.elements().size());
+    size_t i = 0;
+    for (auto e : path.elements()) {
+        switch (e) {
+        case VPath::Element::MoveTo:
+            result.moveTo(m.map(path.points()[i++]));
+            break;
+        case VPath::Element::LineTo:
+            result.lineTo(m.map(path.points()[i++]));
+            break;
+        case VPath::Element::CubicTo: {
+            auto c1 = m.map(path.points()[i++]);
+            auto c2 = m.map(path.points()[i++]);
+            auto ep = m.map(path.points()[i++]);
+            result.cubicTo(c1, c2, ep);
+            break;
+        }
+        case VPath::Element::Close:
+            result.close();
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t cubics = (argc > 1) ? size_t(atol(argv[1])) : 64;
+    size_t iterations = (argc > 2) ? size_t(atol(argv[2])) : 100000;
+
+    // a wobbly closed shape morphing into another one.
+    std::vector<VPointF> start, end;
+    for (size_t i = 0; i < 1 + 3 * cubics; i++) {
+        float a = float(i) / (3 * cubics) * 6.2831f;
+        start.emplace_back(100 * std::cos(a), 100 * std::sin(a));
+        end.emplace_back(80 * std::cos(a) + 10 * std::sin(5 * a),
+                         80 * std::sin(a) + 10 * std::cos(3 * a));
+    }
+    VMatrix m;
+    m.translate(200, 150).rotate(33).scale(1.2f, 0.8f);
+
+    VPath  a, b;
+    size_t step = 0;
+    double lerpOld = measure(iterations, [&] {
+        lerpPointwise(start, end, float(step++ % 60) / 60, a);
+    });
+    step = 0;
+    double lerpNew = measure(iterations, [&] {
+        b.reset();
+        b.addSpline(start.data(), end.data(), start.size(),
+                    float(step++ % 60) / 60, true);
+    });
+
+    VPath  mapped;
+    double mapOld = measure(iterations, [&] { mapPointwise(a, m, mapped); });
+    double mapNew = measure(iterations, [&] {
+        mapped.reset();
+        mapped.addPath(b, m);
+    });
+
+    bool same = a.points().size() == b.points().size();
+    for (size_t i = 0; same && i < a.points().size(); i++)
+        same = a.points()[i].x() == b.points()[i].x() &&
+               a.points()[i].y() == b.points()[i].y();
+
+    double points = double(start.size()) * iterations / 1000;
+    std::cout << cubics << " cubics, " << iterations << " iterations"
+              << (same ? "" : " (results differ)") << "\n";
+    std::cout << "lerp pointwise : " << points / lerpOld << " M points/s\n";
+    std::cout << "lerp kernel    : " << points / lerpNew << " M points/s ("
+              << lerpOld / lerpNew << "x)\n";
+    std::cout << "map pointwise  : " << points / mapOld << " M points/s\n";
+    std::cout << "map kernel     : " << points / mapNew << " M points/s ("
+              << mapOld / mapNew << "x)\n";
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "vpath.h"
+#include "vraster.h"
+#include "vrle.h"
+
+/*
+ * Microbenchmark of the fill scan converters, the cells of the freetype
+ * rasterizer against the dense accumulation buffer, on shapes of growing
+ * size and complexity, and the analytic coverage Auto takes for the
+ * rectangles and small rounded corners. Prints the time of Auto and the
+ * largest coverage difference of the dense buffer and of Auto to the cells.
+ * The thin strokes compare the stroker to the hairlines of Auto.
+ */
+
+template <typename Fn>
+static double measure(size_t iterations, Fn fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; i++) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// a closed wobbly ring of cubics around cx, cy.
+static void addWobble(VPath &path, float cx, float cy, float radius,
+                      size_t cubics, float wobble)
+{
+    std::vector<VPointF> points;
+    for (size_t i = 0; i < 1 + 3 * cubics; i++) {
+        float a = float(i) / (3 * cubics) * 6.2831853f;
+        float r = radius * (1 + wobble * std::sin(7 * a));
+        points.emplace_back(cx + r * std::cos(a), cy + r * std::sin(a));
+    }
+    path.addSpline(points.data(), points.size(), true);
+}
+
+struct Coverage {
+    int                  width;
+    std::vector<uint8_t> pixels;
+};
+
+static void coverageCb(size_t count, const VRle::Span *spans, void *user)
+{
+    auto *cov = static_cast<Coverage *>(user);
+    for (size_t i = 0; i < count; i++)
+        for (int x = 0; x < spans[i].len; x++)
+            cov->pixels[spans[i].y * cov->width + spans[i].x + x] =
+                spans[i].coverage;
+}
+
+static int maxDifference(const VRle &a, const VRle &b, const VRect &clip)
+{
+    Coverage ca{clip.right(), std::vector<uint8_t>(
+                                  size_t(clip.right()) * clip.bottom())};
+    Coverage cb{clip.right(), ca.pixels};
+    a.intersect(clip, coverageCb, &ca);
+    b.intersect(clip, coverageCb, &cb);
+    int diff = 0;
+    for (size_t i = 0; i < ca.pixels.size(); i++)
+        diff = std::max(diff, std::abs(ca.pixels[i] - cb.pixels[i]));
+    return diff;
+}
+
+static void run(const char *name, const VPath &path, FillRule rule,
+                const VRect &clip, size_t iterations)
+{
+    VRasterizer raster;
+    auto        time = [&](VRasterizer::Scanner scanner) {
+        VRasterizer::setScanner(scanner);
+        return measure(iterations, [&] { raster.rasterize(path, rule, clip); });
+    };
+
+    double cell = time(VRasterizer::Scanner::Cell);
+    VRle   cellRle = raster.rle();
+    double dense = time(VRasterizer::Scanner::Dense);
+    VRle   denseRle = raster.rle();
+    double autoPick = time(VRasterizer::Scanner::Auto);
+    VRle   autoRle = raster.rle();
+
+    std::cout << name << " : cell " << cell / iterations * 1000
+              << " us, dense " << dense / iterations * 1000 << " us ("
+              << cell / dense << "x), auto " << autoPick / iterations * 1000
+              << " us, max diff " << maxDifference(cellRle, denseRle, clip)
+              << " / " << maxDifference(cellRle, autoRle, clip) << "\n";
+}
+
+static void runStroke(const char *name, const VPath &path, float width,
+                      const VRect &clip, size_t iterations)
+{
+    VRasterizer raster;
+    auto        time = [&](VRasterizer::Scanner scanner) {
+        VRasterizer::setScanner(scanner);
+        return measure(iterations, [&] {
+            raster.rasterize(path, CapStyle::Flat, JoinStyle::Miter, width, 4,
+                             clip);
+        });
+    };
+
+    double stroker = time(VRasterizer::Scanner::Cell);
+    VRle   strokerRle = raster.rle();
+    double hairline = time(VRasterizer::Scanner::Auto);
+    VRle   hairlineRle = raster.rle();
+
+    std::cout << name << " : stroker " << stroker / iterations * 1000
+              << " us, hairline " << hairline / iterations * 1000 << " us ("
+              << stroker / hairline << "x), max diff "
+              << maxDifference(strokerRle, hairlineRle, clip) << "\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t iterations = (argc > 1) ? size_t(atol(argv[1])) : 200;
+    VRect  clip(0, 0, 2048, 2048);
+
+    for (float size : {32.0f, 128.0f, 512.0f, 1024.0f}) {
+        std::cout << "size " << size << "\n";
+
+        VPath rect;
+        rect.addRect(VRectF(1.3f, 2.6f, size, size * 0.75f));
+        run("  rect          ", rect, FillRule::Winding, clip, iterations);
+
+        VPath roundRect;
+        roundRect.addRoundRect(VRectF(1.3f, 2.6f, size, size * 0.75f),
+                               size / 32);
+        run("  round rect    ", roundRect, FillRule::Winding, clip, iterations);
+
+        VPath circle;
+        circle.addCircle(size / 2 + 3.3f, size / 2 + 5.7f, size / 2);
+        run("  circle        ", circle, FillRule::Winding, clip, iterations);
+
+        VPath wobble;
+        addWobble(wobble, size / 2 + 1.5f, size / 2 + 2.5f, size / 2.5f, 64,
+                  0.2f);
+        run("  wobble 64     ", wobble, FillRule::Winding, clip, iterations);
+
+        VPath star;
+        star.addPolystar(40, size / 5, size / 2, 0, 0, 0, size / 2 + 0.5f,
+                         size / 2 + 0.5f);
+        run("  star 40       ", star, FillRule::EvenOdd, clip, iterations);
+
+        VPath blobs;
+        for (int y = 0; y < 4; y++)
+            for (int x = 0; x < 4; x++)
+                addWobble(blobs, (x + 0.5f) * size / 4, (y + 0.5f) * size / 4,
+                          size / 10, 16, 0.2f);
+        run("  blobs 16      ", blobs, FillRule::Winding, clip, iterations);
+
+        // many small contours, as a glyph run or a particle layer.
+        VPath dots;
+        for (int y = 0; y < 16; y++)
+            for (int x = 0; x < 16; x++)
+                addWobble(dots, (x + 0.5f) * size / 16, (y + 0.5f) * size / 16,
+                          size / 40, 4, 0.1f);
+        run("  dots 256      ", dots, FillRule::Winding, clip, iterations);
+
+        for (float width : {1.0f, 1.5f}) {
+            std::cout << "  stroke " << width << "\n";
+            runStroke("    wobble 64   ", wobble, width, clip, iterations);
+            runStroke("    star 40     ", star, width, clip, iterations);
+
+            // a wireframe of lines across the shape.
+            VPath grid;
+            for (int i = 0; i <= 16; i++) {
+                float v = 0.5f + i * size / 16;
+                grid.moveTo(0.5f, v);
+                grid.lineTo(size + 0.5f, v);
+                grid.moveTo(v, 0.5f);
+                grid.lineTo(v, size + 0.5f);
+            }
+            runStroke("    grid 16     ", grid, width, clip, iterations);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "vrle.h"
+
+/*
+ * Microbenchmark of the rle boolean operations of the masks and mattes, on
+ * two overlapping discs as a layer and its mask, a band of rows as a
+ * partial region, and a small mask at the bottom of a tall layer. Prints the
+ * time of each operation and the number of spans of its result.
+ */
+
+template <typename Fn>
+static double measure(size_t iterations, Fn fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; i++) fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// a disc as the rasterizer leaves it, a span of coverage on each edge.
+static VRle disc(float cx, float cy, float radius)
+{
+    VRle                    rle;
+    std::vector<VRle::Span> row;
+    for (int y = int(cy - radius); y < int(cy + radius); y++) {
+        float dy = y + 0.5f - cy;
+        float dx = std::sqrt(std::max(radius * radius - dy * dy, 0.0f));
+        int   x0 = int(std::floor(cx - dx));
+        int   x1 = int(std::floor(cx + dx));
+        if (x1 <= x0) continue;
+
+        row.clear();
+        VRle::Span span;
+        span.y = short(y);
+        span.x = short(x0);
+        span.len = 1;
+        span.coverage = uint8_t(255 * (x0 + 1 - (cx - dx)));
+        row.push_back(span);
+        if (x1 > x0 + 1) {
+            span.x = short(x0 + 1);
+            span.len = uint16_t(x1 - x0 - 1);
+            span.coverage = 255;
+            row.push_back(span);
+        }
+        span.x = short(x1);
+        span.len = 1;
+        span.coverage = uint8_t(255 * (cx + dx - x1));
+        row.push_back(span);
+        rle.addSpan(row.data(), row.size());
+    }
+    return rle;
+}
+
+static size_t spans(const VRle &rle)
+{
+    size_t count = 0;
+    rle.intersect(VRect(-32768, -32768, 65535, 65535),
+                  [](size_t n, const VRle::Span *, void *data) {
+                      *static_cast<size_t *>(data) += n;
+                  },
+                  &count);
+    return count;
+}
+
+template <typename Fn>
+static void run(const char *name, size_t iterations, Fn fn)
+{
+    VRle   result;
+    double time = measure(iterations, [&] { result = fn(); });
+    std::cout << name << " : " << time / iterations * 1000 << " us, "
+              << spans(result) << " spans\n";
+}
+
+int main(int argc, char **argv)
+{
+    size_t iterations = (argc > 1) ? size_t(atol(argv[1])) : 200;
+
+    for (float size : {256.0f, 960.0f}) {
+        std::cout << "size " << size << "\n";
+
+        VRle layer = disc(size / 2, size / 2, size / 2);
+        VRle mask = disc(size * 0.7f, size * 0.6f, size / 3);
+
+        run("  and       ", iterations, [&] { return layer & mask; });
+        run("  subtract  ", iterations, [&] { return layer - mask; });
+        run("  xor       ", iterations, [&] { return layer ^ mask; });
+        run("  add       ", iterations, [&] { return layer + mask; });
+
+        // a band of 32 rows through the middle.
+        VRect band(0, int(size / 2) - 16, int(size), 32);
+        run("  band and  ", iterations, [&] { return band & layer; });
+        run("  band clip ", iterations, [&] {
+            VRle result;
+            layer.intersect(band,
+                            [](size_t n, const VRle::Span *s, void *data) {
+                                static_cast<VRle *>(data)->addSpan(s, n);
+                            },
+                            &result);
+            return result;
+        });
+
+        // a small mask over the last rows of the layer.
+        VRle corner = disc(size / 2, size - size / 16, size / 16);
+        run("  small and ", iterations, [&] { return layer & corner; });
+        run("  small sub ", iterations, [&] { return layer - corner; });
+    }
+
+    return 0;
+}
@@ -43,6 +43,7 @@
 #endif
 
 class AnimationImpl;
+class ValueBatchImpl;
 struct LOTNode;
 struct LOTLayerNode;
 
@@ -128,6 +129,21 @@ private:
     uint32_t _frameNo;
 };
 
+/**
+ *  @brief A property value at a frame, a list of them animates a property
+ *  set with Animation::setValue(). The value is interpolated linearly
+ *  between the keyframes and held before the first and after the last one.
+ */
+template <typename T>
+struct KeyFrame {
+    KeyFrame(uint32_t frame, const T &value): _frameNo(frame), _value(value){}
+    uint32_t frame() const {return _frameNo;}
+    const T &value() const {return _value;}
+private:
+    uint32_t _frameNo;
+    T        _value;
+};
+
 enum class Property {
     FillColor,     /*!< Color property of Fill object , value type is rlottie::Color */
     FillOpacity,   /*!< Opacity property of Fill object , value type is float [ 0 .. 100] */
@@ -295,6 +311,75 @@ using LayerInfoList = std::vector<std::tuple<std::string, int , int>>;
 
 using ColorFilter = std::function<void(float &r , float &g, float &b)>;
 
+/**
+ *  @brief A list of property values for Animation::setValues().
+ *
+ *  Collects the values of a theme (or any set of overrides) so they are
+ *  set in one call, the keypaths are resolved together instead of one
+ *  walk of the content tree per keypath.
+ *
+ *  @internal
+ */
+class RLOTTIE_API ValueBatch {
+public:
+    ValueBatch();
+    ~ValueBatch();
+    ValueBatch(ValueBatch &&) noexcept;
+    ValueBatch &operator=(ValueBatch &&) noexcept;
+
+    /**
+     *  @brief Adds a property value for the specified {@link KeyPath},
+     *  takes the same keypaths and values as Animation::setValue().
+     *
+     *  @usage
+     *     rlottie::ValueBatch batch;
+     *     batch.add<rlottie::Property::FillColor>("**.fill1", rlottie::Color(1, 0, 0));
+     *     batch.add<rlottie::Property::StrokeWidth>("layer1.**", 2.0f);
+     *     player->setValues(batch);
+     *
+     *  @internal
+     */
+    template<Property prop, typename AnyValue>
+    void add(const std::string &keypath, AnyValue value)
+    {
+        add(MapType<std::integral_constant<Property, prop>>{}, prop, keypath, value);
+    }
+
+    /**
+     *  @brief Returns the number of values in the batch.
+     *
+     *  @internal
+     */
+    size_t size() const;
+
+    /**
+     *  @brief Removes all the values of the batch.
+     *
+     *  @internal
+     */
+    void clear();
+
+private:
+    friend class Animation;
+
+    void add(Color_Type, Property, const std::string &, Color);
+    void add(Float_Type, Property, const std::string &, float);
+    void add(Size_Type, Property, const std::string &, Size);
+    void add(Point_Type, Property, const std::string &, Point);
+
+    void add(Color_Type, Property, const std::string &, std::function<Color(const FrameInfo &)> &&);
+    void add(Float_Type, Property, const std::string &, std::function<float(const FrameInfo &)> &&);
+    void add(Size_Type, Property, const std::string &, std::function<Size(const FrameInfo &)> &&);
+    void add(Point_Type, Property, const std::string &, std::function<Point(const FrameInfo &)> &&);
+
+    void add(Color_Type, Property, const std::string &, const std::vector<KeyFrame<Color>> &);
+    void add(Float_Type, Property, const std::string &, const std::vector<KeyFrame<float>> &);
+    void add(Size_Type, Property, const std::string &, const std::vector<KeyFrame<Size>> &);
+    void add(Point_Type, Property, const std::string &, const std::vector<KeyFrame<Point>> &);
+
+    std::unique_ptr<ValueBatchImpl> d;
+};
+
 class RLOTTIE_API Animation {
 public:
 
@@ -315,6 +400,50 @@ public:
     static std::unique_ptr<Animation>
     loadFromFile(const std::string &path, bool cachePolicy=true);
 
+    /**
+     *  @brief Constructs an animation object from one animation of a
+     *  dotLottie (.lottie) archive.
+     *
+     *  @param[in] path dotLottie archive file path
+     *  @param[in] animationId id of the animation in the archive manifest.
+     *             empty id selects the active (or first) animation.
+     *  @param[in] cachePolicy whether to cache or not the model data and
+     *             the archive. use only when need to explicit disable caching
+     *             for a particular resource.
+     *
+     *  @return Animation object that can render the selected animation,
+     *          nullptr if the archive or the animation is not found.
+     *
+     *  @internal
+     */
+    static std::unique_ptr<Animation>
+    loadFromDotLottie(const std::string &path, const std::string &animationId,
+                      bool cachePolicy=true);
+
+    /**
+     *  @brief Constructs an animation object from file path without blocking
+     *  the caller.
+     *
+     *  The parsing, image decoding and render tree construction run on the
+     *  library worker threads, the callback receives the ready animation or
+     *  nullptr on failure. Pending loads with a higher priority are served
+     *  first (e.g. visible items), loads of the same priority in order.
+     *
+     *  @param[in] path Lottie resource file path
+     *  @param[in] callback invoked once on a worker thread with the result.
+     *  @param[in] priority load priority, higher loads first.
+     *  @param[in] cachePolicy whether to cache or not the model data.
+     *
+     *  @note Without thread support the load runs on the calling thread
+     *        and the callback is invoked before this function returns.
+     *
+     *  @internal
+     */
+    static void
+    loadFromFileAsync(const std::string &path,
+                      std::function<void(std::unique_ptr<Animation>)> callback,
+                      int priority=0, bool cachePolicy=true);
+
     /**
      *  @brief Constructs an animation object from JSON string data.
      *
@@ -504,6 +633,49 @@ public:
      */
     RenderBackend renderBackend() const;
 
+    /**
+     *  @brief Decodes the image assets ahead of their first draw.
+     *
+     *  Images are otherwise decoded lazily when an image layer is drawn
+     *  for the first time. Call this as a hint when the animation is
+     *  about to be shown to keep the decoding out of the first frame.
+     *
+     *  @internal
+     */
+    void prefetchImages();
+
+    /**
+     *  @brief Releases the decoded image assets, e.g. under memory pressure.
+     *
+     *  The compressed image data is kept, the images are decoded again
+     *  the next time they are drawn. Animations loaded from the same cached
+     *  file share the decoded images, an image is freed once none of them
+     *  uses it.
+     *
+     *  @internal
+     */
+    void releaseImages();
+
+    /**
+     *  @brief Evaluates the animated properties of every frame ahead.
+     *
+     *  The keyframe values, shape points and transform matrices of every
+     *  integer frame are stored so rendering a frame reads them instead of
+     *  interpolating the keyframes. Worth it for short animations played
+     *  many times, the memory grows with the number of animated properties
+     *  times the number of frames.
+     *
+     *  The baked values belong to this Animation object, the others using
+     *  the same cached model keep evaluating the keyframes or their own
+     *  baked values. Don't call this while the object is rendering. A trim
+     *  end set with setValue() drops the baked values of that trim.
+     *
+     *  @return the memory used by the baked values in bytes.
+     *
+     *  @internal
+     */
+    size_t bakeTimeline();
+
     /**
      *  @brief Sets property value for the specified {@link KeyPath}. This {@link KeyPath} can resolve
      *  to multiple contents. In that case, the callback's value will apply to all of them.
@@ -519,6 +691,14 @@ public:
      *
      *     player->setValue<rlottie::Property::FillColor>("**.group1.**", rlottie::Color(0, 1, 0);
      *
+     *  to fade the stroke of stroke1 out between the frames 10 and 20
+     *
+     *     player->setValue<rlottie::Property::StrokeOpacity>("**.stroke1",
+     *         std::vector<rlottie::KeyFrame<float>>{{10, 100.0f}, {20, 0.0f}});
+     *
+     *  Plain values and keyframes are stored as they are, a callback is
+     *  called for every frame the property is needed.
+     *
      *  @internal
      */
     template<Property prop, typename AnyValue>
@@ -527,6 +707,17 @@ public:
         setValue(MapType<std::integral_constant<Property, prop>>{}, prop, keypath, value);
     }
 
+    /**
+     *  @brief Sets all the property values of the batch, same as calling
+     *  setValue() for each of them in order but the keypaths are resolved
+     *  in a single pass.
+     *
+     *  @param[in] batch the values to set, the batch can be reused.
+     *
+     *  @internal
+     */
+    void setValues(const ValueBatch &batch);
+
     /**
      *  @brief default destructor
      *
@@ -544,6 +735,12 @@ private:
     void setValue(Float_Type, Property, const std::string &, std::function<float(const FrameInfo &)> &&);
     void setValue(Size_Type, Property, const std::string &, std::function<Size(const FrameInfo &)> &&);
     void setValue(Point_Type, Property, const std::string &, std::function<Point(const FrameInfo &)> &&);
+
+    void setValue(Color_Type, Property, const std::string &, const std::vector<KeyFrame<Color>> &);
+    void setValue(Float_Type, Property, const std::string &, const std::vector<KeyFrame<float>> &);
+    void setValue(Size_Type, Property, const std::string &, const std::vector<KeyFrame<Size>> &);
+    void setValue(Point_Type, Property, const std::string &, const std::vector<KeyFrame<Point>> &);
+
     /**
      *  @brief default constructor
      *
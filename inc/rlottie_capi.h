@@ -48,6 +48,12 @@ typedef enum {
 
 typedef struct Lottie_Animation_S Lottie_Animation;
 
+/**
+ *  @brief Callback of lottie_animation_from_file_async(), receives the
+ *  loaded animation (NULL on failure) and the user data.
+ */
+typedef void (*Lottie_Animation_Load_Cb)(Lottie_Animation *animation, void *data);
+
 /**
  *  @brief Runs lottie initialization code when rlottie library is loaded
  * dynamically.
@@ -93,6 +99,40 @@ RLOTTIE_API void lottie_shutdown(void);
  */
 RLOTTIE_API Lottie_Animation *lottie_animation_from_file(const char *path);
 
+/**
+ *  @brief Constructs an animation object from one animation of a dotLottie archive.
+ *
+ *  @param[in] path dotLottie (.lottie) archive file path
+ *  @param[in] animation_id id of the animation in the archive manifest,
+ *             NULL selects the active (or first) animation.
+ *
+ *  @return Animation object that can build the contents of the
+ *          selected animation.
+ *
+ *  @see lottie_animation_destroy()
+ *
+ *  @ingroup Lottie_Animation
+ *  @internal
+ */
+RLOTTIE_API Lottie_Animation *lottie_animation_from_dotlottie(const char *path, const char *animation_id);
+
+/**
+ *  @brief Constructs an animation object from file path without blocking the caller.
+ *
+ *  @param[in] path Lottie resource file path
+ *  @param[in] priority load priority, pending loads with higher priority are served first.
+ *  @param[in] callback invoked once on a worker thread with the loaded animation,
+ *             the animation is owned by the callee and must be released with
+ *             lottie_animation_destroy().
+ *  @param[in] data user data passed to the callback.
+ *
+ *  @see lottie_animation_destroy()
+ *
+ *  @ingroup Lottie_Animation
+ *  @internal
+ */
+RLOTTIE_API void lottie_animation_from_file_async(const char *path, int priority, Lottie_Animation_Load_Cb callback, void *data);
+
 /**
  *  @brief Constructs an animation object from JSON string data.
  *
@@ -306,6 +346,42 @@ RLOTTIE_API void lottie_animation_property_override(Lottie_Animation *animation,
  * */
 RLOTTIE_API const LOTMarkerList* lottie_animation_get_markerlist(Lottie_Animation *animation);
 
+/**
+ *  @brief Decodes the image assets of the animation ahead of their first draw.
+ *
+ *  @param[in] animation Animation object.
+ *
+ *  @ingroup Lottie_Animation
+ *  @internal
+ * */
+RLOTTIE_API void lottie_animation_prefetch_images(Lottie_Animation *animation);
+
+/**
+ *  @brief Releases the decoded image assets of the animation, they are
+ *  decoded again when drawn.
+ *
+ *  @param[in] animation Animation object.
+ *
+ *  @ingroup Lottie_Animation
+ *  @internal
+ * */
+RLOTTIE_API void lottie_animation_release_images(Lottie_Animation *animation);
+
+/**
+ *  @brief Evaluates the animated properties of every frame ahead so the
+ *  rendering doesn't interpolate the keyframes.
+ *
+ *  @param[in] animation Animation object.
+ *
+ *  @return the memory used by the baked values in bytes.
+ *
+ *  @see rlottie::Animation::bakeTimeline()
+ *
+ *  @ingroup Lottie_Animation
+ *  @internal
+ * */
+RLOTTIE_API size_t lottie_animation_bake_timeline(Lottie_Animation *animation);
+
 /**
  *  @brief Configures rlottie model cache policy.
  *
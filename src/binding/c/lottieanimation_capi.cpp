@@ -80,6 +80,31 @@ RLOTTIE_API Lottie_Animation_S *lottie_animation_from_file(const char *path)
     }
 }
 
+RLOTTIE_API Lottie_Animation_S *lottie_animation_from_dotlottie(const char *path, const char *animation_id)
+{
+    if (auto animation = Animation::loadFromDotLottie(path, animation_id ? animation_id : "") ) {
+        Lottie_Animation_S *handle = new Lottie_Animation_S();
+        handle->mAnimation = std::move(animation);
+        return handle;
+    } else {
+        return nullptr;
+    }
+}
+
+RLOTTIE_API void lottie_animation_from_file_async(const char *path, int priority, Lottie_Animation_Load_Cb callback, void *data)
+{
+    if (!path || !callback) return;
+
+    Animation::loadFromFileAsync(path, [callback, data](std::unique_ptr<Animation> animation) {
+        Lottie_Animation_S *handle = nullptr;
+        if (animation) {
+            handle = new Lottie_Animation_S();
+            handle->mAnimation = std::move(animation);
+        }
+        callback(handle, data);
+    }, priority);
+}
+
 RLOTTIE_API Lottie_Animation_S *lottie_animation_from_data(const char *data, const char *key, const char *resourcePath)
 {
     if (auto animation = Animation::loadFromData(data, key, resourcePath) ) {
@@ -321,6 +346,27 @@ lottie_animation_get_markerlist(Lottie_Animation_S *animation)
    return (const LOTMarkerList*)animation->mMarkerList;
 }
 
+RLOTTIE_API void lottie_animation_prefetch_images(Lottie_Animation_S *animation)
+{
+    if (!animation) return;
+
+    animation->mAnimation->prefetchImages();
+}
+
+RLOTTIE_API void lottie_animation_release_images(Lottie_Animation_S *animation)
+{
+    if (!animation) return;
+
+    animation->mAnimation->releaseImages();
+}
+
+RLOTTIE_API size_t lottie_animation_bake_timeline(Lottie_Animation_S *animation)
+{
+    if (!animation) return 0;
+
+    return animation->mAnimation->bakeTimeline();
+}
+
 RLOTTIE_API void
 lottie_configure_model_cache_size(size_t cacheSize)
 {
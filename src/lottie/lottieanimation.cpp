@@ -23,8 +23,14 @@
 #include "lottieitem.h"
 #include "lottiemodel.h"
 #include "rlottie.h"
+#include "vtaskscheduler.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <queue>
+#include <thread>
 
 using namespace rlottie;
 using namespace rlottie::internal;
@@ -42,6 +48,18 @@ RLOTTIE_API void rlottie::configureModelCacheSize(size_t cacheSize)
     internal::model::configureModelCacheSize(cacheSize);
 }
 
+class ValueBatchImpl {
+public:
+    template <typename T>
+    void add(Property prop, const std::string &keypath, LOTValue<T> &&value)
+    {
+        if (keypath.empty()) return;
+        mValues.emplace_back(keypath, LOTVariant(prop, std::move(value)));
+    }
+
+    std::vector<renderer::KeyValue> mValues;
+};
+
 struct RenderTask {
     RenderTask() { receiver = sender.get_future(); }
     std::promise<Surface> sender;
@@ -77,6 +95,7 @@ public:
     }
     const MarkerList &markers() const { return mModel->markers(); }
     void              setValue(const std::string &keypath, LOTVariant &&value);
+    void              setValues(const ValueBatchImpl &batch);
     void              removeFilter(const std::string &keypath, Property prop);
     
     // 设置渲染后端
@@ -91,6 +110,10 @@ public:
         return static_cast<RenderBackend>(mRenderer->renderBackend());
     }
 
+    void prefetchImages() { mRenderer->prefetchImages(); }
+    void releaseImages() { mRenderer->releaseImages(); }
+    size_t bakeTimeline() { return mRenderer->bakeTimeline(); }
+
 private:
     mutable LayerInfoList                  mLayerList;
     model::Composition *                   mModel;
@@ -104,6 +127,11 @@ void AnimationImpl::setValue(const std::string &keypath, LOTVariant &&value)
     mRenderer->setValue(keypath, value);
 }
 
+void AnimationImpl::setValues(const ValueBatchImpl &batch)
+{
+    mRenderer->setValues(batch.mValues);
+}
+
 const LOTLayerNode *AnimationImpl::renderTree(size_t frameNo, const VSize &size)
 {
     if (update(frameNo, size, true)) {
@@ -170,6 +198,120 @@ public:
 
 bool RenderTaskScheduler::IsRunning{false};
 
+#ifdef LOTTIE_THREAD_SUPPORT
+
+/*
+ * Runs the asynchronous loads on a dedicated thread, highest priority
+ * first and in submission order for the same priority. The loads
+ * themselves spread the parsing and image decoding over VTaskScheduler.
+ */
+class LoadTaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    static LoadTaskScheduler &instance()
+    {
+        static LoadTaskScheduler singleton;
+        return singleton;
+    }
+
+    // stops the loader thread if a load started it.
+    static void shutdown()
+    {
+        if (sStarted.load()) instance().stop();
+    }
+
+    void process(Task task, int priority)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mRunning) {
+                mQueue.push({priority, mOrder++, std::move(task)});
+                mReady.notify_one();
+                return;
+            }
+        }
+        task();
+    }
+
+    // finishes the pending loads, later loads run on the caller thread.
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mRunning) return;
+            mRunning = false;
+            mReady.notify_one();
+        }
+        mThread.join();
+    }
+
+    ~LoadTaskScheduler() { stop(); }
+
+private:
+    struct Entry {
+        int    priority;
+        size_t order;
+        Task   task;
+        bool   operator<(const Entry &other) const
+        {
+            return (priority == other.priority) ? order > other.order
+                                                : priority < other.priority;
+        }
+    };
+
+    /*
+     * the pending loads finish when the loader is destroyed at exit, the
+     * model cache they use is created first so it is destroyed after.
+     */
+    LoadTaskScheduler()
+    {
+        model::initModelCache();
+        mThread = std::thread([this] { run(); });
+        sStarted.store(true);
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true) {
+            mReady.wait(lock, [this] { return !mQueue.empty() || !mRunning; });
+            if (mQueue.empty()) break;
+            // priority_queue::top() is const, the entry is popped right away.
+            auto task = std::move(const_cast<Entry &>(mQueue.top()).task);
+            mQueue.pop();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex                  mMutex;
+    std::condition_variable     mReady;
+    std::priority_queue<Entry>  mQueue;
+    size_t                      mOrder{0};
+    bool                        mRunning{true};
+    std::thread                 mThread;
+    static std::atomic<bool>    sStarted;
+};
+
+std::atomic<bool> LoadTaskScheduler::sStarted{false};
+
+#else
+
+class LoadTaskScheduler {
+public:
+    static LoadTaskScheduler &instance()
+    {
+        static LoadTaskScheduler singleton;
+        return singleton;
+    }
+    static void shutdown() {}
+    void process(std::function<void()> task, int) { task(); }
+};
+
+#endif
+
 std::future<Surface> AnimationImpl::renderAsync(size_t    frameNo,
                                                 Surface &&surface,
                                                 bool      keepAspectRatio)
@@ -249,6 +391,40 @@ std::unique_ptr<Animation> Animation::loadFromFile(const std::string &path,
     return nullptr;
 }
 
+std::unique_ptr<Animation> Animation::loadFromDotLottie(
+    const std::string &path, const std::string &animationId, bool cachePolicy)
+{
+    if (path.empty()) {
+        vWarning << "File path is empty";
+        return nullptr;
+    }
+
+    auto composition = model::loadFromFile(path, animationId, cachePolicy);
+    if (composition) {
+        auto animation = std::unique_ptr<Animation>(new Animation);
+        animation->d->init(std::move(composition));
+        return animation;
+    }
+    return nullptr;
+}
+
+void Animation::loadFromFileAsync(
+    const std::string &path,
+    std::function<void(std::unique_ptr<Animation>)> callback, int priority,
+    bool cachePolicy)
+{
+    if (!callback) return;
+
+    LoadTaskScheduler::instance().process(
+        [path, callback, cachePolicy]() {
+            auto animation = loadFromFile(path, cachePolicy);
+            // deliver the animation with its images already decoded.
+            if (animation) animation->prefetchImages();
+            callback(std::move(animation));
+        },
+        priority);
+}
+
 void Animation::size(size_t &width, size_t &height) const
 {
     VSize sz = d->size();
@@ -308,53 +484,180 @@ const MarkerList &Animation::markers() const
 void Animation::setValue(Color_Type, Property prop, const std::string &keypath,
                          Color value)
 {
-    d->setValue(keypath,
-                LOTVariant(prop, [value](const FrameInfo &) { return value; }));
+    d->setValue(keypath, LOTVariant(prop, LOTVariant::ColorValue(value)));
 }
 
 void Animation::setValue(Float_Type, Property prop, const std::string &keypath,
                          float value)
 {
-    d->setValue(keypath,
-                LOTVariant(prop, [value](const FrameInfo &) { return value; }));
+    d->setValue(keypath, LOTVariant(prop, LOTVariant::FloatValue(value)));
 }
 
 void Animation::setValue(Size_Type, Property prop, const std::string &keypath,
                          Size value)
 {
-    d->setValue(keypath,
-                LOTVariant(prop, [value](const FrameInfo &) { return value; }));
+    d->setValue(keypath, LOTVariant(prop, LOTVariant::SizeValue(value)));
 }
 
 void Animation::setValue(Point_Type, Property prop, const std::string &keypath,
                          Point value)
 {
-    d->setValue(keypath,
-                LOTVariant(prop, [value](const FrameInfo &) { return value; }));
+    d->setValue(keypath, LOTVariant(prop, LOTVariant::PointValue(value)));
 }
 
 void Animation::setValue(Color_Type, Property prop, const std::string &keypath,
                          std::function<Color(const FrameInfo &)> &&value)
 {
-    d->setValue(keypath, LOTVariant(prop, value));
+    d->setValue(keypath,
+                LOTVariant(prop, LOTVariant::ColorValue(std::move(value))));
 }
 
 void Animation::setValue(Float_Type, Property prop, const std::string &keypath,
                          std::function<float(const FrameInfo &)> &&value)
 {
-    d->setValue(keypath, LOTVariant(prop, value));
+    d->setValue(keypath,
+                LOTVariant(prop, LOTVariant::FloatValue(std::move(value))));
 }
 
 void Animation::setValue(Size_Type, Property prop, const std::string &keypath,
                          std::function<Size(const FrameInfo &)> &&value)
 {
-    d->setValue(keypath, LOTVariant(prop, value));
+    d->setValue(keypath,
+                LOTVariant(prop, LOTVariant::SizeValue(std::move(value))));
 }
 
 void Animation::setValue(Point_Type, Property prop, const std::string &keypath,
                          std::function<Point(const FrameInfo &)> &&value)
 {
-    d->setValue(keypath, LOTVariant(prop, value));
+    d->setValue(keypath,
+                LOTVariant(prop, LOTVariant::PointValue(std::move(value))));
+}
+
+void Animation::setValue(Color_Type, Property prop, const std::string &keypath,
+                         const std::vector<KeyFrame<Color>> &value)
+{
+    if (value.empty()) return;
+    d->setValue(keypath, LOTVariant(prop, LOTVariant::ColorValue(value)));
+}
+
+void Animation::setValue(Float_Type, Property prop, const std::string &keypath,
+                         const std::vector<KeyFrame<float>> &value)
+{
+    if (value.empty()) return;
+    d->setValue(keypath, LOTVariant(prop, LOTVariant::FloatValue(value)));
+}
+
+void Animation::setValue(Size_Type, Property prop, const std::string &keypath,
+                         const std::vector<KeyFrame<Size>> &value)
+{
+    if (value.empty()) return;
+    d->setValue(keypath, LOTVariant(prop, LOTVariant::SizeValue(value)));
+}
+
+void Animation::setValue(Point_Type, Property prop, const std::string &keypath,
+                         const std::vector<KeyFrame<Point>> &value)
+{
+    if (value.empty()) return;
+    d->setValue(keypath, LOTVariant(prop, LOTVariant::PointValue(value)));
+}
+
+void Animation::setValues(const ValueBatch &batch)
+{
+    d->setValues(*batch.d);
+}
+
+ValueBatch::ValueBatch() : d(std::make_unique<ValueBatchImpl>()) {}
+
+ValueBatch::~ValueBatch() = default;
+
+ValueBatch::ValueBatch(ValueBatch &&) noexcept = default;
+
+ValueBatch &ValueBatch::operator=(ValueBatch &&) noexcept = default;
+
+size_t ValueBatch::size() const
+{
+    return d->mValues.size();
+}
+
+void ValueBatch::clear()
+{
+    d->mValues.clear();
+}
+
+void ValueBatch::add(Color_Type, Property prop, const std::string &keypath,
+                     Color value)
+{
+    d->add(prop, keypath, LOTVariant::ColorValue(value));
+}
+
+void ValueBatch::add(Float_Type, Property prop, const std::string &keypath,
+                     float value)
+{
+    d->add(prop, keypath, LOTVariant::FloatValue(value));
+}
+
+void ValueBatch::add(Size_Type, Property prop, const std::string &keypath,
+                     Size value)
+{
+    d->add(prop, keypath, LOTVariant::SizeValue(value));
+}
+
+void ValueBatch::add(Point_Type, Property prop, const std::string &keypath,
+                     Point value)
+{
+    d->add(prop, keypath, LOTVariant::PointValue(value));
+}
+
+void ValueBatch::add(Color_Type, Property prop, const std::string &keypath,
+                     std::function<Color(const FrameInfo &)> &&value)
+{
+    d->add(prop, keypath, LOTVariant::ColorValue(std::move(value)));
+}
+
+void ValueBatch::add(Float_Type, Property prop, const std::string &keypath,
+                     std::function<float(const FrameInfo &)> &&value)
+{
+    d->add(prop, keypath, LOTVariant::FloatValue(std::move(value)));
+}
+
+void ValueBatch::add(Size_Type, Property prop, const std::string &keypath,
+                     std::function<Size(const FrameInfo &)> &&value)
+{
+    d->add(prop, keypath, LOTVariant::SizeValue(std::move(value)));
+}
+
+void ValueBatch::add(Point_Type, Property prop, const std::string &keypath,
+                     std::function<Point(const FrameInfo &)> &&value)
+{
+    d->add(prop, keypath, LOTVariant::PointValue(std::move(value)));
+}
+
+void ValueBatch::add(Color_Type, Property prop, const std::string &keypath,
+                     const std::vector<KeyFrame<Color>> &value)
+{
+    if (value.empty()) return;
+    d->add(prop, keypath, LOTVariant::ColorValue(value));
+}
+
+void ValueBatch::add(Float_Type, Property prop, const std::string &keypath,
+                     const std::vector<KeyFrame<float>> &value)
+{
+    if (value.empty()) return;
+    d->add(prop, keypath, LOTVariant::FloatValue(value));
+}
+
+void ValueBatch::add(Size_Type, Property prop, const std::string &keypath,
+                     const std::vector<KeyFrame<Size>> &value)
+{
+    if (value.empty()) return;
+    d->add(prop, keypath, LOTVariant::SizeValue(value));
+}
+
+void ValueBatch::add(Point_Type, Property prop, const std::string &keypath,
+                     const std::vector<KeyFrame<Point>> &value)
+{
+    if (value.empty()) return;
+    d->add(prop, keypath, LOTVariant::PointValue(value));
 }
 
 Animation::~Animation() = default;
@@ -392,6 +695,8 @@ extern void lottieShutdownRasterTaskScheduler();
 void lottie_shutdown_impl()
 {
     lottieShutdownRasterTaskScheduler();
+    LoadTaskScheduler::shutdown();
+    VTaskScheduler::instance().stop();
 }
 
 #ifdef LOTTIE_LOGGING_SUPPORT
@@ -417,3 +722,18 @@ RenderBackend Animation::renderBackend() const
 {
     return d->renderBackend();
 }
+
+void Animation::prefetchImages()
+{
+    d->prefetchImages();
+}
+
+void Animation::releaseImages()
+{
+    d->releaseImages();
+}
+
+size_t Animation::bakeTimeline()
+{
+    return d->bakeTimeline();
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "lottiedotlottie.h"
+#include <cstring>
+#include "lottiemodel.h"
+#include "rapidjson/document.h"
+#include "zip/zip.h"
+
+using namespace rlottie::internal;
+
+static const char *animationDir = "animations/";
+static const char *manifestEntry = "manifest.json";
+
+bool model::DotLottie::isDotLottie(const char *data, size_t length)
+{
+    // zip local file header signature "PK\3\4"
+    return length >= 4 && data[0] == 0x50 && data[1] == 0x4B &&
+           data[2] == 0x03 && data[3] == 0x04;
+}
+
+std::shared_ptr<model::DotLottie> model::DotLottie::open(std::string data)
+{
+    auto archive = std::shared_ptr<DotLottie>(new DotLottie);
+    archive->mData = std::move(data);
+    if (!archive->init(archive->mData.data(), archive->mData.size())) return {};
+    return archive;
+}
+
+std::shared_ptr<model::DotLottie> model::DotLottie::open(const char *data,
+                                                         size_t      length)
+{
+    auto archive = std::shared_ptr<DotLottie>(new DotLottie);
+    if (!archive->init(data, length)) return {};
+    return archive;
+}
+
+model::DotLottie::~DotLottie()
+{
+    if (mZip) zip_stream_close(mZip);
+}
+
+bool model::DotLottie::init(const char *data, size_t length)
+{
+    mZip = zip_stream_open(data, length, 0, 'r');
+    if (!mZip) {
+        vCritical << "Failed to unzip dotLottie!";
+        return false;
+    }
+    parseManifest();
+    if (mAnimations.empty()) {
+        vCritical << "dotLottie has no animation!";
+        return false;
+    }
+    return true;
+}
+
+/*
+ * manifest.json lists the animations as {"animations":[{"id":"..."}]},
+ * stored as animations/<id>.json. The active one is either given by
+ * "activeAnimationId" (v1) or "initial":{"animation":"..."} (v2), otherwise
+ * the first one. Archives without a manifest fall back to every json entry.
+ */
+void model::DotLottie::parseManifest()
+{
+    size_t length = 0;
+    auto   manifest = inflate(manifestEntry, length);
+    if (manifest) {
+        rapidjson::Document doc;
+        doc.ParseInsitu(manifest.get());
+        if (!doc.HasParseError() && doc.IsObject()) {
+            auto animations = doc.FindMember("animations");
+            if (animations != doc.MemberEnd() && animations->value.IsArray()) {
+                for (const auto &animation : animations->value.GetArray()) {
+                    if (!animation.IsObject()) continue;
+                    auto id = animation.FindMember("id");
+                    if (id == animation.MemberEnd() || !id->value.IsString())
+                        continue;
+                    std::string name = id->value.GetString();
+                    mAnimations.emplace_back(name,
+                                             animationDir + name + ".json");
+                }
+            }
+            auto active = doc.FindMember("activeAnimationId");
+            if (active != doc.MemberEnd() && active->value.IsString()) {
+                mActiveId = active->value.GetString();
+            }
+            auto initial = doc.FindMember("initial");
+            if (initial != doc.MemberEnd() && initial->value.IsObject()) {
+                auto animation = initial->value.FindMember("animation");
+                if (animation != initial->value.MemberEnd() &&
+                    animation->value.IsString()) {
+                    mActiveId = animation->value.GetString();
+                }
+            }
+        }
+    }
+
+    if (!mAnimations.empty()) return;
+
+    auto total = zip_entries_total(mZip);
+    for (ssize_t i = 0; i < total; i++) {
+        if (zip_entry_openbyindex(mZip, size_t(i))) continue;
+        std::string name = zip_entry_name(mZip);
+        zip_entry_close(mZip);
+        auto len = name.size();
+        if (len < 5 || name.compare(len - 5, 5, ".json") || name == manifestEntry)
+            continue;
+        auto start = name.rfind('/');
+        start = (start == std::string::npos) ? 0 : start + 1;
+        mAnimations.emplace_back(name.substr(start, len - 5 - start), name);
+    }
+}
+
+std::string model::DotLottie::animationEntry(const std::string &id) const
+{
+    const auto &key = id.empty() ? mActiveId : id;
+    for (const auto &animation : mAnimations) {
+        if (animation.first == key) return animation.second;
+    }
+    // no (valid) active animation, pick the first one.
+    if (id.empty() && !mAnimations.empty()) return mAnimations.front().second;
+    return {};
+}
+
+std::unique_ptr<char[]> model::DotLottie::inflate(const std::string &name,
+                                                  size_t &           length)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (zip_entry_open(mZip, name.c_str())) return {};
+
+    auto size = size_t(zip_entry_size(mZip));
+    std::unique_ptr<char[]> buffer(new char[size + 1]);
+    auto read = zip_entry_noallocread(mZip, buffer.get(), size);
+    zip_entry_close(mZip);
+
+    if (read < 0 || size_t(read) != size) return {};
+
+    buffer[size] = '\0';
+    length = size;
+    return buffer;
+}
+
+std::shared_ptr<const std::string> model::DotLottie::entry(
+    const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto search = mEntries.find(name);
+    if (search != mEntries.end()) return search->second;
+
+    if (zip_entry_open(mZip, name.c_str())) return {};
+
+    auto data = std::make_shared<std::string>(size_t(zip_entry_size(mZip)), '\0');
+    auto read = zip_entry_noallocread(mZip, &(*data)[0], data->size());
+    zip_entry_close(mZip);
+
+    if (read < 0 || size_t(read) != data->size()) return {};
+
+    mEntries[name] = data;
+    return data;
+}
+
+std::shared_ptr<model::Composition> model::parseDotLottie(
+    DotLottie &archive, const std::string &animationId, std::string dir_path,
+    ColorFilter filter)
+{
+    auto name = archive.animationEntry(animationId);
+    if (name.empty()) {
+        vWarning << "dotLottie animation not found : " << animationId.c_str();
+        return {};
+    }
+
+    // the buffer is parsed insitu and must outlive the parser.
+    size_t length = 0;
+    auto   json = archive.inflate(name, length);
+    if (!json) {
+        vCritical << "Failed to unzip dotLottie entry : " << name.c_str();
+        return {};
+    }
+
+    return parse(json.get(), length, std::move(dir_path), std::move(filter),
+                 &archive);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LOTTIEDOTLOTTIE_H
+#define LOTTIEDOTLOTTIE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "vglobal.h"
+
+struct zip_t;
+
+namespace rlottie {
+
+namespace internal {
+
+namespace model {
+
+/*
+ * In-memory view of a dotLottie (.lottie) archive.
+ * The archive keeps the raw zip bytes and inflates entries on demand.
+ * Inflated resource entries (images) are kept in the archive so that every
+ * animation loaded from the same archive shares them.
+ */
+class DotLottie {
+public:
+    static bool isDotLottie(const char *data, size_t length);
+
+    // takes ownership of the archive bytes.
+    static std::shared_ptr<DotLottie> open(std::string data);
+    // borrows the archive bytes, caller must keep them alive.
+    static std::shared_ptr<DotLottie> open(const char *data, size_t length);
+
+    ~DotLottie();
+
+    // archive entry of the animation, the active one when id is empty.
+    std::string animationEntry(const std::string &id) const;
+    // inflates an entry into a new nul terminated buffer owned by the caller,
+    // suitable for insitu parsing.
+    std::unique_ptr<char[]> inflate(const std::string &name, size_t &length);
+    // inflated entry shared by all users of the archive.
+    std::shared_ptr<const std::string> entry(const std::string &name);
+
+private:
+    DotLottie() = default;
+    bool init(const char *data, size_t length);
+    void parseManifest();
+
+    std::string                                                         mData;
+    zip_t *                                                             mZip{nullptr};
+    std::vector<std::pair<std::string, std::string>>                    mAnimations;
+    std::string                                                         mActiveId;
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> mEntries;
+    std::mutex                                                          mMutex;
+};
+
+}  // namespace model
+
+}  // namespace internal
+
+}  // namespace rlottie
+
+#endif  // LOTTIEDOTLOTTIE_H
@@ -30,89 +30,243 @@
 #include "rlottie.h"
 
 using namespace rlottie::internal;
-// Naive way to implement std::variant
-// refactor it when we move to c++17
-// users should make sure proper combination
-// of id and value are passed while creating the object.
-class LOTVariant {
+/*
+ * A property value set by the user. Plain values and keyframes are kept as
+ * they are and evaluated in place, only a callback goes through the
+ * std::function. Only the kind set is stored, in a union like LOTVariant.
+ */
+template <typename T>
+class LOTValue {
 public:
-    using ValueFunc = std::function<float(const rlottie::FrameInfo&)>;
-    using ColorFunc = std::function<rlottie::Color(const rlottie::FrameInfo&)>;
-    using PointFunc = std::function<rlottie::Point(const rlottie::FrameInfo&)>;
-    using SizeFunc = std::function<rlottie::Size(const rlottie::FrameInfo&)>;
+    using Func = std::function<T(const rlottie::FrameInfo&)>;
+    using KeyFrames = std::vector<rlottie::KeyFrame<T>>;
 
-    LOTVariant(rlottie::Property prop, const ValueFunc& v)
-        : mPropery(prop), mTag(Value)
+    explicit LOTValue(const T& value) : mKind(Constant)
     {
-        construct(impl.valueFunc, v);
+        new (&impl.value) T(value);
     }
 
-    LOTVariant(rlottie::Property prop, ValueFunc&& v)
-        : mPropery(prop), mTag(Value)
+    explicit LOTValue(Func&& func) : mKind(Callback)
     {
-        moveConstruct(impl.valueFunc, std::move(v));
+        new (&impl.func) Func(std::move(func));
     }
 
-    LOTVariant(rlottie::Property prop, const ColorFunc& v)
-        : mPropery(prop), mTag(Color)
+    explicit LOTValue(const KeyFrames& frames) : mKind(Animated)
     {
-        construct(impl.colorFunc, v);
+        new (&impl.frames) KeyFrames(frames);
+        std::stable_sort(impl.frames.begin(), impl.frames.end(),
+                         [](const rlottie::KeyFrame<T>& a,
+                            const rlottie::KeyFrame<T>& b) {
+                             return a.frame() < b.frame();
+                         });
     }
 
-    LOTVariant(rlottie::Property prop, ColorFunc&& v)
-        : mPropery(prop), mTag(Color)
+    ~LOTValue() noexcept { Destroy(); }
+    LOTValue(const LOTValue& other) { Copy(other); }
+    LOTValue(LOTValue&& other) noexcept { Move(std::move(other)); }
+    LOTValue& operator=(const LOTValue& other)
     {
-        moveConstruct(impl.colorFunc, std::move(v));
+        if (this != &other) {
+            Destroy();
+            Copy(other);
+        }
+        return *this;
+    }
+    LOTValue& operator=(LOTValue&& other) noexcept
+    {
+        if (this != &other) {
+            Destroy();
+            Move(std::move(other));
+        }
+        return *this;
     }
 
-    LOTVariant(rlottie::Property prop, const PointFunc& v)
-        : mPropery(prop), mTag(Point)
+    bool constant() const { return mKind == Constant; }
+
+    T value(int frameNo) const
     {
-        construct(impl.pointFunc, v);
+        switch (mKind) {
+        case Constant:
+            return impl.value;
+        case Animated:
+            return keyFrameValue(frameNo);
+        case Callback:
+            return impl.func(rlottie::FrameInfo(uint32_t(frameNo)));
+        }
+        return T{};
     }
 
-    LOTVariant(rlottie::Property prop, PointFunc&& v)
-        : mPropery(prop), mTag(Point)
+private:
+    T keyFrameValue(int frameNo) const
     {
-        moveConstruct(impl.pointFunc, std::move(v));
+        const auto& frames = impl.frames;
+        if (frames.empty()) return T{};
+
+        float frame = float(frameNo);
+        if (frame <= frames.front().frame()) return frames.front().value();
+        if (frame >= frames.back().frame()) return frames.back().value();
+
+        auto next = std::upper_bound(frames.begin(), frames.end(), frame,
+                                     [](float f, const rlottie::KeyFrame<T>& k) {
+                                         return f < k.frame();
+                                     });
+        auto  prev = next - 1;
+        float t = (frame - prev->frame()) / float(next->frame() - prev->frame());
+        return lerp(prev->value(), next->value(), t);
     }
 
-    LOTVariant(rlottie::Property prop, const SizeFunc& v)
-        : mPropery(prop), mTag(Size)
+    static float lerp(float a, float b, float t) { return a + t * (b - a); }
+    static rlottie::Color lerp(const rlottie::Color& a, const rlottie::Color& b,
+                               float t)
+    {
+        return rlottie::Color(lerp(a.r(), b.r(), t), lerp(a.g(), b.g(), t),
+                              lerp(a.b(), b.b(), t));
+    }
+    static rlottie::Point lerp(const rlottie::Point& a, const rlottie::Point& b,
+                               float t)
+    {
+        return rlottie::Point(lerp(a.x(), b.x(), t), lerp(a.y(), b.y(), t));
+    }
+    static rlottie::Size lerp(const rlottie::Size& a, const rlottie::Size& b,
+                              float t)
+    {
+        return rlottie::Size(lerp(a.w(), b.w(), t), lerp(a.h(), b.h(), t));
+    }
+
+    void Move(LOTValue&& other)
+    {
+        switch (other.mKind) {
+        case Constant:
+            new (&impl.value) T(std::move(other.impl.value));
+            break;
+        case Animated:
+            new (&impl.frames) KeyFrames(std::move(other.impl.frames));
+            break;
+        case Callback:
+            new (&impl.func) Func(std::move(other.impl.func));
+            break;
+        }
+        mKind = other.mKind;
+    }
+
+    void Copy(const LOTValue& other)
+    {
+        switch (other.mKind) {
+        case Constant:
+            new (&impl.value) T(other.impl.value);
+            break;
+        case Animated:
+            new (&impl.frames) KeyFrames(other.impl.frames);
+            break;
+        case Callback:
+            new (&impl.func) Func(other.impl.func);
+            break;
+        }
+        mKind = other.mKind;
+    }
+
+    void Destroy()
+    {
+        switch (mKind) {
+        case Constant:
+            impl.value.~T();
+            break;
+        case Animated:
+            impl.frames.~KeyFrames();
+            break;
+        case Callback:
+            impl.func.~Func();
+            break;
+        }
+    }
+
+    enum Kind : uint8_t { Constant, Animated, Callback };
+    Kind mKind;
+    union details {
+        T         value;
+        KeyFrames frames;
+        Func      func;
+        details() {}
+        ~details() noexcept {}
+    } impl;
+};
+
+// Naive way to implement std::variant
+// refactor it when we move to c++17
+// users should make sure proper combination
+// of id and value are passed while creating the object.
+class LOTVariant {
+public:
+    using ColorValue = LOTValue<rlottie::Color>;
+    using FloatValue = LOTValue<float>;
+    using PointValue = LOTValue<rlottie::Point>;
+    using SizeValue = LOTValue<rlottie::Size>;
+
+    LOTVariant(rlottie::Property prop, FloatValue&& v)
+        : mPropery(prop), mTag(Value)
+    {
+        moveConstruct(impl.value, std::move(v));
+    }
+
+    LOTVariant(rlottie::Property prop, ColorValue&& v)
+        : mPropery(prop), mTag(Color)
+    {
+        moveConstruct(impl.color, std::move(v));
+    }
+
+    LOTVariant(rlottie::Property prop, PointValue&& v)
+        : mPropery(prop), mTag(Point)
     {
-        construct(impl.sizeFunc, v);
+        moveConstruct(impl.point, std::move(v));
     }
 
-    LOTVariant(rlottie::Property prop, SizeFunc&& v)
+    LOTVariant(rlottie::Property prop, SizeValue&& v)
         : mPropery(prop), mTag(Size)
     {
-        moveConstruct(impl.sizeFunc, std::move(v));
+        moveConstruct(impl.size, std::move(v));
     }
 
     rlottie::Property property() const { return mPropery; }
 
-    const ColorFunc& color() const
+    // the value doesn't depend on the frame (set from a plain value).
+    bool constant() const
+    {
+        switch (mTag) {
+        case Value:
+            return impl.value.constant();
+        case Color:
+            return impl.color.constant();
+        case Point:
+            return impl.point.constant();
+        case Size:
+            return impl.size.constant();
+        default:
+            return true;
+        }
+    }
+
+    const ColorValue& color() const
     {
         assert(mTag == Color);
-        return impl.colorFunc;
+        return impl.color;
     }
 
-    const ValueFunc& value() const
+    const FloatValue& value() const
     {
         assert(mTag == Value);
-        return impl.valueFunc;
+        return impl.value;
     }
 
-    const PointFunc& point() const
+    const PointValue& point() const
     {
         assert(mTag == Point);
-        return impl.pointFunc;
+        return impl.point;
     }
 
-    const SizeFunc& size() const
+    const SizeValue& size() const
     {
         assert(mTag == Size);
-        return impl.sizeFunc;
+        return impl.size;
     }
 
     LOTVariant() = default;
@@ -149,22 +303,23 @@ private:
     {
         switch (other.mTag) {
         case Type::Value:
-            moveConstruct(impl.valueFunc, std::move(other.impl.valueFunc));
+            moveConstruct(impl.value, std::move(other.impl.value));
             break;
         case Type::Color:
-            moveConstruct(impl.colorFunc, std::move(other.impl.colorFunc));
+            moveConstruct(impl.color, std::move(other.impl.color));
             break;
         case Type::Point:
-            moveConstruct(impl.pointFunc, std::move(other.impl.pointFunc));
+            moveConstruct(impl.point, std::move(other.impl.point));
             break;
         case Type::Size:
-            moveConstruct(impl.sizeFunc, std::move(other.impl.sizeFunc));
+            moveConstruct(impl.size, std::move(other.impl.size));
             break;
         default:
             break;
         }
         mTag = other.mTag;
         mPropery = other.mPropery;
+        other.Destroy();
         other.mTag = MonoState;
     }
 
@@ -172,16 +327,16 @@ private:
     {
         switch (other.mTag) {
         case Type::Value:
-            construct(impl.valueFunc, other.impl.valueFunc);
+            construct(impl.value, other.impl.value);
             break;
         case Type::Color:
-            construct(impl.colorFunc, other.impl.colorFunc);
+            construct(impl.color, other.impl.color);
             break;
         case Type::Point:
-            construct(impl.pointFunc, other.impl.pointFunc);
+            construct(impl.point, other.impl.point);
             break;
         case Type::Size:
-            construct(impl.sizeFunc, other.impl.sizeFunc);
+            construct(impl.size, other.impl.size);
             break;
         default:
             break;
@@ -197,19 +352,19 @@ private:
             break;
         }
         case Value: {
-            impl.valueFunc.~ValueFunc();
+            impl.value.~FloatValue();
             break;
         }
         case Color: {
-            impl.colorFunc.~ColorFunc();
+            impl.color.~ColorValue();
             break;
         }
         case Point: {
-            impl.pointFunc.~PointFunc();
+            impl.point.~PointValue();
             break;
         }
         case Size: {
-            impl.sizeFunc.~SizeFunc();
+            impl.size.~SizeValue();
             break;
         }
         }
@@ -219,10 +374,10 @@ private:
     rlottie::Property mPropery;
     Type              mTag{MonoState};
     union details {
-        ColorFunc colorFunc;
-        ValueFunc valueFunc;
-        PointFunc pointFunc;
-        SizeFunc  sizeFunc;
+        ColorValue color;
+        FloatValue value;
+        PointValue point;
+        SizeValue  size;
         details() {}
         ~details() noexcept {}
     } impl;
@@ -236,7 +391,7 @@ namespace model {
 
 class FilterData {
 public:
-    void addValue(LOTVariant& value)
+    void addValue(const LOTVariant& value)
     {
         uint32_t index = static_cast<uint32_t>(value.property());
         if (mBitset.test(index)) {
@@ -268,34 +423,33 @@ public:
     {
         return mBitset.test(static_cast<uint32_t>(prop));
     }
+    bool hasDynamicValue() const
+    {
+        return std::any_of(mFilters.begin(), mFilters.end(),
+                           [](const LOTVariant& e) { return !e.constant(); });
+    }
     model::Color color(rlottie::Property prop, int frame) const
     {
-        rlottie::FrameInfo info(frame);
-        rlottie::Color     col = data(prop).color()(info);
+        rlottie::Color col = data(prop).color().value(frame);
         return model::Color(col.r(), col.g(), col.b());
     }
     VPointF point(rlottie::Property prop, int frame) const
     {
-        rlottie::FrameInfo info(frame);
-        rlottie::Point     pt = data(prop).point()(info);
+        rlottie::Point pt = data(prop).point().value(frame);
         return VPointF(pt.x(), pt.y());
     }
     VSize scale(rlottie::Property prop, int frame) const
     {
-        rlottie::FrameInfo info(frame);
-        rlottie::Size      sz = data(prop).size()(info);
+        rlottie::Size sz = data(prop).size().value(frame);
         return VSize(sz.w(), sz.h());
     }
     float opacity(rlottie::Property prop, int frame) const
     {
-        rlottie::FrameInfo info(frame);
-        float              val = data(prop).value()(info);
-        return val / 100;
+        return data(prop).value().value(frame) / 100;
     }
     float value(rlottie::Property prop, int frame) const
     {
-        rlottie::FrameInfo info(frame);
-        return data(prop).value()(info);
+        return data(prop).value().value(frame);
     }
 
 private:
@@ -330,6 +484,12 @@ struct FilterBase
                          : false;
     }
 
+    bool hasValue() const { return filterData_ != nullptr; }
+
+    bool hasDynamicValue() const {
+        return filterData_ ? filterData_->hasDynamicValue() : false;
+    }
+
     T*                           model_{nullptr};
     std::unique_ptr<FilterData>  filterData_{nullptr};
 };
@@ -29,6 +29,7 @@
 #include "vbitmap.h"
 #include "vpainter.h"
 #include "vraster.h"
+#include "vtaskscheduler.h"
 
 /* Lottie Layer Rules
  * 1. time stretch is pre calculated and applied to all the properties of the
@@ -121,19 +122,159 @@ renderer::Composition::Composition(std::shared_ptr<model::Composition> model)
 void renderer::Composition::setValue(const std::string &keypath,
                                      LOTVariant &       value)
 {
-    mHasDynamicValue = true;
-    LOTKeyPath key(keypath);
-    mRootLayer->resolveKeyPath(key, 0, value);
+    std::vector<KeyValue> values;
+    values.emplace_back(keypath, std::move(value));
+    setValues(values);
+}
+
+uint32_t renderer::KeyPathIndex::add(const char *name, uint32_t parent,
+                                     bool container, Layer *layer)
+{
+    mTargets.push_back({layer, nullptr, layer->isStatic()});
+    return mIndex.add(name, parent, container);
+}
+
+uint32_t renderer::KeyPathIndex::add(const char *name, uint32_t parent,
+                                     bool container, Object *object)
+{
+    bool staticContent =
+        container && static_cast<renderer::Group *>(object)->isStatic();
+    mTargets.push_back({nullptr, object, staticContent});
+    return mIndex.add(name, parent, container);
+}
+
+// makes the layers and groups from node up to the root dynamic.
+void renderer::KeyPathIndex::markDynamic(uint32_t node)
+{
+    for (auto p = node; p != LOTKeyPathIndex::npos; p = mIndex.parent(p)) {
+        const auto &target = mTargets[p];
+        if (target.layer)
+            target.layer->setStatic(false);
+        else if (mIndex.container(p))
+            static_cast<renderer::Group *>(target.object)->setStatic(false);
+    }
+}
+
+// the static flags of the layers and groups before any value was set.
+void renderer::KeyPathIndex::restoreStatic()
+{
+    for (uint32_t p = 0; p < mTargets.size(); p++) {
+        const auto &target = mTargets[p];
+        if (target.layer)
+            target.layer->setStatic(target.staticContent);
+        else if (mIndex.container(p))
+            static_cast<renderer::Group *>(target.object)
+                ->setStatic(target.staticContent);
+    }
+}
+
+/*
+ * The keypaths resolve against an index of the renderer tree built on the
+ * first call. A constant value only invalidates the layers and groups above
+ * the content that takes it for the next update, a frame dependent one makes
+ * them dynamic and the composition can no longer skip a repeated frame.
+ */
+void renderer::Composition::setValues(const std::vector<KeyValue> &values)
+{
+    if (values.empty()) return;
+
+    if (mKeyPathIndex.mIndex.empty())
+        mRootLayer->indexKeyPaths(mKeyPathIndex, LOTKeyPathIndex::npos);
+
+    const auto &          index = mKeyPathIndex.mIndex;
+    std::vector<LOTKeyPath> keyPaths;
+    keyPaths.reserve(values.size());
+    for (const auto &value : values) keyPaths.emplace_back(value.first, index);
+
+    std::vector<std::vector<uint32_t>> nodes;
+    index.resolve(keyPaths, nodes);
+
+    bool applied = false;
+    bool replaced = false;
+    for (size_t i = 0; i < values.size(); i++) {
+        bool constant = values[i].second.constant();
+        for (auto node : nodes[i]) {
+            auto object = mKeyPathIndex.mTargets[node].object;
+            if (!object || !object->applyValue(values[i].second)) continue;
+
+            applied = true;
+            if (values[i].second.property() == rlottie::Property::TrimEnd)
+                static_cast<renderer::Trim *>(object)->dropBaked(mTimeline);
+            if (constant) {
+                replaced |= std::find(mDynamicValues.begin(),
+                                      mDynamicValues.end(),
+                                      node) != mDynamicValues.end();
+                for (auto p = node; p != LOTKeyPathIndex::npos;
+                     p = index.parent(p)) {
+                    const auto &target = mKeyPathIndex.mTargets[p];
+                    if (target.layer)
+                        target.layer->setValueDirty();
+                    else if (index.container(p))
+                        static_cast<renderer::Group *>(target.object)
+                            ->setValueDirty();
+                }
+            } else {
+                if (std::find(mDynamicValues.begin(), mDynamicValues.end(),
+                              node) == mDynamicValues.end())
+                    mDynamicValues.push_back(node);
+                mKeyPathIndex.markDynamic(node);
+            }
+        }
+    }
+    if (!applied) return;
+
+    /*
+     * a constant value can replace the last frame dependent one of a
+     * content, then the layers and groups above it get their static flag
+     * back unless the content of another dynamic value shares them.
+     */
+    if (replaced) {
+        const auto &targets = mKeyPathIndex.mTargets;
+        mDynamicValues.erase(
+            std::remove_if(mDynamicValues.begin(), mDynamicValues.end(),
+                           [&targets](uint32_t node) {
+                               return !targets[node].object->hasDynamicValue();
+                           }),
+            mDynamicValues.end());
+        mKeyPathIndex.restoreStatic();
+        for (auto node : mDynamicValues) mKeyPathIndex.markDynamic(node);
+    }
+    mHasDynamicValue = !mDynamicValues.empty();
+    mValueVersion++;
+}
+
+void renderer::Composition::prefetchImages()
+{
+    std::vector<ImageLayer *> list;
+    mRootLayer->imageLayers(list);
+    VTaskScheduler::instance().parallelFor(
+        list.size(), [&list](size_t i) { list[i]->acquireImage(); });
+}
+
+size_t renderer::Composition::bakeTimeline()
+{
+    mModel->bakeTimeline(mTimeline);
+    return mTimeline.bytes();
+}
+
+// the bitmaps stay decoded as long as another renderer of the model uses them.
+void renderer::Composition::releaseImages()
+{
+    std::vector<ImageLayer *> list;
+    mRootLayer->imageLayers(list);
+    for (auto layer : list) layer->releaseImage();
 }
 
 bool renderer::Composition::update(int frameNo, const VSize &size,
                                    bool keepAspectRatio)
 {
     // check if cached frame is same as requested frame.
-    if (!mHasDynamicValue && (mViewSize == size) && (mCurFrameNo == frameNo) &&
+    if (!mHasDynamicValue && (mUpdatedVersion == mValueVersion) &&
+        (mViewSize == size) && (mCurFrameNo == frameNo) &&
         (mKeepAspectRatio == keepAspectRatio))
         return false;
 
+    mUpdatedVersion = mValueVersion;
     mViewSize = size;
     mCurFrameNo = frameNo;
     mKeepAspectRatio = keepAspectRatio;
@@ -156,6 +297,7 @@ bool renderer::Composition::update(int frameNo, const VSize &size,
     } else {
         m.scale(sx, sy);
     }
+    model::Timeline::Scope scope(mTimeline.empty() ? nullptr : &mTimeline);
     mRootLayer->update(frameNo, m, 1.0);
     return true;
 }
@@ -385,52 +527,34 @@ VRle renderer::LayerMask::maskRle(const VRect &clipRect)
 
 renderer::Layer::Layer(model::Layer *layerData) : mLayerData(layerData)
 {
+    mStatic = mLayerData->isStatic();
+
     if (mLayerData->mHasMask)
         mLayerMask = std::make_unique<renderer::LayerMask>(mLayerData);
 }
 
-bool renderer::Layer::resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                     LOTVariant &value)
+void renderer::Layer::indexKeyPaths(KeyPathIndex &index, uint32_t parent)
 {
-    if (!keyPath.matches(name(), depth)) {
-        return false;
-    }
+    //@TODO handle the layer transform properties.
+    index.add(name(), parent, false, this);
+}
 
-    if (!keyPath.skip(name())) {
-        if (keyPath.fullyResolvesTo(name(), depth) &&
-            transformProp(value.property())) {
-            //@TODO handle propery update.
-        }
-    }
-    return true;
+void renderer::ShapeLayer::indexKeyPaths(KeyPathIndex &index,
+                                         uint32_t      parent)
+{
+    auto node = index.add(name(), parent, true, this);
+    mRoot->indexKeyPaths(index, node);
 }
 
-bool renderer::ShapeLayer::resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                          LOTVariant &value)
+void renderer::CompLayer::indexKeyPaths(KeyPathIndex &index, uint32_t parent)
 {
-    if (renderer::Layer::resolveKeyPath(keyPath, depth, value)) {
-        if (keyPath.propagate(name(), depth)) {
-            uint32_t newDepth = keyPath.nextDepth(name(), depth);
-            mRoot->resolveKeyPath(keyPath, newDepth, value);
-        }
-        return true;
-    }
-    return false;
+    auto node = index.add(name(), parent, true, this);
+    for (const auto &layer : mLayers) layer->indexKeyPaths(index, node);
 }
 
-bool renderer::CompLayer::resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                         LOTVariant &value)
+void renderer::CompLayer::imageLayers(std::vector<ImageLayer *> &list)
 {
-    if (renderer::Layer::resolveKeyPath(keyPath, depth, value)) {
-        if (keyPath.propagate(name(), depth)) {
-            uint32_t newDepth = keyPath.nextDepth(name(), depth);
-            for (const auto &layer : mLayers) {
-                layer->resolveKeyPath(keyPath, newDepth, value);
-            }
-        }
-        return true;
-    }
-    return false;
+    for (const auto &layer : mLayers) layer->imageLayers(list);
 }
 
 void renderer::Layer::update(int frameNumber, const VMatrix &parentMatrix,
@@ -469,11 +593,12 @@ void renderer::Layer::update(int frameNumber, const VMatrix &parentMatrix,
 
     // 5. if no parent property change and layer is static then nothing to do.
     if (!mLayerData->precompLayer() && flag().testFlag(DirtyFlagBit::None) &&
-        isStatic())
+        isStatic() && !mValueDirty)
         return;
 
     // 6. update the content of the layer
     updateContent();
+    mValueDirty = false;
 
     // 7. reset the dirty flag
     mDirtyFlag = DirtyFlagBit::None;
@@ -768,7 +893,7 @@ renderer::ImageLayer::ImageLayer(model::Layer *layerData)
 
     if (!mLayerData->asset()) return;
 
-    mTexture.mBitmap = mLayerData->asset()->bitmap();
+    // the bitmap is decoded on first draw, see renderList()
     VBrush brush(&mTexture);
     mRenderNode.setBrush(brush);
 }
@@ -801,9 +926,33 @@ renderer::DrawableList renderer::ImageLayer::renderList()
 {
     if (skipRendering()) return {};
 
+    acquireImage();
+
     return {&mDrawableList, 1};
 }
 
+void renderer::ImageLayer::imageLayers(std::vector<ImageLayer *> &list)
+{
+    list.push_back(this);
+}
+
+void renderer::ImageLayer::acquireImage()
+{
+    if (mAcquired || !mLayerData->asset()) return;
+
+    mTexture.mBitmap = mLayerData->asset()->acquireBitmap();
+    mAcquired = true;
+}
+
+void renderer::ImageLayer::releaseImage()
+{
+    if (!mAcquired) return;
+
+    mLayerData->asset()->releaseBitmap();
+    mTexture.mBitmap = VBitmap();
+    mAcquired = false;
+}
+
 renderer::NullLayer::NullLayer(model::Layer *layerData)
     : renderer::Layer(layerData)
 {
@@ -930,65 +1079,53 @@ void renderer::ShapeLayer::render(VPainter *painter, const VRle &inheritMask,
     }
 }
 
-bool renderer::Group::resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                     LOTVariant &value)
+void renderer::Group::indexKeyPaths(KeyPathIndex &index, uint32_t parent)
 {
-    if (!keyPath.skip(name())) {
-        if (!keyPath.matches(mModel.name(), depth)) {
-            return false;
-        }
+    auto node = index.add(name(), parent, true, this);
+    for (const auto &child : mContents) child->indexKeyPaths(index, node);
+}
 
-        if (!keyPath.skip(mModel.name())) {
-            if (keyPath.fullyResolvesTo(mModel.name(), depth) &&
-                transformProp(value.property())) {
-                mModel.filter()->addValue(value);
-            }
-        }
-    }
+bool renderer::Group::applyValue(const LOTVariant &value)
+{
+    if (!transformProp(value.property())) return false;
 
-    if (keyPath.propagate(name(), depth)) {
-        uint32_t newDepth = keyPath.nextDepth(name(), depth);
-        for (auto &child : mContents) {
-            child->resolveKeyPath(keyPath, newDepth, value);
-        }
-    }
+    mModel.filter()->addValue(value);
     return true;
 }
 
-bool renderer::Fill::resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                    LOTVariant &value)
+void renderer::Fill::indexKeyPaths(KeyPathIndex &index, uint32_t parent)
 {
-    if (!keyPath.matches(mModel.name(), depth)) {
-        return false;
-    }
+    index.add(mModel.name(), parent, false, this);
+}
 
-    if (keyPath.fullyResolvesTo(mModel.name(), depth) &&
-        fillProp(value.property())) {
-        mModel.filter()->addValue(value);
-        return true;
-    }
-    return false;
+bool renderer::Fill::applyValue(const LOTVariant &value)
+{
+    if (!fillProp(value.property())) return false;
+
+    mModel.filter()->addValue(value);
+    return true;
 }
 
-bool renderer::Stroke::resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                      LOTVariant &value)
+void renderer::Stroke::indexKeyPaths(KeyPathIndex &index, uint32_t parent)
 {
-    if (!keyPath.matches(mModel.name(), depth)) {
-        return false;
-    }
+    index.add(mModel.name(), parent, false, this);
+}
 
-    if (keyPath.fullyResolvesTo(mModel.name(), depth) &&
-        strokeProp(value.property())) {
-        mModel.filter()->addValue(value);
-        return true;
-    }
-    return false;
+bool renderer::Stroke::applyValue(const LOTVariant &value)
+{
+    if (!strokeProp(value.property())) return false;
+
+    mModel.filter()->addValue(value);
+    return true;
 }
 
 renderer::Group::Group(model::Group *data, VArenaAlloc *allocator)
     : mModel(data)
 {
     addChildren(data, allocator);
+
+    if (mModel.hasModel() && mModel.transform())
+        mStatic &= mModel.transform()->isStatic();
 }
 
 void renderer::Group::addChildren(model::Group *data, VArenaAlloc *allocator)
@@ -1004,6 +1141,11 @@ void renderer::Group::addChildren(model::Group *data, VArenaAlloc *allocator)
         auto content = createContentItem(*it, allocator);
         if (content) {
             mContents.push_back(content);
+            // the model group flag doesn't cover the children a repeater
+            // moved into it, so use the one of the renderer group.
+            mStatic &= (content->type() == renderer::Object::Type::Group)
+                           ? static_cast<renderer::Group *>(content)->isStatic()
+                           : (*it)->isStatic();
         }
     }
 }
@@ -1011,6 +1153,12 @@ void renderer::Group::addChildren(model::Group *data, VArenaAlloc *allocator)
 void renderer::Group::update(int frameNo, const VMatrix &parentMatrix,
                              float parentAlpha, const DirtyFlag &flag)
 {
+    // a static subtree only changes when one of its ancestors does or
+    // a value was set on its content.
+    if (flag.testFlag(DirtyFlagBit::None) && isStatic() && !mValueDirty)
+        return;
+    mValueDirty = false;
+
     DirtyFlag newFlag = flag;
     float     alpha;
 
@@ -1018,7 +1166,8 @@ void renderer::Group::update(int frameNo, const VMatrix &parentMatrix,
         VMatrix m = mModel.matrix(frameNo);
 
         m *= parentMatrix;
-        if (!(flag & DirtyFlagBit::Matrix) && !mModel.transform()->isStatic() &&
+        if (!(flag & DirtyFlagBit::Matrix) &&
+            (!mModel.transform()->isStatic() || mModel.hasValue()) &&
             (m != mMatrix)) {
             newFlag |= DirtyFlagBit::Matrix;
         }
@@ -1080,6 +1229,12 @@ void renderer::Group::processPaintItems(std::vector<renderer::Shape *> &list)
         case renderer::Object::Type::Paint: {
             static_cast<renderer::Paint *>(content)->addPathItems(list,
                                                                   curOpCount);
+            // the paint reads the dirty state of the paths in the
+            // child groups every frame.
+            for (auto j = mContents.rbegin(); j != i; ++j) {
+                if ((*j)->type() == renderer::Object::Type::Group)
+                    static_cast<renderer::Group *>(*j)->markShared();
+            }
             break;
         }
         case renderer::Object::Type::Group: {
@@ -1092,6 +1247,16 @@ void renderer::Group::processPaintItems(std::vector<renderer::Shape *> &list)
     }
 }
 
+void renderer::Group::collectPaints(std::vector<renderer::Paint *> &list)
+{
+    for (const auto &content : mContents) {
+        if (content->type() == renderer::Object::Type::Paint)
+            list.push_back(static_cast<renderer::Paint *>(content));
+        else if (content->type() == renderer::Object::Type::Group)
+            static_cast<renderer::Group *>(content)->collectPaints(list);
+    }
+}
+
 void renderer::Group::processTrimItems(std::vector<renderer::Shape *> &list)
 {
     size_t curOpCount = list.size();
@@ -1106,6 +1271,9 @@ void renderer::Group::processTrimItems(std::vector<renderer::Shape *> &list)
         case renderer::Object::Type::Trim: {
             static_cast<renderer::Trim *>(content)->addPathItems(list,
                                                                  curOpCount);
+            // trim rewrites the paths in place, they have to be
+            // reset by the update in every frame.
+            markShared();
             break;
         }
         case renderer::Object::Type::Group: {
@@ -1118,6 +1286,15 @@ void renderer::Group::processTrimItems(std::vector<renderer::Shape *> &list)
     }
 }
 
+void renderer::Group::markShared()
+{
+    mStatic = false;
+    for (const auto &content : mContents) {
+        if (content->type() == renderer::Object::Type::Group)
+            static_cast<renderer::Group *>(content)->markShared();
+    }
+}
+
 /*
  * renderer::Shape uses 2 path objects for path object reuse.
  * mLocalPath -  keeps track of the local path of the item before
@@ -1138,7 +1315,7 @@ void renderer::Group::processTrimItems(std::vector<renderer::Shape *> &list)
 void renderer::Shape::update(int              frameNo, const VMatrix &, float,
                              const DirtyFlag &flag)
 {
-    mDirtyPath = false;
+    mDirtyPath = mDirtyLocal = false;
 
     // 1. update the local path if needed
     if (hasChanged(frameNo)) {
@@ -1147,7 +1324,7 @@ void renderer::Shape::update(int              frameNo, const VMatrix &, float,
         mTemp = VPath();
 
         updatePath(mLocalPath, frameNo);
-        mDirtyPath = true;
+        mDirtyPath = mDirtyLocal = true;
     }
     // 2. keep a reference path in temp in case there is some
     // path operation like trim which will update the path.
@@ -1249,26 +1426,52 @@ void renderer::Paint::update(int frameNo, const VMatrix &parentMatrix,
                              float parentAlpha, const DirtyFlag & /*flag*/)
 {
     mRenderNodeUpdate = true;
+    mMatrix = parentMatrix;
     mContentToRender = updateContent(frameNo, parentMatrix, parentAlpha);
 }
 
+/*
+ * When all the paths are in the space of the paint the drawable gets the
+ * local path and the matrix, then it dashes again only when the path, the
+ * pattern or the matrix other than its translation change.
+ */
+bool renderer::Paint::localDash() const
+{
+    if (mDrawable.mType != VDrawable::Type::StrokeWithDash) return false;
+
+    for (const auto &i : mPathItems) {
+        if (i->parent()->matrix() != mMatrix) return false;
+    }
+    return true;
+}
+
 void renderer::Paint::updateRenderNode()
 {
     bool dirty = false;
+    bool changed = false;
     for (auto &i : mPathItems) {
-        if (i->dirty()) {
-            dirty = true;
-            break;
-        }
+        dirty |= i->dirty();
+        changed |= i->localDirty();
+    }
+
+    bool local = localDash();
+    if (local != mLocalDash) {
+        mLocalDash = local;
+        dirty = changed = true;
     }
 
     if (dirty) {
         mPath.reset();
-        for (const auto &i : mPathItems) {
-            i->finalPath(mPath);
+        if (mLocalDash) {
+            for (const auto &i : mPathItems) mPath.addPath(i->localPath());
+            mDrawable.setPath(mPath, mMatrix, changed);
+        } else {
+            for (const auto &i : mPathItems) {
+                i->finalPath(mPath);
+            }
+            mDrawable.setPath(mPath);
         }
-        mDrawable.setPath(mPath);
-    } else {
+    } else if (!mLocalDash) {
         if (mDrawable.mFlag & VDrawable::DirtyState::Path)
             mDrawable.mPath = mPath;
     }
@@ -1292,6 +1495,13 @@ void renderer::Paint::renderList(std::vector<VDrawable *> &list)
     if (mContentToRender) list.push_back(&mDrawable);
 }
 
+void renderer::Paint::setSource(renderer::Paint *source, const VMatrix &m)
+{
+    // the source raster is only up to date when it gets rendered.
+    if (source && !source->mContentToRender) source = nullptr;
+    mDrawable.setSource(source ? &source->mDrawable : nullptr, m);
+}
+
 void renderer::Paint::addPathItems(std::vector<renderer::Shape *> &list,
                                    size_t                          startOffset)
 {
@@ -1366,10 +1576,7 @@ bool renderer::Stroke::updateContent(int frameNo, const VMatrix &matrix,
     if (mModel.hasDashInfo()) {
         Dash_Vector.clear();
         mModel.getDashInfo(frameNo, Dash_Vector);
-        if (!Dash_Vector.empty()) {
-            for (auto &elm : Dash_Vector) elm *= scale;
-            mDrawable.setDashInfo(Dash_Vector);
-        }
+        if (!Dash_Vector.empty()) mDrawable.setDashInfo(Dash_Vector, scale);
     }
 
     return !color.isTransparent();
@@ -1402,28 +1609,24 @@ bool renderer::GradientStroke::updateContent(int frameNo, const VMatrix &matrix,
     if (mData->hasDashInfo()) {
         Dash_Vector.clear();
         mData->getDashInfo(frameNo, Dash_Vector);
-        if (!Dash_Vector.empty()) {
-            for (auto &elm : Dash_Vector) elm *= scale;
-            mDrawable.setDashInfo(Dash_Vector);
-        }
+        if (!Dash_Vector.empty()) mDrawable.setDashInfo(Dash_Vector, scale);
     }
 
     return !vIsZero(combinedAlpha);
 }
 
-bool renderer::Trim::resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                      LOTVariant &value)
+void renderer::Trim::indexKeyPaths(KeyPathIndex &index, uint32_t parent)
 {
-    if (!keyPath.matches(mModel.name(), depth)) {
-        return false;
-    }
+    index.add(mModel.name(), parent, false, this);
+}
 
-    if (keyPath.fullyResolvesTo(mModel.name(), depth) &&
-        trimProp(value.property())) {
-        mModel.filter()->addValue(value);
-        return true;
-    }
-    return false;
+bool renderer::Trim::applyValue(const LOTVariant &value)
+{
+    if (!trimProp(value.property())) return false;
+
+    mModel.filter()->addValue(value);
+    mCache.mFrameNo = -1;
+    return true;
 }
 
 void renderer::Trim::update(int frameNo, const VMatrix & /*parentMatrix*/,
@@ -1448,6 +1651,12 @@ void renderer::Trim::update()
     // when both path and trim are not dirty
     if (!(mDirty || pathDirty())) return;
 
+    // only a changed local path needs to be measured again, the draw-on
+    // animations and the parent transforms leave it as it is.
+    for (size_t i = 0; i < mPathItems.size(); i++) {
+        if (mPathItems[i]->localDirty()) mPathMesures[i].invalidate();
+    }
+
     if (vCompare(mCache.mSegment.start, mCache.mSegment.end)) {
         for (auto &i : mPathItems) {
             i->updatePath(VPath());
@@ -1463,32 +1672,36 @@ void renderer::Trim::update()
     }
 
     if (mData->type() == model::Trim::TrimType::Simultaneously) {
-        for (auto &i : mPathItems) {
-            mPathMesure.setRange(mCache.mSegment.start, mCache.mSegment.end);
-            i->updatePath(mPathMesure.trim(i->localPath()));
+        for (size_t i = 0; i < mPathItems.size(); i++) {
+            auto &mesure = mPathMesures[i];
+            mesure.setRange(mCache.mSegment.start, mCache.mSegment.end);
+            mPathItems[i]->updatePath(
+                mesure.trim(mPathItems[i]->localPath()));
         }
     } else {  // model::Trim::TrimType::Individually
         float totalLength = 0.0;
-        for (auto &i : mPathItems) {
-            totalLength += i->localPath().length();
+        for (size_t i = 0; i < mPathItems.size(); i++) {
+            totalLength += mPathMesures[i].length(mPathItems[i]->localPath());
         }
         float start = totalLength * mCache.mSegment.start;
         float end = totalLength * mCache.mSegment.end;
 
         if (start < end) {
             float curLen = 0.0;
-            for (auto &i : mPathItems) {
+            for (size_t i = 0; i < mPathItems.size(); i++) {
+                auto item = mPathItems[i];
                 if (curLen > end) {
                     // update with empty path.
-                    i->updatePath(VPath());
+                    item->updatePath(VPath());
                     continue;
                 }
-                float len = i->localPath().length();
+                auto &mesure = mPathMesures[i];
+                float len = mesure.length(item->localPath());
 
                 if (curLen < start && curLen + len < start) {
                     curLen += len;
                     // update with empty path.
-                    i->updatePath(VPath());
+                    item->updatePath(VPath());
                     continue;
                 } else if (start <= curLen && end >= curLen + len) {
                     // inside segment
@@ -1499,8 +1712,8 @@ void renderer::Trim::update()
                     local_start /= len;
                     float local_end = curLen + len < end ? len : end - curLen;
                     local_end /= len;
-                    mPathMesure.setRange(local_start, local_end);
-                    i->updatePath(mPathMesure.trim(i->localPath()));
+                    mesure.setRange(local_start, local_end);
+                    item->updatePath(mesure.trim(item->localPath()));
                     curLen += len;
                 }
             }
@@ -1513,6 +1726,7 @@ void renderer::Trim::addPathItems(std::vector<renderer::Shape *> &list,
 {
     std::copy(list.begin() + startOffset, list.end(),
               back_inserter(mPathItems));
+    mPathMesures.resize(mPathItems.size());
 }
 
 renderer::Repeater::Repeater(model::Repeater *data, VArenaAlloc *allocator)
@@ -1527,7 +1741,11 @@ renderer::Repeater::Repeater(model::Repeater *data, VArenaAlloc *allocator)
             mRepeaterData->content(), allocator);
         // content->setParent(this);
         mContents.push_back(content);
+        content->collectPaints(mPaints);
     }
+    mStatic = mRepeaterData->isStatic() &&
+              (mContents.empty() ||
+               static_cast<renderer::Group *>(mContents.front())->isStatic());
 }
 
 void renderer::Repeater::update(int frameNo, const VMatrix &parentMatrix,
@@ -1553,6 +1771,7 @@ void renderer::Repeater::update(int frameNo, const VMatrix &parentMatrix,
 
     newFlag |= DirtyFlagBit::Alpha;
 
+    VMatrix base;
     for (int i = 0; i < mCopies; ++i) {
         float newAlpha =
             parentAlpha * lerp(startOpacity, endOpacity, i / copies);
@@ -1563,6 +1782,30 @@ void renderer::Repeater::update(int frameNo, const VMatrix &parentMatrix,
         VMatrix result = mRepeaterData->mTransform.matrix(frameNo, i + offset) *
                          parentMatrix;
         mContents[i]->update(frameNo, result, newAlpha, newFlag);
+
+        if (i == 0)
+            base = result;
+        else
+            updateInstances(i, base, result, i < visibleCopies);
+    }
+}
+
+/*
+ * All the copies draw the same content, so the paths of a copy are the
+ * paths of the first copy mapped by the relative matrix of the two copies
+ * and the drawables of the copy reuse the raster work of the first one
+ * where that matrix allows it (see VDrawable::rasterizeFromSource()).
+ */
+void renderer::Repeater::updateInstances(int copy, const VMatrix &base,
+                                         const VMatrix &matrix, bool visible)
+{
+    bool    instance = visible && base.isInvertible();
+    VMatrix relative = instance ? base.inverted() * matrix : VMatrix();
+
+    size_t count = mPaints.size() / size_t(mCopies);
+    for (size_t i = 0; i < count; i++) {
+        mPaints[copy * count + i]->setSource(instance ? mPaints[i] : nullptr,
+                                             relative);
     }
 }
 
@@ -186,6 +186,32 @@ public:
 };
 
 class Layer;
+class ImageLayer;
+class Object;
+
+/*
+ * Keypath index of the renderer tree, node i of mIndex is the layer or
+ * the content of mTargets[i].
+ */
+struct KeyPathIndex {
+    struct Target {
+        Layer * layer{nullptr};
+        Object *object{nullptr};
+        // static flag of the layer or group before any value was set.
+        bool staticContent{false};
+    };
+    uint32_t add(const char *name, uint32_t parent, bool container,
+                 Layer *layer);
+    uint32_t add(const char *name, uint32_t parent, bool container,
+                 Object *object);
+    void     markDynamic(uint32_t node);
+    void     restoreStatic();
+
+    LOTKeyPathIndex     mIndex;
+    std::vector<Target> mTargets;
+};
+
+using KeyValue = std::pair<std::string, LOTVariant>;
 
 class Composition {
 public:
@@ -196,6 +222,10 @@ public:
     const LOTLayerNode *renderTree() const;
     bool                render(const rlottie::Surface &surface);
     void                setValue(const std::string &keypath, LOTVariant &value);
+    void                setValues(const std::vector<KeyValue> &values);
+    void                prefetchImages();
+    void                releaseImages();
+    size_t              bakeTimeline();
 
     // 设置渲染后端
     void setRenderBackend(RenderType type) { mRenderBackend = type; }
@@ -208,9 +238,14 @@ private:
     VMatrix                             mScaleMatrix;
     VSize                               mViewSize;
     std::shared_ptr<model::Composition> mModel;
+    model::Timeline                     mTimeline;
     Layer *                             mRootLayer{nullptr};
+    KeyPathIndex                        mKeyPathIndex;
+    std::vector<uint32_t>               mDynamicValues;
     VArenaAlloc                         mAllocator{2048};
     int                                 mCurFrameNo;
+    uint32_t                            mValueVersion{0};
+    uint32_t                            mUpdatedVersion{0};
     bool                                mKeepAspectRatio{true};
     bool                                mHasDynamicValue{false};
     RenderType                          mRenderBackend{RenderType::CPU}; // 默认使用CPU渲染
@@ -246,8 +281,11 @@ public:
     std::vector<LOTMask> &       cmasks() { return mCApiData->mMasks; }
     std::vector<LOTNode *> &     cnodes() { return mCApiData->mCNodeList; }
     const char *                 name() const { return mLayerData->name(); }
-    virtual bool resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                LOTVariant &value);
+    virtual void indexKeyPaths(KeyPathIndex &index, uint32_t parent);
+    bool         isStatic() const { return mStatic; }
+    void         setStatic(bool value) { mStatic = value; }
+    void         setValueDirty() { mValueDirty = true; }
+    virtual void imageLayers(std::vector<ImageLayer *> &) {}
 
 protected:
     virtual void   preprocessStage(const VRect &clip) = 0;
@@ -255,7 +293,6 @@ protected:
     inline VMatrix combinedMatrix() const { return mCombinedMatrix; }
     inline int     frameNo() const { return mFrameNo; }
     inline float   combinedAlpha() const { return mCombinedAlpha; }
-    inline bool    isStatic() const { return mLayerData->isStatic(); }
     float opacity(int frameNo) const { return mLayerData->opacity(frameNo); }
     inline DirtyFlag flag() const { return mDirtyFlag; }
     bool             skipRendering() const
@@ -271,6 +308,8 @@ protected:
     float                      mCombinedAlpha{0.0};
     int                        mFrameNo{-1};
     DirtyFlag                  mDirtyFlag{DirtyFlagBit::All};
+    bool                       mStatic{false};
+    bool                       mValueDirty{false};
     bool                       mComplexContent{false};
     std::unique_ptr<CApiData>  mCApiData;
 };
@@ -282,8 +321,8 @@ public:
     void render(VPainter *painter, const VRle &mask, const VRle &matteRle,
                 SurfaceCache &cache) final;
     void buildLayerNode() final;
-    bool resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                        LOTVariant &value) override;
+    void indexKeyPaths(KeyPathIndex &index, uint32_t parent) final;
+    void imageLayers(std::vector<ImageLayer *> &list) final;
 
 protected:
     void preprocessStage(const VRect &clip) final;
@@ -324,8 +363,7 @@ public:
     explicit ShapeLayer(model::Layer *layerData, VArenaAlloc *allocator);
     DrawableList renderList() final;
     void         buildLayerNode() final;
-    bool         resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                                LOTVariant &value) override;
+    void         indexKeyPaths(KeyPathIndex &index, uint32_t parent) final;
     void         render(VPainter *painter, const VRle &mask, const VRle &matteRle,
                         SurfaceCache &cache) final;
 
@@ -348,8 +386,14 @@ protected:
 class ImageLayer final : public Layer {
 public:
     explicit ImageLayer(model::Layer *layerData);
+    ~ImageLayer() override { releaseImage(); }
     void         buildLayerNode() final;
     DrawableList renderList() final;
+    void         imageLayers(std::vector<ImageLayer *> &list) final;
+    // takes a reference on the decoded image of the asset, see
+    // model::Asset::acquireBitmap().
+    void         acquireImage();
+    void         releaseImage();
 
 protected:
     void preprocessStage(const VRect &clip) final;
@@ -360,6 +404,7 @@ private:
     VTexture   mTexture;
     VPath      mPath;
     VDrawable *mDrawableList{nullptr};  // to work with the Span api
+    bool       mAcquired{false};
 };
 
 class Object {
@@ -370,14 +415,14 @@ public:
     virtual void update(int frameNo, const VMatrix &parentMatrix,
                         float parentAlpha, const DirtyFlag &flag) = 0;
     virtual void renderList(std::vector<VDrawable *> &) {}
-    virtual bool resolveKeyPath(LOTKeyPath &, uint32_t, LOTVariant &)
-    {
-        return false;
-    }
+    virtual void indexKeyPaths(KeyPathIndex &, uint32_t) {}
+    virtual bool applyValue(const LOTVariant &) { return false; }
+    virtual bool hasDynamicValue() const { return false; }
     virtual Object::Type type() const { return Object::Type::Unknown; }
 };
 
 class Shape;
+class Paint;
 class Group : public Object {
 public:
     Group() = default;
@@ -388,22 +433,31 @@ public:
     void applyTrim();
     void processTrimItems(std::vector<Shape *> &list);
     void processPaintItems(std::vector<Shape *> &list);
+    void collectPaints(std::vector<Paint *> &list);
     void renderList(std::vector<VDrawable *> &list) override;
     Object::Type   type() const final { return Object::Type::Group; }
     const VMatrix &matrix() const { return mMatrix; }
+    bool           isStatic() const { return mStatic; }
+    void           setStatic(bool value) { mStatic = value; }
     const char *   name() const
     {
         static const char *TAG = "__";
         return mModel.hasModel() ? mModel.name() : TAG;
     }
-    bool resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                        LOTVariant &value) override;
+    void indexKeyPaths(KeyPathIndex &index, uint32_t parent) override;
+    bool applyValue(const LOTVariant &value) override;
+    bool hasDynamicValue() const override { return mModel.hasDynamicValue(); }
+    void setValueDirty() { mValueDirty = true; }
 
 protected:
     std::vector<Object *> mContents;
     VMatrix               mMatrix;
+    bool                  mStatic{true};
+    bool                  mValueDirty{false};
 
 private:
+    void markShared();
+
     model::Filter<model::Group> mModel;
 };
 
@@ -414,12 +468,13 @@ public:
                 const DirtyFlag &flag) final;
     Object::Type type() const final { return Object::Type::Shape; }
     bool         dirty() const { return mDirtyPath; }
+    bool         localDirty() const { return mDirtyLocal; }
     const VPath &localPath() const { return mTemp; }
     void         finalPath(VPath &result);
     void         updatePath(const VPath &path)
     {
         mTemp = path;
-        mDirtyPath = true;
+        mDirtyPath = mDirtyLocal = true;
     }
     bool   staticPath() const { return mStaticPath; }
     void   setParent(Group *parent) { mParent = parent; }
@@ -443,6 +498,7 @@ private:
     VPath  mTemp;
     int    mFrameNo{-1};
     bool   mDirtyPath{true};
+    bool   mDirtyLocal{true};  // the local path changed, not just the matrix
     bool   mStaticPath;
 };
 
@@ -517,6 +573,7 @@ public:
                 const DirtyFlag &flag) override;
     void renderList(std::vector<VDrawable *> &list) final;
     Object::Type type() const final { return Object::Type::Paint; }
+    void         setSource(Paint *source, const VMatrix &m);
 
 protected:
     virtual bool updateContent(int frameNo, const VMatrix &matrix,
@@ -524,15 +581,18 @@ protected:
 
 private:
     void updateRenderNode();
+    bool localDash() const;
 
 protected:
     std::vector<Shape *> mPathItems;
     Drawable             mDrawable;
     VPath                mPath;
+    VMatrix              mMatrix;
     DirtyFlag            mFlag;
     bool                 mStaticContent;
     bool                 mRenderNodeUpdate{true};
     bool                 mContentToRender{true};
+    bool                 mLocalDash{false};
 };
 
 class Fill final : public Paint {
@@ -541,8 +601,9 @@ public:
 
 protected:
     bool updateContent(int frameNo, const VMatrix &matrix, float alpha) final;
-    bool resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                        LOTVariant &value) final;
+    void indexKeyPaths(KeyPathIndex &index, uint32_t parent) final;
+    bool applyValue(const LOTVariant &value) final;
+    bool hasDynamicValue() const final { return mModel.hasDynamicValue(); }
 
 private:
     model::Filter<model::Fill> mModel;
@@ -566,8 +627,9 @@ public:
 
 protected:
     bool updateContent(int frameNo, const VMatrix &matrix, float alpha) final;
-    bool resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                        LOTVariant &value) final;
+    void indexKeyPaths(KeyPathIndex &index, uint32_t parent) final;
+    bool applyValue(const LOTVariant &value) final;
+    bool hasDynamicValue() const final { return mModel.hasDynamicValue(); }
 
 private:
     model::Filter<model::Stroke> mModel;
@@ -593,10 +655,16 @@ public:
     Object::Type type() const final { return Object::Type::Trim; }
     void         update();
     void         addPathItems(std::vector<Shape *> &list, size_t startOffset);
+    // the end override is written to the model, its baked values are stale.
+    void dropBaked(model::Timeline &timeline) const
+    {
+        timeline.drop(mData->endTrack());
+    }
 
 protected:
-    bool resolveKeyPath(LOTKeyPath &keyPath, uint32_t depth,
-                        LOTVariant &value) final;
+    void indexKeyPaths(KeyPathIndex &index, uint32_t parent) final;
+    bool applyValue(const LOTVariant &value) final;
+    bool hasDynamicValue() const final { return mModel.hasDynamicValue(); }
 private:
     bool pathDirty() const
     {
@@ -609,11 +677,11 @@ private:
         int                  mFrameNo{-1};
         model::Trim::Segment mSegment{};
     };
-    Cache                mCache;
-    std::vector<Shape *> mPathItems;
-    model::Trim *        mData{nullptr};
-    VPathMesure          mPathMesure;
-    bool                 mDirty{true};
+    Cache                    mCache;
+    std::vector<Shape *>     mPathItems;
+    std::vector<VPathMesure> mPathMesures;  // length tables of mPathItems
+    model::Trim *            mData{nullptr};
+    bool                     mDirty{true};
 
     model::Filter<model::Trim> mModel;
 };
@@ -626,9 +694,13 @@ public:
     void renderList(std::vector<VDrawable *> &list) final;
 
 private:
-    model::Repeater *mRepeaterData{nullptr};
-    bool             mHidden{false};
-    int              mCopies{0};
+    void updateInstances(int copy, const VMatrix &base, const VMatrix &matrix,
+                         bool visible);
+
+    model::Repeater *    mRepeaterData{nullptr};
+    std::vector<Paint *> mPaints;  // paints of all the copies, copy by copy
+    bool                 mHidden{false};
+    int                  mCopies{0};
 };
 
 }  // namespace renderer
@@ -2,17 +2,40 @@
 
 #include <sstream>
 
-LOTKeyPath::LOTKeyPath(const std::string &keyPath)
+LOTKeyPath::LOTKeyPath(const std::string &keyPath, const LOTKeyPathIndex &index)
 {
     std::stringstream ss(keyPath);
     std::string       item;
 
     while (getline(ss, item, '.')) {
-        mKeys.push_back(item);
+        mKeys.push_back(index.find(item));
     }
 }
 
-bool LOTKeyPath::matches(const std::string &key, uint32_t depth)
+bool LOTKeyPath::skip(uint32_t key)
+{
+    return key == LOTKeyPathIndex::Skip;
+}
+
+bool LOTKeyPath::isGlobstar(uint32_t depth) const
+{
+    return mKeys[depth] == LOTKeyPathIndex::Globstar;
+}
+
+bool LOTKeyPath::isGlob(uint32_t depth) const
+{
+    return mKeys[depth] == LOTKeyPathIndex::Glob;
+}
+
+bool LOTKeyPath::hasGlob() const
+{
+    for (uint32_t i = 0; i < mKeys.size(); i++) {
+        if (isGlob(i) || isGlobstar(i)) return true;
+    }
+    return false;
+}
+
+bool LOTKeyPath::matches(uint32_t key, uint32_t depth) const
 {
     if (skip(key)) {
         // This is an object we programatically create.
@@ -21,21 +44,20 @@ bool LOTKeyPath::matches(const std::string &key, uint32_t depth)
     if (depth > size()) {
         return false;
     }
-    if ((mKeys[depth] == key) || (mKeys[depth] == "*") ||
-        (mKeys[depth] == "**")) {
+    if ((mKeys[depth] == key) || isGlob(depth) || isGlobstar(depth)) {
         return true;
     }
     return false;
 }
 
-uint32_t LOTKeyPath::nextDepth(const std::string key, uint32_t depth)
+uint32_t LOTKeyPath::nextDepth(uint32_t key, uint32_t depth) const
 {
     if (skip(key)) {
         // If it's a container then we added programatically and it isn't a part
         // of the keypath.
         return depth;
     }
-    if (mKeys[depth] != "**") {
+    if (!isGlobstar(depth)) {
         // If it's not a globstar then it is part of the keypath.
         return depth + 1;
     }
@@ -51,7 +73,7 @@ uint32_t LOTKeyPath::nextDepth(const std::string key, uint32_t depth)
     return depth;
 }
 
-bool LOTKeyPath::fullyResolvesTo(const std::string key, uint32_t depth)
+bool LOTKeyPath::fullyResolvesTo(uint32_t key, uint32_t depth) const
 {
     if (depth > mKeys.size()) {
         return false;
@@ -84,3 +106,110 @@ bool LOTKeyPath::fullyResolvesTo(const std::string key, uint32_t depth)
     // same as the current key.
     return mKeys[depth + 1] == key;
 }
+
+LOTKeyPathIndex::LOTKeyPathIndex()
+{
+    mNames.emplace("__", Skip);
+    mNames.emplace("*", Glob);
+    mNames.emplace("**", Globstar);
+    mNodesByName.resize(mNames.size());
+}
+
+uint32_t LOTKeyPathIndex::find(const std::string &name) const
+{
+    auto it = mNames.find(name);
+    return it == mNames.end() ? Unknown : it->second;
+}
+
+uint32_t LOTKeyPathIndex::add(const char *name, uint32_t parent,
+                              bool container)
+{
+    auto result = mNames.emplace(name ? name : "", uint32_t(mNames.size()));
+    if (result.second) mNodesByName.emplace_back();
+
+    auto node = uint32_t(mNodes.size());
+    Node n;
+    n.name = result.first->second;
+    n.parent = parent;
+    n.container = container;
+    mNodes.push_back(n);
+    mNodesByName[n.name].push_back(node);
+
+    uint32_t &last = (parent == npos) ? mLastRoot : mNodes[parent].lastChild;
+    if (last == npos)
+        ((parent == npos) ? mRoot : mNodes[parent].child) = node;
+    else
+        mNodes[last].sibling = node;
+    last = node;
+
+    return node;
+}
+
+/*
+ * Without globs a keypath names every non skip ancestor of the nodes it
+ * resolves to, so the candidates are the nodes with the last name and
+ * their ancestors only have to spell out the rest of the keypath.
+ */
+void LOTKeyPathIndex::resolveExact(const LOTKeyPath &     keyPath,
+                                   std::vector<uint32_t> &nodes) const
+{
+    uint32_t name = keyPath.mKeys.back();
+    if (name == Unknown) return;
+
+    for (auto node : mNodesByName[name]) {
+        // a skip container is never the target of a keypath.
+        if (name == Skip && container(node)) continue;
+
+        auto depth = keyPath.size();
+        bool match = true;
+        for (auto p = parent(node); p != npos && match; p = parent(p)) {
+            if (mNodes[p].name == Skip) continue;
+            match = depth > 0 && keyPath.mKeys[--depth] == mNodes[p].name;
+        }
+        if (match && depth == 0) nodes.push_back(node);
+    }
+}
+
+void LOTKeyPathIndex::visit(uint32_t node, const std::vector<LOTKeyPath> &keyPaths,
+                            const std::vector<State> &          states,
+                            std::vector<std::vector<uint32_t>> &nodes) const
+{
+    const Node &       n = mNodes[node];
+    std::vector<State> next;
+
+    for (const auto &state : states) {
+        const auto &keyPath = keyPaths[state.keyPath];
+        if (!keyPath.matches(n.name, state.depth)) continue;
+
+        if ((!n.container || !LOTKeyPath::skip(n.name)) &&
+            keyPath.fullyResolvesTo(n.name, state.depth))
+            nodes[state.keyPath].push_back(node);
+
+        if (n.container && keyPath.propagate(n.name, state.depth))
+            next.push_back(
+                {state.keyPath, keyPath.nextDepth(n.name, state.depth)});
+    }
+    if (next.empty()) return;
+
+    for (auto child = n.child; child != npos; child = mNodes[child].sibling)
+        visit(child, keyPaths, next, nodes);
+}
+
+void LOTKeyPathIndex::resolve(const std::vector<LOTKeyPath> &     keyPaths,
+                              std::vector<std::vector<uint32_t>> &nodes) const
+{
+    nodes.assign(keyPaths.size(), {});
+
+    std::vector<State> states;
+    for (uint32_t i = 0; i < keyPaths.size(); i++) {
+        if (keyPaths[i].mKeys.empty()) continue;
+        if (keyPaths[i].hasGlob())
+            states.push_back({i, 0});
+        else
+            resolveExact(keyPaths[i], nodes[i]);
+    }
+    if (states.empty()) return;
+
+    for (auto root = mRoot; root != npos; root = mNodes[root].sibling)
+        visit(root, keyPaths, states, nodes);
+}
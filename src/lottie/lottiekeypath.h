@@ -24,30 +24,88 @@
 #define LOTTIEKEYPATH_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "vglobal.h"
 
+class LOTKeyPathIndex;
+
+/*
+ * A keypath compiled against the names of a LOTKeyPathIndex, the keys are
+ * name ids so matching a node is an integer compare.
+ */
 class LOTKeyPath {
 public:
-    LOTKeyPath(const std::string &keyPath);
-    bool     matches(const std::string &key, uint32_t depth);
-    uint32_t nextDepth(const std::string key, uint32_t depth);
-    bool     fullyResolvesTo(const std::string key, uint32_t depth);
+    LOTKeyPath(const std::string &keyPath, const LOTKeyPathIndex &index);
+    bool     matches(uint32_t key, uint32_t depth) const;
+    uint32_t nextDepth(uint32_t key, uint32_t depth) const;
+    bool     fullyResolvesTo(uint32_t key, uint32_t depth) const;
 
-    bool propagate(const std::string key, uint32_t depth)
+    bool propagate(uint32_t key, uint32_t depth) const
     {
-        return skip(key) ? true : (depth < size()) || (mKeys[depth] == "**");
+        return skip(key) ? true : (depth < size()) || isGlobstar(depth);
     }
-    bool skip(const std::string &key) const { return key == "__"; }
+    static bool skip(uint32_t key);
+    bool        hasGlob() const;
 
 private:
-    bool   isGlobstar(uint32_t depth) const { return mKeys[depth] == "**"; }
-    bool   isGlob(uint32_t depth) const { return mKeys[depth] == "*"; }
-    bool   endsWithGlobstar() const { return mKeys.back() == "**"; }
+    friend class LOTKeyPathIndex;
+    bool   isGlobstar(uint32_t depth) const;
+    bool   isGlob(uint32_t depth) const;
+    bool   endsWithGlobstar() const { return isGlobstar(uint32_t(size())); }
     size_t size() const { return mKeys.size() - 1; }
 
 private:
-    std::vector<std::string> mKeys;
+    std::vector<uint32_t> mKeys;
+};
+
+/*
+ * Interned names of the layers and contents a keypath can address. The
+ * nodes are added parent first, a container passes the keypath down to
+ * the nodes added under it.
+ */
+class LOTKeyPathIndex {
+public:
+    enum : uint32_t { Skip = 0, Glob = 1, Globstar = 2, Unknown = ~0u };
+    static constexpr uint32_t npos = ~0u;
+
+    LOTKeyPathIndex();
+    uint32_t add(const char *name, uint32_t parent, bool container);
+    uint32_t find(const std::string &name) const;
+    uint32_t parent(uint32_t node) const { return mNodes[node].parent; }
+    bool     container(uint32_t node) const { return mNodes[node].container; }
+    bool     empty() const { return mNodes.empty(); }
+
+    // the nodes each keypath fully resolves to, nodes[i] for keyPaths[i].
+    // the keypaths with globs share one walk of the tree, the others go
+    // straight to the nodes with their last name.
+    void resolve(const std::vector<LOTKeyPath> &     keyPaths,
+                 std::vector<std::vector<uint32_t>> &nodes) const;
+
+private:
+    struct Node {
+        uint32_t name;
+        uint32_t parent;
+        uint32_t child{npos};
+        uint32_t lastChild{npos};
+        uint32_t sibling{npos};
+        bool     container;
+    };
+    struct State {
+        uint32_t keyPath;
+        uint32_t depth;
+    };
+    void visit(uint32_t node, const std::vector<LOTKeyPath> &keyPaths,
+               const std::vector<State> &          states,
+               std::vector<std::vector<uint32_t>> &nodes) const;
+    void resolveExact(const LOTKeyPath &keyPath,
+                      std::vector<uint32_t> &nodes) const;
+
+    std::unordered_map<std::string, uint32_t> mNames;
+    std::vector<std::vector<uint32_t>>        mNodesByName;
+    std::vector<Node>                         mNodes;
+    uint32_t                                  mRoot{npos};
+    uint32_t                                  mLastRoot{npos};
 };
 
 #endif  // LOTTIEKEYPATH_H
@@ -24,12 +24,14 @@
 #include <fstream>
 #include <sstream>
 
+#include "lottiedotlottie.h"
 #include "lottiemodel.h"
 
 using namespace rlottie::internal;
 
 #ifdef LOTTIE_CACHE_SUPPORT
 
+#include <mutex>
 #include <unordered_map>
 
 class ModelCache {
@@ -41,6 +43,7 @@ public:
     }
     std::shared_ptr<model::Composition> find(const std::string &key)
     {
+        std::lock_guard<std::mutex> guard(mMutex);
 
         if (!mcacheSize) return nullptr;
 
@@ -50,6 +53,7 @@ public:
     }
     void add(const std::string &key, std::shared_ptr<model::Composition> value)
     {
+        std::lock_guard<std::mutex> guard(mMutex);
 
         if (!mcacheSize) return;
 
@@ -60,18 +64,48 @@ public:
         mHash[key] = std::move(value);
     }
 
+    // dotLottie archives, shared by all the animations loaded from them.
+    std::shared_ptr<model::DotLottie> findArchive(const std::string &key)
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+
+        if (!mcacheSize) return nullptr;
+
+        auto search = mArchives.find(key);
+
+        return (search != mArchives.end()) ? search->second : nullptr;
+    }
+    void addArchive(const std::string &key,
+                    std::shared_ptr<model::DotLottie> value)
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+
+        if (!mcacheSize) return;
+
+        if (mcacheSize == mArchives.size()) mArchives.erase(mArchives.cbegin());
+
+        mArchives[key] = std::move(value);
+    }
+
     void configureCacheSize(size_t cacheSize)
     {
+        std::lock_guard<std::mutex> guard(mMutex);
+
         mcacheSize = cacheSize;
 
-        if (!mcacheSize) mHash.clear();
+        if (!mcacheSize) {
+            mHash.clear();
+            mArchives.clear();
+        }
     }
 
 private:
     ModelCache() = default;
 
     std::unordered_map<std::string, std::shared_ptr<model::Composition>> mHash;
+    std::unordered_map<std::string, std::shared_ptr<model::DotLottie>> mArchives;
     size_t mcacheSize{10};
+    std::mutex mMutex;
 };
 
 #else
@@ -88,6 +122,11 @@ public:
         return nullptr;
     }
     void add(const std::string &, std::shared_ptr<model::Composition>) {}
+    std::shared_ptr<model::DotLottie> findArchive(const std::string &)
+    {
+        return nullptr;
+    }
+    void addArchive(const std::string &, std::shared_ptr<model::DotLottie>) {}
     void configureCacheSize(size_t) {}
 };
 
@@ -108,41 +147,73 @@ void model::configureModelCacheSize(size_t cacheSize)
     ModelCache::instance().configureCacheSize(cacheSize);
 }
 
+void model::initModelCache()
+{
+    ModelCache::instance();
+}
+
 std::shared_ptr<model::Composition> model::loadFromFile(const std::string &path,
                                                         bool cachePolicy)
 {
+    return loadFromFile(path, {}, cachePolicy);
+}
+
+std::shared_ptr<model::Composition> model::loadFromFile(
+    const std::string &path, const std::string &animationId, bool cachePolicy)
+{
+    auto key = animationId.empty() ? path : path + '#' + animationId;
+
     if (cachePolicy) {
-        auto obj = ModelCache::instance().find(path);
+        auto obj = ModelCache::instance().find(key);
         if (obj) return obj;
     }
 
-    std::ifstream f;
-    f.open(path);
+    std::shared_ptr<model::DotLottie> archive;
+    if (cachePolicy) archive = ModelCache::instance().findArchive(path);
 
-    if (!f.is_open()) {
-        vCritical << "failed to open file = " << path.c_str();
-        return {};
+    std::shared_ptr<model::Composition> obj;
+    if (archive) {
+        obj = parseDotLottie(*archive, animationId, dirname(path));
     } else {
-        std::string content;
-        f.seekg(0, std::ios::end);
-        auto fsize = f.tellg();
-
-        //read the given file
-        content.reserve(fsize);
-        f.seekg(0, std::ios::beg);
-        content.assign((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
-
-        f.close();
-
-        if (fsize == 0) return {};
-
-        auto obj = internal::model::parse(const_cast<char *>(content.c_str()), fsize,
-                                          dirname(path));
+        std::ifstream f;
+        f.open(path, std::ios::in | std::ios::binary);
+
+        if (!f.is_open()) {
+            vCritical << "failed to open file = " << path.c_str();
+            return {};
+        }
+
+        char signature[4] = {};
+        f.read(signature, sizeof(signature));
+        auto count = size_t(f.gcount());
+        if (count == 0) return {};
+
+        if (model::DotLottie::isDotLottie(signature, count)) {
+            std::string content;
+            f.seekg(0, std::ios::end);
+            auto fsize = f.tellg();
+
+            //read the given file
+            content.reserve(fsize);
+            f.seekg(0, std::ios::beg);
+            content.assign((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+            // the archive takes over the file content.
+            archive = model::DotLottie::open(std::move(content));
+            if (!archive) return {};
+            if (cachePolicy) ModelCache::instance().addArchive(path, archive);
+            obj = parseDotLottie(*archive, animationId, dirname(path));
+        } else {
+            // json is read in chunks, without a copy of the whole file.
+            f.clear();
+            f.seekg(0, std::ios::beg);
+            obj = internal::model::parseStream(f, dirname(path));
+        }
+    }
 
-        if (obj && cachePolicy) ModelCache::instance().add(path, obj);
+    if (obj && cachePolicy) ModelCache::instance().add(key, obj);
 
-        return obj;
-    }
+    return obj;
 }
 
 std::shared_ptr<model::Composition> model::loadFromData(
@@ -154,8 +225,20 @@ std::shared_ptr<model::Composition> model::loadFromData(
         if (obj) return obj;
     }
 
-    auto obj = internal::model::parse(const_cast<char *>(jsonData.c_str()), jsonData.size(),
-                                      std::move(resourcePath));
+    std::shared_ptr<model::Composition> obj;
+    if (model::DotLottie::isDotLottie(jsonData.data(), jsonData.size())) {
+        std::shared_ptr<model::DotLottie> archive;
+        if (cachePolicy) archive = ModelCache::instance().findArchive(key);
+        if (!archive) {
+            archive = model::DotLottie::open(std::move(jsonData));
+            if (!archive) return {};
+            if (cachePolicy) ModelCache::instance().addArchive(key, archive);
+        }
+        obj = parseDotLottie(*archive, {}, std::move(resourcePath));
+    } else {
+        obj = internal::model::parse(const_cast<char *>(jsonData.c_str()),
+                                     jsonData.size(), std::move(resourcePath));
+    }
 
     if (obj && cachePolicy) ModelCache::instance().add(key, obj);
 
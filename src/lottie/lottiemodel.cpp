@@ -23,9 +23,11 @@
 #include "lottiemodel.h"
 #include <cassert>
 #include <iterator>
+#include <limits>
 #include <stack>
 #include "vimageloader.h"
 #include "vline.h"
+#include "vtaskscheduler.h"
 
 using namespace rlottie::internal;
 
@@ -173,7 +175,41 @@ VMatrix model::Repeater::Transform::matrix(int frameNo, float multiplier) const
     return m;
 }
 
-VMatrix model::Transform::Data::matrix(int frameNo, bool autoOrient) const
+std::unique_ptr<model::Timeline::Track>
+model::Transform::Data::bake(bool autoOrient) const
+{
+    // frame range in which any of the matrix properties changes.
+    int  first = std::numeric_limits<int>::max();
+    int  last = std::numeric_limits<int>::min();
+    auto range = [&](const auto &property) {
+        if (property.isStatic()) return;
+        first = std::min(first, property.animation().firstFrame());
+        last = std::max(last, property.animation().lastFrame());
+    };
+    range(mRotation);
+    range(mScale);
+    range(mPosition);
+    range(mAnchor);
+    if (mExtra) {
+        range(mExtra->m3DRx);
+        range(mExtra->m3DRy);
+        range(mExtra->m3DRz);
+        range(mExtra->mSeparateX);
+        range(mExtra->mSeparateY);
+    }
+    if (last < first) return nullptr;
+
+    auto baked = std::make_unique<Baked>();
+    baked->matrices_.reserve(size_t(last - first + 1));
+    for (int frameNo = first; frameNo <= last; frameNo++)
+        baked->matrices_.push_back(computeMatrix(frameNo, autoOrient));
+    baked->first_ = first;
+    baked->autoOrient_ = autoOrient;
+    baked->bytes_ = baked->matrices_.size() * sizeof(VMatrix);
+    return baked;
+}
+
+VMatrix model::Transform::Data::computeMatrix(int frameNo, bool autoOrient) const
 {
     VMatrix m;
     VPointF position;
@@ -337,15 +373,69 @@ void model::Gradient::update(std::unique_ptr<VGradient> &grad, int frameNo)
     }
 }
 
-void model::Asset::loadImageData(std::string data)
+void model::Asset::setImageData(std::shared_ptr<const std::string> data)
+{
+    mImageData = std::move(data);
+}
+
+void model::Asset::setImagePath(std::string path)
 {
-    if (!data.empty())
-        mBitmap = VImageLoader::instance().load(data.c_str(), data.length());
+    mImagePath = std::move(path);
 }
 
-void model::Asset::loadImagePath(std::string path)
+VBitmap model::Asset::acquireBitmap()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mUsers++) return mBitmap;
+
+    if (mImageData && !mImageData->empty()) {
+        mBitmap = VImageLoader::instance().load(mImageData->data(),
+                                                mImageData->size());
+    } else if (!mImagePath.empty()) {
+        mBitmap = VImageLoader::instance().load(mImagePath.c_str());
+    }
+    return mBitmap;
+}
+
+void model::Asset::releaseBitmap()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mUsers && !--mUsers) mBitmap = VBitmap();
+}
+
+thread_local const model::Timeline *model::Timeline::sCurrent = nullptr;
+
+size_t model::Timeline::bytes() const
+{
+    size_t total = 0;
+    for (const auto &track : mTracks)
+        if (track) total += track->bytes_;
+    return total;
+}
+
+/*
+ * The properties are baked on the task scheduler, each into its own track.
+ * The transforms read the property values so they are baked once all the
+ * properties are done, from their tracks.
+ */
+void model::Composition::bakeTimeline(Timeline &timeline) const
 {
-    if (!path.empty()) mBitmap = VImageLoader::instance().load(path.c_str());
+    timeline.clear();
+    timeline.resize(mTimelines.size() + mTransformTimelines.size());
+    VTaskScheduler::instance().parallelFor(mTimelines.size(), [&](size_t i) {
+        timeline.set(uint32_t(i), mTimelines[i]->bake());
+    });
+    auto offset = mTimelines.size();
+    VTaskScheduler::instance().parallelFor(
+        mTransformTimelines.size(), [&](size_t i) {
+            Timeline::Scope scope(&timeline);
+            const auto &    transform = mTransformTimelines[i];
+            timeline.set(uint32_t(offset + i),
+                         transform.first->bake(transform.second &&
+                                               transform.second->autoOrient()));
+        });
 }
 
 std::vector<LayerInfo> model::Composition::layerInfoList() const
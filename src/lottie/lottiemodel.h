@@ -24,10 +24,13 @@
 #define LOTModel_H
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <functional>
+#include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include "varenaalloc.h"
@@ -117,41 +120,25 @@ struct PathData {
             return;
         }
         auto size = std::min(start.mPoints.size(), end.mPoints.size());
-        /* reserve exact memory requirement at once
-         * ptSize = size + 1(size + close)
-         * elmSize = size/3 cubic + 1 move + 1 close
-         */
-        result.reserve(size + 1, size / 3 + 2);
-        result.moveTo(start.mPoints[0] +
-                      t * (end.mPoints[0] - start.mPoints[0]));
-        for (size_t i = 1; i < size; i += 3) {
-            result.cubicTo(
-                start.mPoints[i] + t * (end.mPoints[i] - start.mPoints[i]),
-                start.mPoints[i + 1] +
-                    t * (end.mPoints[i + 1] - start.mPoints[i + 1]),
-                start.mPoints[i + 2] +
-                    t * (end.mPoints[i + 2] - start.mPoints[i + 2]));
-        }
-        if (start.mClosed) result.close();
+        lerp(start.mPoints.data(), end.mPoints.data(), size, start.mClosed, t,
+             result);
+    }
+    // lerp of the first size points.
+    static void lerp(const VPointF *start, const VPointF *end, size_t size,
+                     bool closed, float t, VPath &result)
+    {
+        result.reset();
+        result.addSpline(start, end, size, t, closed);
     }
     void toPath(VPath &path) const
+    {
+        toPath(mPoints.data(), mPoints.size(), mClosed, path);
+    }
+    static void toPath(const VPointF *points, size_t size, bool closed,
+                       VPath &path)
     {
         path.reset();
-
-        if (mPoints.empty()) return;
-
-        auto size = mPoints.size();
-        auto points = mPoints.data();
-        /* reserve exact memory requirement at once
-         * ptSize = size + 1(size + close)
-         * elmSize = size/3 cubic + 1 move + 1 close
-         */
-        path.reserve(size + 1, size / 3 + 2);
-        path.moveTo(points[0]);
-        for (size_t i = 1; i < size; i += 3) {
-            path.cubicTo(points[i], points[i + 1], points[i + 2]);
-        }
-        if (mClosed) path.close();
+        path.addSpline(points, size, closed);
     }
 };
 
@@ -161,31 +148,47 @@ struct Value {
     T     end_;
     T     at(float t) const { return lerp(start_, end_, t); }
     float angle(float) const { return 0; }
-    void  cache() {}
+    void  cache(VArenaAlloc &) {}
 };
 
 struct Position;
 
 template <typename T>
 struct Value<T, Position> {
-    T     start_;
-    T     end_;
-    T     inTangent_;
-    T     outTangent_;
-    float length_{0};
-    bool  hasTangent_{false};
-
-    void cache()
+    T                  start_;
+    T                  end_;
+    T                  inTangent_;
+    T                  outTangent_;
+    float              length_{0};
+    bool               hasTangent_{false};
+    // arc length at t = i / lengthSamples, from the composition arena.
+    float             *lengths_{nullptr};
+
+    void cache(VArenaAlloc &allocator)
     {
         if (hasTangent_) {
             inTangent_ = end_ + inTangent_;
             outTangent_ = start_ + outTangent_;
-            length_ = VBezier::fromPoints(start_, outTangent_, inTangent_, end_)
-                          .length();
+            /*
+             * arc length parameterization table, so the position at a
+             * length is a lookup instead of splitting and measuring the
+             * curve every frame.
+             */
+            auto b = VBezier::fromPoints(start_, outTangent_, inTangent_, end_);
+            lengths_ = allocator.makeArrayDefault<float>(lengthSamples + 1);
+            lengths_[0] = 0;
+            for (int i = 1; i <= lengthSamples; i++) {
+                lengths_[i] = lengths_[i - 1] +
+                              b.onInterval(float(i - 1) / lengthSamples,
+                                           float(i) / lengthSamples)
+                                  .length();
+            }
+            length_ = lengths_[lengthSamples];
             if (vIsZero(length_)) {
                 // this segment has zero length.
                 // so disable expensive path computaion.
                 hasTangent_ = false;
+                lengths_ = nullptr;
             }
         }
     }
@@ -199,7 +202,7 @@ struct Value<T, Position> {
              */
             VBezier b =
                 VBezier::fromPoints(start_, outTangent_, inTangent_, end_);
-            return b.pointAt(b.tAtLength(t * length_, length_));
+            return b.pointAt(tAtLength(t * length_));
         }
         return lerp(start_, end_, t);
     }
@@ -209,75 +212,390 @@ struct Value<T, Position> {
         if (hasTangent_) {
             VBezier b =
                 VBezier::fromPoints(start_, outTangent_, inTangent_, end_);
-            return b.angleAt(b.tAtLength(t * length_, length_));
+            return b.angleAt(tAtLength(t * length_));
         }
         return 0;
     }
+
+private:
+    static constexpr int lengthSamples = 64;
+
+    float tAtLength(float length) const
+    {
+        if (length >= length_) return 1;
+        if (length <= 0) return 0;
+
+        auto it = std::upper_bound(lengths_, lengths_ + lengthSamples + 1,
+                                   length);
+        auto i = int(it - lengths_) - 1;
+        auto segment = lengths_[i + 1] - lengths_[i];
+        auto fraction = segment > 0 ? (length - lengths_[i]) / segment : 0;
+        return (float(i) + fraction) / lengthSamples;
+    }
 };
 
-template <typename T, typename Tag>
-class KeyFrames {
+/*
+ * Values of the animated properties evaluated for every frame ahead, see
+ * renderer::Composition::bakeTimeline(). A timeline belongs to one
+ * renderer, the model shared by the Animation objects of a cached file
+ * is left as it is. Each animated property and transform has a track index
+ * into it, and looks its values up in the timeline of the renderer that
+ * updates on the current thread.
+ */
+class Timeline {
 public:
-    struct Frame {
-        float progress(int frameNo) const
-        {
-            return interpolator_ ? interpolator_->value((frameNo - start_) /
-                                                        (end_ - start_))
-                                 : 0;
-        }
-        T     value(int frameNo) const { return value_.at(progress(frameNo)); }
-        float angle(int frameNo) const
+    static constexpr uint32_t npos = uint32_t(-1);
+
+    // the baked frames of one property, from its first animated frame.
+    struct Track {
+        virtual ~Track() = default;
+        int    first_{0};
+        size_t bytes_{0};
+    };
+
+    // makes timeline the one looked up on this thread while it lives.
+    class Scope {
+    public:
+        explicit Scope(const Timeline *timeline) : mPrevious(sCurrent)
         {
-            return value_.angle(progress(frameNo));
+            sCurrent = timeline;
         }
+        ~Scope() { sCurrent = mPrevious; }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
 
-        float          start_{0};
-        float          end_{0};
-        VInterpolator *interpolator_{nullptr};
-        Value<T, Tag>  value_;
+    private:
+        const Timeline *mPrevious;
     };
 
-    T value(int frameNo) const
+    template <typename T>
+    static const T *find(uint32_t index)
+    {
+        auto timeline = sCurrent;
+        if (!timeline || index >= timeline->mTracks.size()) return nullptr;
+        return static_cast<const T *>(timeline->mTracks[index].get());
+    }
+
+    bool   empty() const { return mTracks.empty(); }
+    size_t bytes() const;
+    void   resize(size_t count) { mTracks.resize(count); }
+    void   set(uint32_t index, std::unique_ptr<Track> track)
+    {
+        mTracks[index] = std::move(track);
+    }
+    // drops the values of one track, the property is evaluated again.
+    void drop(uint32_t index)
+    {
+        if (index < mTracks.size()) mTracks[index].reset();
+    }
+    void clear() { std::vector<std::unique_ptr<Track>>().swap(mTracks); }
+
+private:
+    static thread_local const Timeline *sCurrent;
+    std::vector<std::unique_ptr<Track>> mTracks;
+};
+
+// keyframe as read by the parser, see KeyFrames::cache().
+template <typename T, typename Tag>
+struct KeyFrame {
+    float          start_{0};
+    float          end_{0};
+    VInterpolator *interpolator_{nullptr};
+    Value<T, Tag>  value_;
+};
+
+/*
+ * Time part of the keyframes. The segment times are kept in their own
+ * dense array apart from the interpolators and values, so finding the
+ * segment of a frame doesn't walk over the keyframe values.
+ */
+class KeyFrameTimes {
+public:
+    struct Time {
+        float start_;
+        float end_;
+    };
+
+    bool changed(int prevFrame, int curFrame) const
+    {
+        auto first = mTimes.front().start_;
+        auto last = mTimes.back().end_;
+
+        return !((first > prevFrame && first > curFrame) ||
+                 (last < prevFrame && last < curFrame));
+    }
+
+    /*
+     * integer frames between the first and the last keyframe, outside of
+     * them the value is the first / last keyframe value.
+     */
+    int firstFrame() const { return int(std::floor(mTimes.front().start_)) + 1; }
+    int lastFrame() const { return int(std::ceil(mTimes.back().end_)) - 1; }
+
+    /*
+     * evaluates all the frames between the keyframes ahead so value() is an
+     * array lookup in the track of the current timeline, see Timeline.
+     */
+    virtual std::unique_ptr<Timeline::Track> bake() const = 0;
+    virtual ~KeyFrameTimes() = default;
+
+    uint32_t track() const { return mTrack; }
+    void     setTrack(uint32_t track) { mTrack = track; }
+
+protected:
+    bool beforeFirst(int frameNo) const
     {
-        if (frames_.front().start_ >= frameNo)
-            return frames_.front().value_.start_;
-        if (frames_.back().end_ <= frameNo) return frames_.back().value_.end_;
+        return mTimes.front().start_ >= frameNo;
+    }
+    bool afterLast(int frameNo) const { return mTimes.back().end_ <= frameNo; }
 
-        for (const auto &keyFrame : frames_) {
-            if (frameNo >= keyFrame.start_ && frameNo < keyFrame.end_)
-                return keyFrame.value(frameNo);
+    float progress(size_t index, int frameNo) const
+    {
+        const auto &time = mTimes[index];
+        return mInterpolators[index]
+                   ? mInterpolators[index]->value((frameNo - time.start_) /
+                                                  (time.end_ - time.start_))
+                   : 0;
+    }
+
+    template <typename Frame>
+    void setTimes(const std::vector<Frame> &frames)
+    {
+        mTimes.reserve(frames.size());
+        mInterpolators.reserve(frames.size());
+        for (const auto &frame : frames) {
+            mTimes.push_back({frame.start_, frame.end_});
+            mInterpolators.push_back(frame.interpolator_);
         }
-        return {};
+    }
+
+    /*
+     * returns the index of the keyframe segment containing frameNo or
+     * npos. The last segment found (and the next one) is checked first so
+     * the sequential playback doesn't search, otherwise a binary search on
+     * the sorted segments. The cursor is only a hint, a race on it when the
+     * model is shared between renderers just costs a search.
+     */
+    size_t find(int frameNo) const
+    {
+        auto contains = [frameNo](const Time &t) {
+            return frameNo >= t.start_ && frameNo < t.end_;
+        };
+        auto size = mTimes.size();
+        auto cursor = mCursor.load(std::memory_order_relaxed);
+        if (cursor < size && contains(mTimes[cursor])) return cursor;
+        if (++cursor < size && contains(mTimes[cursor])) {
+            mCursor.store(cursor, std::memory_order_relaxed);
+            return cursor;
+        }
+
+        auto it = std::upper_bound(
+            mTimes.begin(), mTimes.end(), float(frameNo),
+            [](float frame, const Time &t) { return frame < t.end_; });
+        if (it == mTimes.end() || !contains(*it)) return npos;
+
+        cursor = size_t(it - mTimes.begin());
+        mCursor.store(cursor, std::memory_order_relaxed);
+        return cursor;
+    }
+
+    static constexpr size_t npos = size_t(-1);
+
+    std::vector<Time>            mTimes;
+    std::vector<VInterpolator *> mInterpolators;
+    mutable std::atomic<size_t>  mCursor{0};
+    uint32_t                     mTrack{Timeline::npos};
+};
+
+template <typename T, typename Tag>
+class KeyFrames : public KeyFrameTimes {
+public:
+    using Frame = KeyFrame<T, Tag>;
+
+    T value(int frameNo) const
+    {
+        if (beforeFirst(frameNo)) return mValues.front().start_;
+        if (afterLast(frameNo)) return mValues.back().end_;
+        if (auto baked = Timeline::find<Baked>(mTrack))
+            return baked->values_[size_t(frameNo - baked->first_)];
+
+        auto index = find(frameNo);
+        return index != npos ? mValues[index].at(progress(index, frameNo))
+                             : T{};
     }
 
     float angle(int frameNo) const
     {
-        if ((frames_.front().start_ >= frameNo) ||
-            (frames_.back().end_ <= frameNo))
-            return 0;
+        if (beforeFirst(frameNo) || afterLast(frameNo)) return 0;
 
-        for (const auto &frame : frames_) {
-            if (frameNo >= frame.start_ && frameNo < frame.end_)
-                return frame.angle(frameNo);
+        auto index = find(frameNo);
+        return index != npos ? mValues[index].angle(progress(index, frameNo))
+                             : 0;
+    }
+
+    const std::vector<Value<T, Tag>> &values() const { return mValues; }
+    std::vector<Value<T, Tag>> &      values() { return mValues; }
+
+    // moves the keyframes read by the parser to the lookup arrays.
+    void cache(std::vector<Frame> frames, VArenaAlloc &allocator)
+    {
+        setTimes(frames);
+        mValues.reserve(frames.size());
+        for (auto &frame : frames) {
+            frame.value_.cache(allocator);
+            mValues.push_back(std::move(frame.value_));
         }
-        return 0;
     }
 
-    bool changed(int prevFrame, int curFrame) const
+    std::unique_ptr<Timeline::Track> bake() const override
     {
-        auto first = frames_.front().start_;
-        auto last = frames_.back().end_;
+        int first = firstFrame();
+        int last = lastFrame();
+        if (last < first) return nullptr;
+
+        auto baked = std::make_unique<Baked>();
+        baked->values_.reserve(size_t(last - first + 1));
+        for (int frameNo = first; frameNo <= last; frameNo++)
+            baked->values_.push_back(value(frameNo));
+        baked->first_ = first;
+        baked->bytes_ = baked->values_.size() * sizeof(T);
+        return baked;
+    }
 
-        return !((first > prevFrame && first > curFrame) ||
-                 (last < prevFrame && last < curFrame));
+private:
+    struct Baked : Timeline::Track {
+        std::vector<T> values_;
+    };
+
+    std::vector<Value<T, Tag>> mValues;
+};
+
+/*
+ * Shape keyframes keep their points in one buffer allocated from the
+ * composition arena instead of a vector per keyframe. The end shape of a
+ * segment is usually the start shape of the next one and is shared.
+ */
+template <>
+class KeyFrames<PathData, void> : public KeyFrameTimes {
+public:
+    using Frame = KeyFrame<PathData, void>;
+
+    void value(int frameNo, VPath &path) const
+    {
+        if (beforeFirst(frameNo)) return toPath(mShapes.front().start_, path);
+        if (afterLast(frameNo)) return toPath(mShapes.back().end_, path);
+        if (auto baked = Timeline::find<Baked>(mTrack)) {
+            const auto &shape = baked->shapes_[size_t(frameNo - baked->first_)];
+            return PathData::toPath(baked->points_.data() + shape.offset_,
+                                    shape.size_, shape.closed_, path);
+        }
+
+        auto index = find(frameNo);
+        if (index == npos) return;
+
+        const auto &start = mShapes[index].start_;
+        const auto &end = mShapes[index].end_;
+        if (!start.size_ || !end.size_) return path.reset();
+        PathData::lerp(mPoints + start.offset_, mPoints + end.offset_,
+                       std::min(start.size_, end.size_), start.closed_,
+                       progress(index, frameNo), path);
     }
-    void cache()
+
+    void cache(std::vector<Frame> frames, VArenaAlloc &allocator)
     {
-        for (auto &e : frames_) e.value_.cache();
+        setTimes(frames);
+
+        auto shared = [&frames](size_t i) {
+            if (i + 1 >= frames.size()) return false;
+            const auto &end = frames[i].value_.end_;
+            const auto &next = frames[i + 1].value_.start_;
+            return end.mClosed == next.mClosed &&
+                   end.mPoints.size() == next.mPoints.size() &&
+                   !memcmp(end.mPoints.data(), next.mPoints.data(),
+                           end.mPoints.size() * sizeof(VPointF));
+        };
+        size_t count = 0;
+        for (size_t i = 0; i < frames.size(); i++) {
+            count += frames[i].value_.start_.mPoints.size();
+            if (!shared(i)) count += frames[i].value_.end_.mPoints.size();
+        }
+        mPoints = allocator.makeArrayDefault<VPointF>(count);
+
+        size_t offset = 0;
+        auto   add = [this, &offset](const PathData &data) {
+            std::copy(data.mPoints.begin(), data.mPoints.end(),
+                      mPoints + offset);
+            Shape shape{uint32_t(offset), uint32_t(data.mPoints.size()),
+                        data.mClosed};
+            offset += data.mPoints.size();
+            return shape;
+        };
+        mShapes.resize(frames.size());
+        for (size_t i = 0; i < frames.size(); i++) {
+            mShapes[i].start_ = add(frames[i].value_.start_);
+            if (i && shared(i - 1)) mShapes[i - 1].end_ = mShapes[i].start_;
+            if (!shared(i)) mShapes[i].end_ = add(frames[i].value_.end_);
+        }
     }
 
-public:
-    std::vector<Frame> frames_;
+    // the baked frames keep the interpolated points, not the VPath.
+    std::unique_ptr<Timeline::Track> bake() const override
+    {
+        int first = firstFrame();
+        int last = lastFrame();
+        if (last < first) return nullptr;
+
+        auto  baked = std::make_unique<Baked>();
+        auto &shapes = baked->shapes_;
+        auto &points = baked->points_;
+        shapes.reserve(size_t(last - first + 1));
+        for (int frameNo = first; frameNo <= last; frameNo++) {
+            auto index = find(frameNo);
+            // keyframes with holes keep the lookup.
+            if (index == npos) return nullptr;
+
+            const auto &start = mShapes[index].start_;
+            const auto &end = mShapes[index].end_;
+            Shape shape{uint32_t(points.size()), 0, start.closed_};
+            if (start.size_ && end.size_) {
+                shape.size_ = std::min(start.size_, end.size_);
+                auto t = progress(index, frameNo);
+                auto from = mPoints + start.offset_;
+                auto to = mPoints + end.offset_;
+                for (uint32_t i = 0; i < shape.size_; i++)
+                    points.push_back(from[i] + t * (to[i] - from[i]));
+            }
+            shapes.push_back(shape);
+        }
+        baked->first_ = first;
+        baked->bytes_ =
+            shapes.size() * sizeof(Shape) + points.size() * sizeof(VPointF);
+        return baked;
+    }
+
+private:
+    struct Shape {
+        uint32_t offset_;
+        uint32_t size_;
+        bool     closed_;
+    };
+    struct Segment {
+        Shape start_;
+        Shape end_;
+    };
+    struct Baked : Timeline::Track {
+        std::vector<Shape>   shapes_;
+        std::vector<VPointF> points_;
+    };
+
+    void toPath(const Shape &shape, VPath &path) const
+    {
+        PathData::toPath(mPoints + shape.offset_, shape.size_, shape.closed_,
+                         path);
+    }
+
+    std::vector<Segment> mShapes;
+    VPointF *            mPoints{nullptr};
 };
 
 template <typename T, typename Tag = void>
@@ -339,18 +657,7 @@ public:
         if (isStatic()) {
             value().toPath(path);
         } else {
-            const auto &vec = animation().frames_;
-            if (vec.front().start_ >= frameNo)
-                return vec.front().value_.start_.toPath(path);
-            if (vec.back().end_ <= frameNo)
-                return vec.back().value_.end_.toPath(path);
-
-            for (const auto &keyFrame : vec) {
-                if (frameNo >= keyFrame.start_ && frameNo < keyFrame.end_) {
-                    T::lerp(keyFrame.value_.start_, keyFrame.value_.end_,
-                            keyFrame.progress(frameNo), path);
-                }
-            }
+            animation().value(frameNo, path);
         }
     }
 
@@ -363,10 +670,6 @@ public:
     {
         return isStatic() ? false : animation().changed(prevFrame, curFrame);
     }
-    void cache()
-    {
-        if (!isStatic()) animation().cache();
-    }
 
 private:
     template <typename Tp>
@@ -505,9 +808,12 @@ struct Asset {
     enum class Type : unsigned char { Precomp, Image, Char };
     bool                  isStatic() const { return mStatic; }
     void                  setStatic(bool value) { mStatic = value; }
-    VBitmap               bitmap() const { return mBitmap; }
-    void                  loadImageData(std::string data);
-    void                  loadImagePath(std::string Path);
+    // the decoded image is shared by the users of a cached model, the first
+    // acquireBitmap() decodes it and the last releaseBitmap() drops it.
+    VBitmap               acquireBitmap();
+    void                  releaseBitmap();
+    void                  setImageData(std::shared_ptr<const std::string> data);
+    void                  setImagePath(std::string path);
     Type                  mAssetType{Type::Precomp};
     bool                  mStatic{true};
     std::string           mRefId;  // ref id
@@ -515,10 +821,16 @@ struct Asset {
     // image asset data
     int     mWidth{0};
     int     mHeight{0};
-    VBitmap mBitmap;
+    // compressed image (png/jpeg bytes or file path) kept for decoding.
+    std::shared_ptr<const std::string> mImageData;
+    std::string                        mImagePath;
+    VBitmap                            mBitmap;
+    size_t                             mUsers{0};
+    std::mutex                         mMutex;
 };
 
 class Layer;
+class Transform;
 
 class Composition : public Object {
 public:
@@ -547,6 +859,8 @@ public:
     VSize  size() const { return mSize; }
     void   processRepeaterObjects();
     void   updateStats();
+    // evaluates the animated properties of every frame ahead into timeline.
+    void   bakeTimeline(Timeline &timeline) const;
 
 public:
     struct Stats {
@@ -569,7 +883,13 @@ public:
 
     std::vector<Marker> mMarkers;
     VArenaAlloc         mArenaAlloc{2048};
-    Stats               mStats;
+    // arenas filled by the parallel parser, owned by the composition.
+    std::vector<std::unique_ptr<VArenaAlloc>> mArenaList;
+    // animated properties and transforms (with their layer), in the order
+    // of their tracks, for bakeTimeline()
+    std::vector<KeyFrameTimes *>                 mTimelines;
+    std::vector<std::pair<Transform *, Layer *>> mTransformTimelines;
+    Stats                                     mStats;
 };
 
 class Transform : public Object {
@@ -584,11 +904,23 @@ public:
             bool            mSeparate{false};
             bool            m3DData{false};
         };
-        VMatrix matrix(int frameNo, bool autoOrient = false) const;
-        float   opacity(int frameNo) const
+        VMatrix matrix(int frameNo, bool autoOrient = false) const
+        {
+            auto baked = Timeline::find<Baked>(mTrack);
+            if (baked && autoOrient == baked->autoOrient_) {
+                auto index = size_t(frameNo - baked->first_);
+                if (index < baked->matrices_.size())
+                    return baked->matrices_[index];
+            }
+            return computeMatrix(frameNo, autoOrient);
+        }
+        float opacity(int frameNo) const
         {
             return mOpacity.value(frameNo) / 100.0f;
         }
+        // matrices of the frames the transform changes, see KeyFrames::bake()
+        std::unique_ptr<Timeline::Track> bake(bool autoOrient) const;
+        void setTrack(uint32_t track) { mTrack = track; }
         void createExtraData()
         {
             if (!mExtra) mExtra = std::make_unique<Extra>();
@@ -599,6 +931,16 @@ public:
         Property<VPointF>           mAnchor;            /* "a" */
         Property<float>             mOpacity{100};      /* "o" */
         std::unique_ptr<Extra>      mExtra;
+
+    private:
+        struct Baked : Timeline::Track {
+            std::vector<VMatrix> matrices_;
+            bool                 autoOrient_{false};
+        };
+
+        VMatrix computeMatrix(int frameNo, bool autoOrient) const;
+
+        uint32_t mTrack{Timeline::npos};
     };
 
     Transform() : Object(Object::Type::Transform) {}
@@ -622,6 +964,14 @@ public:
         if (isStatic()) return impl.mStaticData.mOpacity;
         return impl.mData->opacity(frameNo);
     }
+    std::unique_ptr<Timeline::Track> bake(bool autoOrient) const
+    {
+        return isStatic() ? nullptr : impl.mData->bake(autoOrient);
+    }
+    void setTrack(uint32_t track)
+    {
+        if (!isStatic()) impl.mData->setTrack(track);
+    }
     Transform(const Transform &) = delete;
     Transform(Transform &&) = delete;
     Transform &operator=(Transform &) = delete;
@@ -1015,11 +1365,17 @@ public:
         mStart.value() = start;
     }
 
+    // the track of the end keyframes that updateTrimEndValue() rewrites.
+    uint32_t endTrack() const
+    {
+        return mEnd.isStatic() ? Timeline::npos : mEnd.animation().track();
+    }
+
     void updateTrimEndValue(VPointF pos)
     {
-        for (auto &keyFrame : mEnd.animation().frames_) {
-            keyFrame.value_.start_ = pos.x();
-            keyFrame.value_.end_ = pos.y();
+        for (auto &value : mEnd.animation().values()) {
+            value.start_ = pos.x();
+            value.end_ = pos.y();
         }
     }
 
@@ -1139,9 +1495,16 @@ using ColorFilter = std::function<void(float &, float &, float &)>;
 
 void configureModelCacheSize(size_t cacheSize);
 
+// creates the model cache ahead of the objects using it until exit.
+void initModelCache();
+
 std::shared_ptr<model::Composition> loadFromFile(const std::string &filePath,
                                                  bool cachePolicy);
 
+std::shared_ptr<model::Composition> loadFromFile(const std::string &filePath,
+                                                 const std::string &animationId,
+                                                 bool               cachePolicy);
+
 std::shared_ptr<model::Composition> loadFromData(std::string        jsonData,
                                                  const std::string &key,
                                                  std::string resourcePath,
@@ -1151,8 +1514,20 @@ std::shared_ptr<model::Composition> loadFromData(std::string jsonData,
                                                  std::string resourcePath,
                                                  ColorFilter filter);
 
+class DotLottie;
+
 std::shared_ptr<model::Composition> parse(char *str, size_t length, std::string dir_path,
-                                          ColorFilter filter = {});
+                                          ColorFilter filter = {},
+                                          DotLottie * archive = nullptr);
+
+// parses a json file in chunks, embedded base64 images are decoded on the fly.
+std::shared_ptr<model::Composition> parseStream(std::istream &stream,
+                                                std::string   dir_path);
+
+std::shared_ptr<model::Composition> parseDotLottie(DotLottie &        archive,
+                                                   const std::string &animationId,
+                                                   std::string        dir_path,
+                                                   ColorFilter        filter = {});
 
 }  // namespace model
 
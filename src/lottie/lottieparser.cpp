@@ -54,10 +54,13 @@
 // the parse.
 
 #include <array>
+#include <istream>
 
+#include "lottiedotlottie.h"
 #include "lottiemodel.h"
 #include "rapidjson/document.h"
-#include "zip/zip.h"
+#include "vbase64.h"
+#include "vtaskscheduler.h"
 
 RAPIDJSON_DIAG_PUSH
 #ifdef __GNUC__
@@ -172,23 +175,49 @@ protected:
     LookaheadParsingState st_;
     Reader                r_;
     InsituStringStream    ss_;
+    // set for the subtree parsers of the parallel loader, the input
+    // continues after the value so stop once the value is complete.
+    bool                  mStopWhenDone{false};
 
     static const int parseFlags = kParseDefaultFlags | kParseInsituFlag;
 };
 
 class LottieParserImpl : public LookaheadParserHandler {
 public:
-    LottieParserImpl(char *str, std::string dir_path, model::ColorFilter filter)
+    LottieParserImpl(char *str, std::string dir_path, model::ColorFilter filter,
+                     model::DotLottie *archive)
         : LookaheadParserHandler(str),
           mColorFilter(std::move(filter)),
-          mDirPath(std::move(dir_path))
+          mDirPath(std::move(dir_path)),
+          mArchive(archive)
     {
     }
+    // subtree parser used by parseArrayParallel(), owns its own arena.
+    explicit LottieParserImpl(const LottieParserImpl *parent)
+        : LookaheadParserHandler(nullptr),
+          mColorFilter(parent->mColorFilter),
+          mArena(std::make_unique<VArenaAlloc>(2048)),
+          compRef(parent->compRef),
+          mDirPath(parent->mDirPath),
+          mArchive(parent->mArchive),
+          mStreamedImages(parent->mStreamedImages)
+    {
+        mStopWhenDone = true;
+    }
     bool VerifyType();
     bool ParseNext();
+    void Reset(char *str);
+    void setStreamedImages(
+        const std::vector<std::shared_ptr<const std::string>> *images)
+    {
+        mStreamedImages = images;
+    }
 
 public:
-    VArenaAlloc &allocator() { return compRef->mArenaAlloc; }
+    VArenaAlloc &allocator()
+    {
+        return mArena ? *mArena : compRef->mArenaAlloc;
+    }
     bool         EnterObject();
     bool         EnterArray();
     const char * NextObjectKey();
@@ -227,6 +256,10 @@ public:
     model::Asset *   parseAsset();
     void             parseLayers(model::Composition *comp);
     model::Layer *   parseLayer();
+    template <typename T>
+    bool parseArrayParallel(std::vector<T *> &result,
+                            T *(LottieParserImpl::*parseFn)());
+    void loadImages();
     void             parseMaskProperty(model::Layer *layer);
     void             parseShapesAttr(model::Layer *layer);
     void             parseObject(model::Group *parent);
@@ -272,7 +305,7 @@ public:
     bool parseKeyFrameValue(const char *                      key,
                             model::Value<T, model::Position> &value);
     template <typename T, typename Tag>
-    void parseKeyFrame(model::KeyFrames<T, Tag> &obj);
+    void parseKeyFrame(std::vector<model::KeyFrame<T, Tag>> &list);
     template <typename T>
     void parseProperty(model::Property<T> &obj);
     template <typename T, typename Tag>
@@ -364,12 +397,25 @@ private:
     } mPathInfo;
 
 protected:
+    struct ImageRef {
+        model::Asset *asset{nullptr};
+        const char *  data{nullptr};  // embedded "data:" uri in the json buffer
+        std::string   entry;          // dotLottie archive entry
+        std::string   path;
+    };
     std::unordered_map<std::string, VInterpolator *> mInterpolatorCache;
     std::shared_ptr<model::Composition>              mComposition;
+    std::unique_ptr<VArenaAlloc>                     mArena;
     model::Composition *                             compRef{nullptr};
     model::Layer *                                   curLayerRef{nullptr};
     std::vector<model::Layer *>                      mLayersToUpdate;
+    std::vector<ImageRef>                            mImageRefs;
+    std::vector<model::KeyFrameTimes *>              mTimelines;
+    std::vector<std::pair<model::Transform *, model::Layer *>> mTransformTimelines;
     std::string                                      mDirPath;
+    model::DotLottie *                               mArchive{nullptr};
+    const std::vector<std::shared_ptr<const std::string>> *mStreamedImages{
+        nullptr};
     void                                             SkipOut(int depth);
 };
 
@@ -379,6 +425,13 @@ LookaheadParserHandler::LookaheadParserHandler(char *str)
     r_.IterativeParseInit();
 }
 
+void LottieParserImpl::Reset(char *str)
+{
+    ss_ = InsituStringStream(str);
+    st_ = kInit;
+    r_.IterativeParseInit();
+}
+
 bool LottieParserImpl::VerifyType()
 {
     /* Verify the media type is lottie json.
@@ -393,7 +446,14 @@ bool LottieParserImpl::ParseNext()
         return false;
     }
 
-    if (!r_.IterativeParseNext<parseFlags>(ss_, *this)) {
+    // nothing left to read once the root value is complete.
+    if (r_.IterativeParseComplete()) return true;
+
+    bool ok = mStopWhenDone
+                  ? r_.IterativeParseNext<parseFlags | kParseStopWhenDoneFlag>(
+                        ss_, *this)
+                  : r_.IterativeParseNext<parseFlags>(ss_, *this);
+    if (!ok) {
         vCritical << "Lottie file parsing error";
         st_ = kError;
         return false;
@@ -698,6 +758,15 @@ void LottieParserImpl::parseComposition()
     }
 
     resolveLayerRefs();
+    loadImages();
+    // the transforms take the tracks after the properties.
+    for (size_t i = 0; i < mTimelines.size(); i++)
+        mTimelines[i]->setTrack(uint32_t(i));
+    for (size_t i = 0; i < mTransformTimelines.size(); i++)
+        mTransformTimelines[i].first->setTrack(
+            uint32_t(mTimelines.size() + i));
+    comp->mTimelines = std::move(mTimelines);
+    comp->mTransformTimelines = std::move(mTransformTimelines);
     comp->setStatic(comp->mRootLayer->isStatic());
     comp->mRootLayer->mInFrame = comp->mStartFrame;
     comp->mRootLayer->mOutFrame = comp->mEndFrame;
@@ -741,60 +810,148 @@ void LottieParserImpl::parseMarkers()
 
 void LottieParserImpl::parseAssets(model::Composition *composition)
 {
-    EnterArray();
-    while (NextArrayValue()) {
-        auto asset = parseAsset();
-        composition->mAssets[asset->mRefId] = asset;
+    std::vector<model::Asset *> assets;
+    if (!parseArrayParallel(assets, &LottieParserImpl::parseAsset)) {
+        EnterArray();
+        while (NextArrayValue()) {
+            assets.push_back(parseAsset());
+        }
+    }
+    for (auto asset : assets) {
+        if (asset) composition->mAssets[asset->mRefId] = asset;
     }
     // update the precomp layers with the actual layer object
 }
 
-static constexpr const unsigned char B64index[256] = {
-    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-    0,  0,  0,  0,  0,  0,  0,  62, 63, 62, 62, 63, 52, 53, 54, 55, 56, 57,
-    58, 59, 60, 61, 0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  3,  4,  5,  6,
-    7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
-    25, 0,  0,  0,  0,  63, 0,  26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
-    37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51};
+/*
+ * Structural scan used by the parallel loader. Walks the array whose
+ * content starts at str (just after the '[') and records the first byte of
+ * every element. Returns the position of the closing ']', or nullptr when
+ * the array is not terminated.
+ */
+static char *scanArray(char *str, std::vector<char *> &elements)
+{
+    int  depth = 0;
+    bool pending = true;
+    for (char *p = str; *p; ++p) {
+        char c = *p;
+        if (c == ' ' || c == '\n' || c == '\r' || c == '\t') continue;
+
+        if (depth == 0) {
+            if (c == ']') return p;
+            if (c == ',') {
+                pending = true;
+                continue;
+            }
+            if (pending) {
+                elements.push_back(p);
+                pending = false;
+            }
+        }
+
+        if (c == '"') {
+            for (++p; *p && *p != '"'; ++p) {
+                if (*p == '\\' && p[1]) ++p;
+            }
+            if (!*p) return nullptr;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth < 0) return nullptr;
+        }
+    }
+    return nullptr;
+}
 
-std::string b64decode(const char *data, const size_t len)
+/*
+ * Parse the elements of the array at the current position on the shared
+ * task scheduler. The elements are split in contiguous chunks of roughly
+ * equal byte size and every chunk is parsed by its own subtree parser
+ * into its own arena, which is handed over to the composition afterwards.
+ * The main stream is then moved to the closing ']' so the reader sees an
+ * empty array and never touches the bytes owned by the workers.
+ * Returns false when the array should be parsed serially.
+ */
+template <typename T>
+bool LottieParserImpl::parseArrayParallel(std::vector<T *> &result,
+                                          T *(LottieParserImpl::*parseFn)())
 {
-    auto         p = reinterpret_cast<const unsigned char *>(data);
-    int          pad = len > 0 && (len % 4 || p[len - 1] == '=');
-    const size_t L = ((len + 3) / 4 - pad) * 4;
-    std::string  str(L / 4 * 3 + pad, '\0');
+    static constexpr size_t parallelParseMinSize = 32 * 1024;
 
-    for (size_t i = 0, j = 0; i < L; i += 4) {
-        int n = B64index[p[i]] << 18 | B64index[p[i + 1]] << 12 |
-                B64index[p[i + 2]] << 6 | B64index[p[i + 3]];
-        str[j++] = n >> 16;
-        str[j++] = n >> 8 & 0xFF;
-        str[j++] = n & 0xFF;
-    }
-    if (pad) {
-        int n = B64index[p[L]] << 18 | B64index[p[L + 1]] << 12;
-        str[str.size() - 1] = n >> 16;
+    auto &scheduler = VTaskScheduler::instance();
 
-        if (len > L + 2 && p[L + 2] != '=') {
-            n |= B64index[p[L + 2]] << 6;
-            str.push_back(n >> 8 & 0xFF);
-        }
-    }
-    return str;
+    // the color filter is a user callback, don't call it from workers.
+    if (mStopWhenDone || mColorFilter || st_ != kEnteringArray ||
+        scheduler.concurrency() < 2)
+        return false;
+
+    std::vector<char *> elements;
+    char *              end = scanArray(ss_.src_, elements);
+    if (!end || elements.size() < 2 ||
+        size_t(end - ss_.src_) < parallelParseMinSize)
+        return false;
+
+    auto                size = elements.size();
+    auto                total = size_t(end - ss_.src_);
+    auto                chunks = std::min<size_t>(scheduler.concurrency(), size);
+    std::vector<size_t> first(chunks + 1, size);
+    first[0] = 0;
+    for (size_t i = 1, c = 1; i < size && c < chunks; i++) {
+        if (size_t(elements[i] - ss_.src_) >= total * c / chunks)
+            first[c++] = i;
+    }
+
+    result.resize(size, nullptr);
+    std::vector<std::unique_ptr<LottieParserImpl>> workers(chunks);
+    scheduler.parallelFor(chunks, [&](size_t c) {
+        if (first[c] >= first[c + 1]) return;
+        auto worker = std::make_unique<LottieParserImpl>(this);
+        for (size_t i = first[c]; i < first[c + 1]; i++) {
+            worker->Reset(elements[i]);
+            if (!worker->ParseNext()) break;
+            result[i] = ((*worker).*parseFn)();
+            if (!worker->IsValid()) break;
+        }
+        workers[c] = std::move(worker);
+    });
+
+    for (auto &worker : workers) {
+        if (!worker) continue;
+        if (!worker->IsValid()) Error();
+        mLayersToUpdate.insert(mLayersToUpdate.end(),
+                               worker->mLayersToUpdate.begin(),
+                               worker->mLayersToUpdate.end());
+        std::move(worker->mImageRefs.begin(), worker->mImageRefs.end(),
+                  std::back_inserter(mImageRefs));
+        mTimelines.insert(mTimelines.end(), worker->mTimelines.begin(),
+                          worker->mTimelines.end());
+        mTransformTimelines.insert(mTransformTimelines.end(),
+                                   worker->mTransformTimelines.begin(),
+                                   worker->mTransformTimelines.end());
+        compRef->mArenaList.push_back(std::move(worker->mArena));
+    }
+
+    ss_.src_ = end;
+    ParseNext();
+    NextArrayValue();
+    return true;
 }
 
-static std::string convertFromBase64(const std::string &str)
+// reference left in the json by the ChunkedReader for a decoded image.
+static const char streamedImagePrefix[] = "data:rlottie/stream,";
+
+static std::shared_ptr<const std::string> convertFromBase64(const char *str)
 {
     // usual header look like "data:image/png;base64,"
     // so need to skip till ','.
-    size_t startIndex = str.find(",", 0);
-    startIndex += 1;  // skip ","
-    size_t length = str.length() - startIndex;
-
-    const char *b64Data = str.c_str() + startIndex;
+    const char *b64Data = strchr(str, ',');
+    b64Data = b64Data ? b64Data + 1 : str;  // skip ","
 
-    return b64decode(b64Data, length);
+    // decode straight into the buffer kept by the asset.
+    auto len = strlen(b64Data);
+    auto data = std::make_shared<std::string>(vBase64DecodedSize(len), '\0');
+    data->resize(vBase64Decode(b64Data, len, reinterpret_cast<uint8_t *>(&(*data)[0])));
+    return data;
 }
 
 /*
@@ -817,7 +974,7 @@ static std::string toString(const T &value)
 model::Asset *LottieParserImpl::parseAsset()
 {
     auto        asset = allocator().make<model::Asset>();
-    std::string filename;
+    const char *filename = nullptr;
     std::string relativePath;
     bool        embededResource = false;
     EnterObject();
@@ -828,7 +985,7 @@ model::Asset *LottieParserImpl::parseAsset()
             asset->mHeight = GetInt();
         } else if (0 == strcmp(key, "p")) { /* image name */
             asset->mAssetType = model::Asset::Type::Image;
-            filename = GetStringObject();
+            filename = GetString();
         } else if (0 == strcmp(key, "u")) { /* relative image path */
             relativePath = GetStringObject();
         } else if (0 == strcmp(key, "e")) { /* relative image path */
@@ -859,29 +1016,80 @@ model::Asset *LottieParserImpl::parseAsset()
         }
     }
 
-    if (asset->mAssetType == model::Asset::Type::Image) {
+    // image sources are resolved once the whole document is parsed, see loadImages()
+    if (asset->mAssetType == model::Asset::Type::Image && filename) {
+        ImageRef image;
+        image.asset = asset;
         if (embededResource) {
             // embeder resource should start with "data:"
-            if (filename.compare(0, 5, "data:") == 0) {
-                asset->loadImageData(convertFromBase64(filename));
+            if (strncmp(filename, "data:", 5) == 0) {
+                image.data = filename;
+                mImageRefs.push_back(std::move(image));
             }
         } else {
-            asset->loadImagePath(mDirPath + relativePath + filename);
+            if (mArchive) {
+                // archive entries never start with a '/'
+                image.entry = relativePath + filename;
+                if (image.entry[0] == '/') image.entry.erase(0, 1);
+            }
+            image.path = mDirPath + relativePath + filename;
+            mImageRefs.push_back(std::move(image));
         }
     }
 
     return asset;
 }
 
+/*
+ * Resolve the image sources on the task scheduler. The embedded data still
+ * points into the json buffer which outlives the parser, so the base64 is
+ * decoded here and kept with the archive entries in compressed form.
+ * The images themselves are decoded on first draw (model::Asset::bitmap()).
+ */
+void LottieParserImpl::loadImages()
+{
+    VTaskScheduler::instance().parallelFor(mImageRefs.size(), [this](size_t i) {
+        const auto &image = mImageRefs[i];
+        if (image.data) {
+            if (mStreamedImages &&
+                strncmp(image.data, streamedImagePrefix,
+                        sizeof(streamedImagePrefix) - 1) == 0) {
+                auto index = size_t(
+                    atol(image.data + sizeof(streamedImagePrefix) - 1));
+                // a failed image is left without data, as a missing file.
+                if (index < mStreamedImages->size() &&
+                    (*mStreamedImages)[index])
+                    image.asset->setImageData((*mStreamedImages)[index]);
+                return;
+            }
+            image.asset->setImageData(convertFromBase64(image.data));
+            return;
+        }
+        if (!image.entry.empty()) {
+            if (auto data = mArchive->entry(image.entry)) {
+                image.asset->setImageData(std::move(data));
+                return;
+            }
+        }
+        image.asset->setImagePath(image.path);
+    });
+    mImageRefs.clear();
+}
+
 void LottieParserImpl::parseLayers(model::Composition *comp)
 {
     comp->mRootLayer = allocator().make<model::Layer>();
     comp->mRootLayer->mLayerType = model::Layer::Type::Precomp;
     comp->mRootLayer->setName("__");
+    std::vector<model::Layer *> layers;
+    if (!parseArrayParallel(layers, &LottieParserImpl::parseLayer)) {
+        EnterArray();
+        while (NextArrayValue()) {
+            layers.push_back(parseLayer());
+        }
+    }
     bool staticFlag = true;
-    EnterArray();
-    while (NextArrayValue()) {
-        auto layer = parseLayer();
+    for (auto layer : layers) {
         if (layer) {
             staticFlag = staticFlag && layer->isStatic();
             comp->mRootLayer->mChildren.push_back(layer);
@@ -1008,6 +1216,8 @@ model::Layer *LottieParserImpl::parseLayer()
         } else if (0 == strcmp(key, "ks")) {
             EnterObject();
             layer->mTransform = parseTransformObject(ddd);
+            if (layer->mTransform && !layer->mTransform->isStatic())
+                mTransformTimelines.emplace_back(layer->mTransform, layer);
         } else if (0 == strcmp(key, "shapes")) {
             parseShapesAttr(layer);
         } else if (0 == strcmp(key, "w")) {
@@ -1155,7 +1365,10 @@ model::Object *LottieParserImpl::parseObjectTypeAttr()
     }  else if (0 == strcmp(type, "el")) {
         return parseEllipseObject();
     } else if (0 == strcmp(type, "tr")) {
-        return parseTransformObject();
+        auto transform = parseTransformObject();
+        if (transform && !transform->isStatic())
+            mTransformTimelines.emplace_back(transform, nullptr);
+        return transform;
     } else if (0 == strcmp(type, "fl")) {
         return parseFillObject();
     } else if (0 == strcmp(type, "st")) {
@@ -1495,11 +1708,9 @@ model::Repeater *LottieParserImpl::parseReapeaterObject()
             parseProperty(obj->mCopies);
             float maxCopy = 0.0;
             if (!obj->mCopies.isStatic()) {
-                for (auto &keyFrame : obj->mCopies.animation().frames_) {
-                    if (maxCopy < keyFrame.value_.start_)
-                        maxCopy = keyFrame.value_.start_;
-                    if (maxCopy < keyFrame.value_.end_)
-                        maxCopy = keyFrame.value_.end_;
+                for (auto &value : obj->mCopies.animation().values()) {
+                    if (maxCopy < value.start_) maxCopy = value.start_;
+                    if (maxCopy < value.end_) maxCopy = value.end_;
                 }
             } else {
                 maxCopy = obj->mCopies.value();
@@ -2000,6 +2211,10 @@ VInterpolator *LottieParserImpl::interpolator(VPointF     inTangent,
     }
 
     auto obj = allocator().make<VInterpolator>(outTangent, inTangent);
+#ifdef LOTTIE_EASING_LUT_SUPPORT
+    // the interpolators are shared, sample them once at load time.
+    obj->buildTable();
+#endif
     mInterpolatorCache[std::move(key)] = obj;
     return obj;
 }
@@ -2008,7 +2223,7 @@ VInterpolator *LottieParserImpl::interpolator(VPointF     inTangent,
  * https://github.com/airbnb/lottie-web/blob/master/docs/json/properties/multiDimensionalKeyframed.json
  */
 template <typename T, typename Tag>
-void LottieParserImpl::parseKeyFrame(model::KeyFrames<T, Tag> &obj)
+void LottieParserImpl::parseKeyFrame(std::vector<model::KeyFrame<T, Tag>> &list)
 {
     struct ParsedField {
         std::string interpolatorKey;
@@ -2020,7 +2235,7 @@ void LottieParserImpl::parseKeyFrame(model::KeyFrames<T, Tag> &obj)
 
     EnterObject();
     ParsedField                              parsed;
-    typename model::KeyFrames<T, Tag>::Frame keyframe;
+    model::KeyFrame<T, Tag>                  keyframe;
     VPointF                                  inTangent;
     VPointF                                  outTangent;
 
@@ -2068,7 +2283,6 @@ void LottieParserImpl::parseKeyFrame(model::KeyFrames<T, Tag> &obj)
         }
     }
 
-    auto &list = obj.frames_;
     if (!list.empty()) {
         // update the endFrame value of current keyframe
         list.back().end_ = keyframe.start_;
@@ -2100,13 +2314,14 @@ void LottieParserImpl::parseKeyFrame(model::KeyFrames<T, Tag> &obj)
  */
 void LottieParserImpl::parseShapeProperty(model::Property<model::PathData> &obj)
 {
+    std::vector<model::KeyFrame<model::PathData, void>> frames;
     EnterObject();
     while (const char *key = NextObjectKey()) {
         if (0 == strcmp(key, "k")) {
             if (PeekType() == kArrayType) {
                 EnterArray();
                 while (NextArrayValue()) {
-                    parseKeyFrame(obj.animation());
+                    parseKeyFrame(frames);
                 }
             } else {
                 if (!obj.isStatic()) {
@@ -2122,7 +2337,10 @@ void LottieParserImpl::parseShapeProperty(model::Property<model::PathData> &obj)
             Skip(nullptr);
         }
     }
-    obj.cache();
+    if (frames.empty()) return;
+
+    obj.animation().cache(std::move(frames), allocator());
+    mTimelines.push_back(&obj.animation());
 }
 
 template <typename T, typename Tag>
@@ -2136,11 +2354,12 @@ void LottieParserImpl::parsePropertyHelper(model::Property<T, Tag> &obj)
         /*single value property with no animation*/
         getValue(obj.value());
     } else {
+        std::vector<model::KeyFrame<T, Tag>> frames;
         EnterArray();
         while (NextArrayValue()) {
             /* property with keyframe info*/
             if (PeekType() == kObjectType) {
-                parseKeyFrame(obj.animation());
+                parseKeyFrame(frames);
             } else {
                 /* Read before modifying.
                  * as there is no way of knowing if the
@@ -2148,7 +2367,7 @@ void LottieParserImpl::parsePropertyHelper(model::Property<T, Tag> &obj)
                  * or array of object without entering the array
                  * thats why this hack is there
                  */
-                if (!obj.isStatic()) {
+                if (!obj.isStatic() || !frames.empty()) {
                     st_ = kError;
                     return;
                 }
@@ -2158,7 +2377,10 @@ void LottieParserImpl::parsePropertyHelper(model::Property<T, Tag> &obj)
                 break;
             }
         }
-        obj.cache();
+        if (frames.empty()) return;
+
+        obj.animation().cache(std::move(frames), allocator());
+        mTimelines.push_back(&obj.animation());
     }
 }
 
@@ -2366,73 +2588,271 @@ public:
 
 #endif
 
-static char* uncompressZip(const char * str, size_t length)
+static std::shared_ptr<model::Composition> parseDocument(LottieParserImpl &obj)
 {
-    const char* errMsg = "Failed to unzip dotLottie!";
+    if (obj.VerifyType()) {
+        obj.parseComposition();
+        auto composition = obj.composition();
+        if (composition) {
+            composition->processRepeaterObjects();
+            composition->updateStats();
 
-    auto zip = zip_stream_open(str, length, 0, 'r');
-    if (!zip) {
-        vCritical << errMsg;
-        return nullptr;
-    }
+#ifdef LOTTIE_DUMP_TREE_SUPPORT
+            ObjectInspector inspector;
+            inspector.visit(composition.get(), "");
+#endif
 
-    //Read a representive animation
-    if (zip_entry_openbyindex(zip, 1)) {
-        vCritical << errMsg;
-        return nullptr;
+            return composition;
+        }
     }
 
-    char* buf = nullptr;
-    size_t bufSize;
-    zip_entry_read(zip, (void**)&buf, &bufSize);
-
-    zip_entry_close(zip);
-    zip_stream_close(zip);
-
-    return buf;
-}
-
-static bool checkDotLottie(const char * str)
-{
-    //check the .Lottie signature.
-    if (str[0] == 0x50 && str[1] == 0x4B && str[2] == 0x03 && str[3] == 0x04) return true;
-    else return false;
+    vWarning << "Input data is not Lottie format!";
+    return {};
 }
 
 std::shared_ptr<model::Composition> model::parse(char *             str,
                                                  size_t             length,
                                                  std::string        dir_path,
-                                                 model::ColorFilter filter)
+                                                 model::ColorFilter filter,
+                                                 model::DotLottie * archive)
 {
-    auto input = str;
+    if (!archive && model::DotLottie::isDotLottie(str, length)) {
+        // the caller keeps the archive bytes alive during the parsing.
+        auto dotLottie = model::DotLottie::open(str, length);
+        if (!dotLottie) return {};
+        return parseDotLottie(*dotLottie, {}, std::move(dir_path),
+                              std::move(filter));
+    }
+
+    LottieParserImpl obj(str, std::move(dir_path), std::move(filter), archive);
 
-    auto dotLottie = checkDotLottie(str);
-    if (dotLottie) {
-        input = uncompressZip(str, length);
+    return parseDocument(obj);
+}
+
+/*
+ * Chunked reader for large files. The file is consumed in fixed-size blocks
+ * and copied into the json buffer, except for the embedded base64 images
+ * ("data:...;base64,..." values of an asset "p" key) which are streamed
+ * straight into the decoder. Those values are replaced by a short reference
+ * (streamedImagePrefix + index) resolved in loadImages(), so the buffer the
+ * insitu parser needs is about the size of the model and the images are
+ * never kept in base64 form.
+ */
+class ChunkedReader {
+public:
+    using Images = std::vector<std::shared_ptr<const std::string>>;
+
+    bool read(std::istream &in)
+    {
+        std::unique_ptr<char[]> block(new char[blockSize]);
+        while (in) {
+            in.read(block.get(), blockSize);
+            auto count = size_t(in.gcount());
+            if (count) feed(block.get(), count);
+        }
+        if (mState == State::Base64) endImage();
+        return !mJson.empty();
     }
 
-    LottieParserImpl obj(input, std::move(dir_path), std::move(filter));
+    std::string &json() { return mJson; }
+    Images &     images() { return mImages; }
 
-    if (dotLottie) free(input);
+private:
+    enum class State { Json, Prefix, String, Base64 };
 
-    if (obj.VerifyType()) {
-        obj.parseComposition();
-        auto composition = obj.composition();
-        if (composition) {
-            composition->processRepeaterObjects();
-            composition->updateStats();
+    void feed(const char *data, size_t len)
+    {
+        const char *end = data + len;
+        while (data < end) {
+            switch (mState) {
+            case State::Json: {
+                auto quote = static_cast<const char *>(memchr(data, '"', end - data));
+                auto last = quote ? quote + 1 : end;
+                mJson.append(data, last);
+                data = last;
+                if (quote) {
+                    mState = State::Prefix;
+                    mImageValue = imageValue();
+                    mPrefix.clear();
+                }
+                break;
+            }
+            case State::Prefix:
+                prefix(*data++);
+                break;
+            case State::String:
+                for (; data < end && mState == State::String; data++) {
+                    mJson.push_back(*data);
+                    if (mEscape) {
+                        mEscape = false;
+                    } else if (*data == '\\') {
+                        mEscape = true;
+                    } else if (*data == '"') {
+                        mKey.clear();
+                        mState = State::Json;
+                    }
+                }
+                break;
+            case State::Base64:
+                for (; data < end && mState == State::Base64; data++) {
+                    if (mEscape) {
+                        mEscape = false;
+                        mPending.push_back(*data);  // "\/"
+                    } else if (*data == '\\') {
+                        mEscape = true;
+                    } else if (*data == '"') {
+                        endImage();
+                        mJson.push_back('"');
+                        mState = State::Json;
+                    } else {
+                        mPending.push_back(*data);
+                    }
+                }
+                if (mPending.size() >= blockSize) decodePending();
+                break;
+            }
+        }
+    }
 
-#ifdef LOTTIE_DUMP_TREE_SUPPORT
-            ObjectInspector inspector;
-            inspector.visit(composition.get(), "");
-#endif
+    // decides from the first characters if the string is a base64 image.
+    void prefix(char c)
+    {
+        if (mEscape) {
+            mEscape = false;
+            mPrefix.push_back(c);
+            return;
+        }
+        if (c == '"') {
+            mJson.append(mPrefix).push_back('"');
+            mKey = mPrefix;
+            mState = State::Json;
+            return;
+        }
+        mPrefix.push_back(c);
+        if (c == '\\') {
+            mEscape = true;
+            return;
+        }
 
-            return composition;
+        static const char   dataScheme[] = "data:";
+        static const char   base64Tag[] = ";base64,";
+        static const size_t tagLength = sizeof(base64Tag) - 1;
+
+        auto size = mPrefix.size();
+        bool image = mImageValue &&
+                     mPrefix.compare(0, std::min<size_t>(size, 5), dataScheme,
+                                     std::min<size_t>(size, 5)) == 0;
+        if (image && c == ',') {
+            if (size >= tagLength &&
+                mPrefix.compare(size - tagLength, tagLength, base64Tag) == 0) {
+                beginImage();
+                return;
+            }
+            image = false;
+        }
+        // a single character is kept until the quote, it may be the "p" key.
+        if ((!image && size > 1) || size >= maxPrefixLength) {
+            mJson.append(mPrefix);
+            mState = State::String;
         }
     }
 
-    vWarning << "Input data is not Lottie format!";
-    return {};
+    /*
+     * only the value of a "p" key holds an image, a name or a text starting
+     * with a data url stays in the json. The opening quote was just added,
+     * the key is the last string if a ':' is in between.
+     */
+    bool imageValue() const
+    {
+        if (mKey != "p") return false;
+        for (size_t i = mJson.size() - 1; i-- > 0;) {
+            char c = mJson[i];
+            if (c == ':') return true;
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') return false;
+        }
+        return false;
+    }
+
+    void beginImage()
+    {
+        mJson.append(streamedImagePrefix).append(std::to_string(mImages.size()));
+        mImage = std::make_shared<std::string>();
+        mPending.clear();
+        mFailed = false;
+        mState = State::Base64;
+    }
+
+    /*
+     * decode the complete quads but always keep the tail (and a trailing
+     * '='), the padding rules only apply at the end of the string.
+     */
+    void decodePending()
+    {
+        size_t count = (mPending.size() - 1) / 4 * 4;
+        while (count && mPending[count - 1] == '=') count -= 4;
+        if (!count) return;
+
+        auto offset = mImage->size();
+        mImage->resize(offset + count / 4 * 3);
+        if (vBase64Decode(mPending.data(), count,
+                          reinterpret_cast<uint8_t *>(&(*mImage)[offset])) !=
+            count / 4 * 3)
+            mFailed = true;
+        mPending.erase(0, count);
+    }
+
+    // a tail of a single character (after the padding) holds no byte.
+    void endImage()
+    {
+        if (!mPending.empty()) decodePending();
+
+        size_t length = mPending.size();
+        while (length && mPending[length - 1] == '=') length--;
+        if (length % 4 == 1) mFailed = true;
+
+        auto offset = mImage->size();
+        mImage->resize(offset + vBase64DecodedSize(mPending.size()));
+        auto count = vBase64Decode(mPending.data(), mPending.size(),
+                                   reinterpret_cast<uint8_t *>(&(*mImage)[offset]));
+        if (count != length / 4 * 3 + (length % 4 ? length % 4 - 1 : 0))
+            mFailed = true;
+
+        if (mFailed) {
+            vWarning << "Embedded image " << mImages.size()
+                     << " is not valid base64!";
+            mImage.reset();
+        } else {
+            mImage->resize(offset + count);
+        }
+        mImages.push_back(std::move(mImage));
+        mPending.clear();
+    }
+
+    static const size_t blockSize = 64 * 1024;
+    static const size_t maxPrefixLength = 128;
+
+    std::string                  mJson;
+    std::string                  mPrefix;
+    std::string                  mKey;
+    std::string                  mPending;
+    std::shared_ptr<std::string> mImage;
+    Images                       mImages;
+    State                        mState{State::Json};
+    bool                         mEscape{false};
+    bool                         mImageValue{false};
+    bool                         mFailed{false};
+};
+
+std::shared_ptr<model::Composition> model::parseStream(std::istream &stream,
+                                                       std::string   dir_path)
+{
+    ChunkedReader reader;
+    if (!reader.read(stream)) return {};
+
+    LottieParserImpl obj(&reader.json()[0], std::move(dir_path), {}, nullptr);
+    obj.setStreamedImages(&reader.images());
+
+    return parseDocument(obj);
 }
 
 RAPIDJSON_DIAG_POP
@@ -235,6 +235,32 @@ int zip_entry_openbyindex(struct zip_t *zip, size_t index) {
   return 0;
 }
 
+int zip_entry_open(struct zip_t *zip, const char *entryname) {
+  int index;
+
+  if (!zip) {
+    // zip_t handler is not initialized
+    return ZIP_ENOINIT;
+  }
+
+  if (!entryname) {
+    return ZIP_EINVENTNAME;
+  }
+
+  if (zip->archive.m_zip_mode != MZ_ZIP_MODE_READING) {
+    // only the readonly mode is supported
+    return ZIP_EINVMODE;
+  }
+
+  index = mz_zip_reader_locate_file(&(zip->archive), entryname, NULL,
+                                    MZ_ZIP_FLAG_CASE_SENSITIVE);
+  if (index < 0) {
+    return ZIP_ENOENT;
+  }
+
+  return zip_entry_openbyindex(zip, (size_t)index);
+}
+
 int zip_entry_close(struct zip_t *zip) {
   mz_zip_archive *pzip = NULL;
   mz_uint level;
@@ -406,6 +432,42 @@ ssize_t zip_entry_read(struct zip_t *zip, void **buf, size_t *bufsize) {
   return (ssize_t)size;
 }
 
+unsigned long long zip_entry_size(struct zip_t *zip) {
+  return zip ? zip->entry.uncomp_size : 0;
+}
+
+ssize_t zip_entry_noallocread(struct zip_t *zip, void *buf, size_t bufsize) {
+  mz_zip_archive *pzip = NULL;
+
+  if (!zip) {
+    // zip_t handler is not initialized
+    return (ssize_t)ZIP_ENOINIT;
+  }
+
+  pzip = &(zip->archive);
+  if (pzip->m_zip_mode != MZ_ZIP_MODE_READING ||
+      zip->entry.index < (ssize_t)0) {
+    // the entry is not found or we do not have read access
+    return (ssize_t)ZIP_ENOENT;
+  }
+
+  if (!mz_zip_reader_extract_to_mem_no_alloc(pzip, (mz_uint)zip->entry.index,
+                                             buf, bufsize, 0, NULL, 0)) {
+    return (ssize_t)ZIP_EMEMNOALLOC;
+  }
+
+  return (ssize_t)zip->entry.uncomp_size;
+}
+
+ssize_t zip_entries_total(struct zip_t *zip) {
+  if (!zip) {
+    // zip_t handler is not initialized
+    return ZIP_ENOINIT;
+  }
+
+  return (ssize_t)zip->archive.m_total_files;
+}
+
 struct zip_t *zip_stream_open(const char *stream, size_t size, int level,
                               char mode) {
   struct zip_t *zip = (struct zip_t *)calloc((size_t)1, sizeof(struct zip_t));
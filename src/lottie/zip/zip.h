@@ -91,6 +91,15 @@ void zip_close(struct zip_t *zip);
  */
 int zip_entry_openbyindex(struct zip_t *zip, size_t index);
 
+/**
+ * Opens an entry by name in the zip archive.
+ * This function is only valid if zip archive was opened in 'r' (readonly) mode.
+ * @param zip zip archive handler.
+ * @param entryname an entry name in local dictionary.
+ * @return the return code - 0 on success, negative number (< 0) on error.
+ */
+int zip_entry_open(struct zip_t *zip, const char *entryname);
+
 /**
  * Closes a zip entry, flushes buffer and releases resources.
  *
@@ -133,6 +142,36 @@ const char *zip_entry_name(struct zip_t *zip);
  */
 ssize_t zip_entry_read(struct zip_t *zip, void **buf,
                                          size_t *bufsize);
+/**
+ * Returns an uncompressed size of the current zip entry.
+ * @param zip zip archive handler.
+ * @return the uncompressed size in bytes.
+ */
+unsigned long long zip_entry_size(struct zip_t *zip);
+
+/**
+ * Extracts the current zip entry into a memory buffer using no memory
+ * allocation.
+ * @param zip zip archive handler.
+ * @param buf preallocated output buffer.
+ * @param bufsize output buffer size (in bytes).
+ * @note ensure supplied output buffer is large enough.
+ *       zip_entry_size function returns uncompressed size for the current
+ *       entry which can be handy to estimate how big buffer is needed.
+ * @return the return code - the number of bytes actually read on success.
+ *         Otherwise a negative number (< 0) on error (e.g. bufsize is not large
+ *         enough).
+ */
+ssize_t zip_entry_noallocread(struct zip_t *zip, void *buf, size_t bufsize);
+
+/**
+ * Returns the number of all entries (files and directories) in the zip archive.
+ * @param zip zip archive handler.
+ * @return the return code - the number of entries on success, negative number
+ *         (< 0) on error.
+ */
+ssize_t zip_entries_total(struct zip_t *zip);
+
 /**
  * Opens zip archive stream into memory.
  *
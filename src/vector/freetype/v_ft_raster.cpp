@@ -308,8 +308,9 @@ typedef struct gray_TWorker_ {
     SW_FT_Vector bez_stack[32 * 3 + 1];
     int          lev_stack[32];
 
-    SW_FT_Outline outline;
-    SW_FT_BBox    clip_box;
+    SW_FT_Outline     outline;
+    const SW_FT_Path* path;
+    SW_FT_BBox        clip_box;
 
     int           bound_left;
     int           bound_top;
@@ -377,12 +378,71 @@ static void gray_init_cells(RAS_ARG_ void* buffer, long byte_size)
 /*                                                                       */
 /* Compute the outline bounding box.                                     */
 /*                                                                       */
+/* to 26.6, the same truncation the outline conversion used to do. */
+#define PATH_COORD(x) ((TPos)((x)*64))
+
+static int gray_path_points(const SW_FT_Path* path)
+{
+    int i, count = 0;
+
+    for (i = 0; i < path->n_elements; i++) {
+        switch (path->elements[i]) {
+        case SW_FT_PATH_MOVE_TO:
+        case SW_FT_PATH_LINE_TO:
+            count++;
+            break;
+        case SW_FT_PATH_CUBIC_TO:
+            count += 3;
+            break;
+        default:
+            break;
+        }
+    }
+    return count;
+}
+
+static void gray_compute_path_cbox(RAS_ARG)
+{
+    const float* pt = ras.path->points;
+    const float* limit = pt + 2 * gray_path_points(ras.path);
+
+    if (pt == limit) {
+        ras.min_ex = ras.max_ex = 0;
+        ras.min_ey = ras.max_ey = 0;
+        return;
+    }
+
+    ras.min_ex = ras.max_ex = PATH_COORD(pt[0]);
+    ras.min_ey = ras.max_ey = PATH_COORD(pt[1]);
+
+    for (pt += 2; pt < limit; pt += 2) {
+        TPos x = PATH_COORD(pt[0]);
+        TPos y = PATH_COORD(pt[1]);
+
+        if (x < ras.min_ex) ras.min_ex = x;
+        if (x > ras.max_ex) ras.max_ex = x;
+        if (y < ras.min_ey) ras.min_ey = y;
+        if (y > ras.max_ey) ras.max_ey = y;
+    }
+
+    /* truncate the bounding box to integer pixels */
+    ras.min_ex = ras.min_ex >> 6;
+    ras.min_ey = ras.min_ey >> 6;
+    ras.max_ex = (ras.max_ex + 63) >> 6;
+    ras.max_ey = (ras.max_ey + 63) >> 6;
+}
+
 static void gray_compute_cbox(RAS_ARG)
 {
     SW_FT_Outline* outline = &ras.outline;
     SW_FT_Vector*  vec = outline->points;
     SW_FT_Vector*  limit = vec + outline->n_points;
 
+    if (ras.path) {
+        gray_compute_path_cbox(RAS_VAR);
+        return;
+    }
+
     if (outline->n_points <= 0) {
         ras.min_ex = ras.max_ex = 0;
         ras.min_ey = ras.max_ey = 0;
@@ -1201,12 +1261,78 @@ SW_FT_DEFINE_OUTLINE_FUNCS(func_interface,
                            (SW_FT_Outline_ConicTo_Func)gray_conic_to,
                            (SW_FT_Outline_CubicTo_Func)gray_cubic_to, 0, 0)
 
+/*************************************************************************/
+/*                                                                       */
+/* Walk an SW_FT_Path the way SW_FT_Outline_Decompose walks the outline  */
+/* it used to be converted to: every contour is closed with a line back  */
+/* to its start.                                                         */
+/*                                                                       */
+static int gray_path_decompose(RAS_ARG)
+{
+    const SW_FT_Path* path = ras.path;
+    const float*      pt = path->points;
+    SW_FT_Vector      v_start, vec, vec1, vec2;
+    int               open = 0;
+    int               i;
+
+    v_start.x = v_start.y = 0;
+
+    for (i = 0; i < path->n_elements; i++) {
+        switch (path->elements[i]) {
+        case SW_FT_PATH_MOVE_TO:
+            if (open) gray_line_to(&v_start, RAS_VAR);
+            v_start.x = PATH_COORD(pt[0]);
+            v_start.y = PATH_COORD(pt[1]);
+            pt += 2;
+            gray_move_to(&v_start, RAS_VAR);
+            open = 1;
+            break;
+        case SW_FT_PATH_LINE_TO:
+            vec.x = PATH_COORD(pt[0]);
+            vec.y = PATH_COORD(pt[1]);
+            pt += 2;
+            if (!open) {
+                /* a contour starting without a move_to */
+                v_start = vec;
+                gray_move_to(&v_start, RAS_VAR);
+                open = 1;
+                break;
+            }
+            gray_line_to(&vec, RAS_VAR);
+            break;
+        case SW_FT_PATH_CUBIC_TO:
+            /* a contour cannot start with a cubic control point! */
+            if (!open) return SW_FT_THROW(Invalid_Outline);
+            vec1.x = PATH_COORD(pt[0]);
+            vec1.y = PATH_COORD(pt[1]);
+            vec2.x = PATH_COORD(pt[2]);
+            vec2.y = PATH_COORD(pt[3]);
+            vec.x = PATH_COORD(pt[4]);
+            vec.y = PATH_COORD(pt[5]);
+            pt += 6;
+            gray_cubic_to(&vec1, &vec2, &vec, RAS_VAR);
+            break;
+        default: /* SW_FT_PATH_CLOSE */
+            if (open) gray_line_to(&v_start, RAS_VAR);
+            break;
+        }
+    }
+
+    /* close the contour with a line segment */
+    if (open) gray_line_to(&v_start, RAS_VAR);
+
+    return 0;
+}
+
 static int gray_convert_glyph_inner(RAS_ARG)
 {
     volatile int error = 0;
 
     if (ft_setjmp(ras.jump_buffer) == 0) {
-        error = SW_FT_Outline_Decompose(&ras.outline, &func_interface, &ras);
+        if (ras.path)
+            error = gray_path_decompose(RAS_VAR);
+        else
+            error = SW_FT_Outline_Decompose(&ras.outline, &func_interface, &ras);
         if (!ras.invalid) gray_record_cell(RAS_VAR);
     } else
         error = SW_FT_THROW(Memory_Overflow);
@@ -1336,7 +1462,8 @@ static int gray_raster_render(gray_PRaster               raster,
                               const SW_FT_Raster_Params* params)
 {
     SW_FT_UNUSED(raster);
-    const SW_FT_Outline* outline = (const SW_FT_Outline*)params->source;
+    const SW_FT_Outline* outline = NULL;
+    const SW_FT_Path*    path = NULL;
 
     gray_TWorker worker[1];
 
@@ -1344,16 +1471,31 @@ static int gray_raster_render(gray_PRaster               raster,
     long  buffer_size = sizeof(buffer);
     int   band_size = (int)(buffer_size / (long)(sizeof(TCell) * 8));
 
-    if (!outline) return SW_FT_THROW(Invalid_Outline);
+    if (params->flags & SW_FT_RASTER_FLAG_PATH) {
+        path = (const SW_FT_Path*)params->source;
+
+        if (!path) return SW_FT_THROW(Invalid_Outline);
+
+        /* return immediately if the path is empty */
+        if (path->n_elements <= 0) return 0;
 
-    /* return immediately if the outline is empty */
-    if (outline->n_points == 0 || outline->n_contours <= 0) return 0;
+        if (!path->elements || !path->points)
+            return SW_FT_THROW(Invalid_Outline);
+    } else {
+        outline = (const SW_FT_Outline*)params->source;
+
+        if (!outline) return SW_FT_THROW(Invalid_Outline);
+
+        /* return immediately if the outline is empty */
+        if (outline->n_points == 0 || outline->n_contours <= 0) return 0;
 
-    if (!outline->contours || !outline->points)
-        return SW_FT_THROW(Invalid_Outline);
+        if (!outline->contours || !outline->points)
+            return SW_FT_THROW(Invalid_Outline);
 
-    if (outline->n_points != outline->contours[outline->n_contours - 1] + 1)
-        return SW_FT_THROW(Invalid_Outline);
+        if (outline->n_points !=
+            outline->contours[outline->n_contours - 1] + 1)
+            return SW_FT_THROW(Invalid_Outline);
+    }
 
     /* this version does not support monochrome rendering */
     if (!(params->flags & SW_FT_RASTER_FLAG_AA))
@@ -1370,7 +1512,13 @@ static int gray_raster_render(gray_PRaster               raster,
 
     gray_init_cells(RAS_VAR_ buffer, buffer_size);
 
-    ras.outline = *outline;
+    if (path) {
+        SW_FT_MEM_ZERO(&ras.outline, sizeof(ras.outline));
+        ras.outline.flags = path->flags;
+    } else {
+        ras.outline = *outline;
+    }
+    ras.path = path;
     ras.num_cells = 0;
     ras.invalid = 1;
     ras.band_size = band_size;
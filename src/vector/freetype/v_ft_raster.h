@@ -102,7 +102,7 @@
 /*                                                                       */
 /*                  Bits 3 and~4 are reserved for internal purposes.     */
 /*                                                                       */
-/*    contours   :: An array of `n_contours' shorts, giving the end      */
+/*    contours   :: An array of `n_contours' ints, giving the end        */
 /*                  point of each contour within the outline.  For       */
 /*                  example, the first contour is defined by the points  */
 /*                  `0' to `contours[0]', the second one is defined by   */
@@ -114,12 +114,12 @@
 /*                                                                       */
 typedef struct  SW_FT_Outline_
 {
-  short       n_contours;      /* number of contours in glyph        */
-  short       n_points;        /* number of points in the glyph      */
+  int         n_contours;      /* number of contours in glyph        */
+  int         n_points;        /* number of points in the glyph      */
 
   SW_FT_Vector*  points;          /* the outline's points               */
   char*       tags;            /* the points flags                   */
-  short*      contours;        /* the contour end points             */
+  int*        contours;        /* the contour end points             */
   char*       contours_flag;   /* the contour open flags             */
 
   int         flags;           /* outline masks                      */
@@ -127,6 +127,43 @@ typedef struct  SW_FT_Outline_
 } SW_FT_Outline;
 
 
+/*************************************************************************/
+/*                                                                       */
+/* <Struct>                                                              */
+/*    SW_FT_Path                                                         */
+/*                                                                       */
+/* <Description>                                                         */
+/*    A path in the layout of VPath, rendered and stroked as it is       */
+/*    instead of being converted to an @SW_FT_Outline first.  The points */
+/*    are converted to 26.6 while the path is walked.                    */
+/*                                                                       */
+/* <Fields>                                                              */
+/*    n_elements :: The number of elements in the path.                  */
+/*                                                                       */
+/*    elements   :: The path elements, see @SW_FT_PATH_XXX.  A move_to  */
+/*                  starts a new contour, a close closes the current     */
+/*                  one.                                                 */
+/*                                                                       */
+/*    points     :: The x, y pairs of the elements in pixels, 1 pair for */
+/*                  a move_to or line_to and 3 for a cubic_to.           */
+/*                                                                       */
+/*    flags      :: The fill rule, @SW_FT_OUTLINE_EVEN_ODD_FILL or 0.    */
+/*                                                                       */
+typedef struct  SW_FT_Path_
+{
+  int                   n_elements;
+  const unsigned char*  elements;
+  const float*          points;
+  int                   flags;
+
+} SW_FT_Path;
+
+#define SW_FT_PATH_MOVE_TO   0
+#define SW_FT_PATH_LINE_TO   1
+#define SW_FT_PATH_CUBIC_TO  2
+#define SW_FT_PATH_CLOSE     3
+
+
   /*************************************************************************/
   /*                                                                       */
   /* <Enum>                                                                */
@@ -333,10 +370,14 @@ typedef struct  SW_FT_Outline_
   /*                              in direct rendering mode where all spans */
   /*                              are generated if no clipping box is set. */
   /*                                                                       */
+  /*    SW_FT_RASTER_FLAG_PATH    :: The `source' field is an @SW_FT_Path     */
+  /*                              instead of an @SW_FT_Outline.            */
+  /*                                                                       */
 #define SW_FT_RASTER_FLAG_DEFAULT  0x0
 #define SW_FT_RASTER_FLAG_AA       0x1
 #define SW_FT_RASTER_FLAG_DIRECT   0x2
 #define SW_FT_RASTER_FLAG_CLIP     0x4
+#define SW_FT_RASTER_FLAG_PATH     0x8
 
 
   /*************************************************************************/
@@ -352,7 +393,7 @@ typedef struct  SW_FT_Outline_
   /*    target      :: The target bitmap.                                  */
   /*                                                                       */
   /*    source      :: A pointer to the source glyph image (e.g., an       */
-  /*                   @SW_FT_Outline).                                       */
+  /*                   @SW_FT_Outline or an @SW_FT_Path).                     */
   /*                                                                       */
   /*    flags       :: The rendering flags.                                */
   /*                                                                       */
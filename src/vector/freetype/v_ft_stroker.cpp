@@ -650,8 +650,8 @@ static void ft_stroke_border_export(SW_FT_StrokeBorder border,
     {
         SW_FT_UInt   count = border->num_points;
         SW_FT_Byte*  tags = border->tags;
-        SW_FT_Short* write = outline->contours + outline->n_contours;
-        SW_FT_Short  idx = (SW_FT_Short)outline->n_points;
+        SW_FT_Int* write = outline->contours + outline->n_contours;
+        SW_FT_Int  idx = outline->n_points;
 
         for (; count > 0; count--, tags++, idx++) {
             if (*tags & SW_FT_STROKE_TAG_END) {
@@ -661,7 +661,7 @@ static void ft_stroke_border_export(SW_FT_StrokeBorder border,
         }
     }
 
-    outline->n_points = (short)(outline->n_points + border->num_points);
+    outline->n_points = (SW_FT_Int)(outline->n_points + border->num_points);
 
     assert(SW_FT_Outline_Check(outline) == 0);
 }
@@ -1933,4 +1933,116 @@ Invalid_Outline:
     return -2;  // SW_FT_THROW( Invalid_Outline );
 }
 
+/*
+ *  The same as SW_FT_Stroker_ParseOutline on the outline the path would be
+ *  converted to, a contour runs up to the next move_to and is closed if it
+ *  has a close element.
+ */
+#define PATH_COORD(x) ((SW_FT_Pos)((x)*64))
+
+SW_FT_Error SW_FT_Stroker_ParsePath(SW_FT_Stroker     stroker,
+                                    const SW_FT_Path* path)
+{
+    const unsigned char* element;
+    const unsigned char* end;
+    const float*         pt;
+
+    SW_FT_Error error;
+
+    if (!path || !stroker) return -1;  // SW_FT_THROW( Invalid_Argument );
+
+    SW_FT_Stroker_Rewind(stroker);
+
+    element = path->elements;
+    end = element + path->n_elements;
+    pt = path->points;
+
+    while (element < end) {
+        const unsigned char* last;
+        SW_FT_Vector         v_start;
+        SW_FT_Int            n_points = 0;
+        SW_FT_Bool           opened = 1;
+
+        /* find the extent of the contour */
+        for (last = element; last < end; last++) {
+            if (*last == SW_FT_PATH_MOVE_TO && last != element) break;
+            if (*last == SW_FT_PATH_CUBIC_TO)
+                n_points += 3;
+            else
+                n_points++;
+            if (*last == SW_FT_PATH_CLOSE) opened = 0;
+        }
+
+        /* A contour cannot start with a cubic control point! */
+        if (*element == SW_FT_PATH_CUBIC_TO) return -2;
+
+        v_start.x = PATH_COORD(pt[0]);
+        v_start.y = PATH_COORD(pt[1]);
+
+        /* skip empty points; we don't stroke these */
+        if (n_points <= 1 || *element == SW_FT_PATH_CLOSE) {
+            for (; element < last; element++) {
+                if (*element == SW_FT_PATH_CUBIC_TO)
+                    pt += 6;
+                else if (*element != SW_FT_PATH_CLOSE)
+                    pt += 2;
+            }
+            continue;
+        }
+        pt += 2;
+        element++;
+
+        error = SW_FT_Stroker_BeginSubPath(stroker, &v_start, opened);
+        if (error) goto Exit;
+
+        for (; element < last; element++) {
+            switch (*element) {
+            case SW_FT_PATH_CUBIC_TO: {
+                SW_FT_Vector vec1, vec2, vec;
+
+                vec1.x = PATH_COORD(pt[0]);
+                vec1.y = PATH_COORD(pt[1]);
+                vec2.x = PATH_COORD(pt[2]);
+                vec2.y = PATH_COORD(pt[3]);
+                vec.x = PATH_COORD(pt[4]);
+                vec.y = PATH_COORD(pt[5]);
+                pt += 6;
+
+                error = SW_FT_Stroker_CubicTo(stroker, &vec1, &vec2, &vec);
+                break;
+            }
+            case SW_FT_PATH_CLOSE: {
+                SW_FT_Vector vec = v_start;
+
+                error = SW_FT_Stroker_LineTo(stroker, &vec);
+                break;
+            }
+            default: /* SW_FT_PATH_LINE_TO */
+            {
+                SW_FT_Vector vec;
+
+                vec.x = PATH_COORD(pt[0]);
+                vec.y = PATH_COORD(pt[1]);
+                pt += 2;
+
+                error = SW_FT_Stroker_LineTo(stroker, &vec);
+                break;
+            }
+            }
+            if (error) goto Exit;
+        }
+
+        /* don't try to end the path if no segments have been generated */
+        if (!stroker->first_point) {
+            error = SW_FT_Stroker_EndSubPath(stroker);
+            if (error) goto Exit;
+        }
+    }
+
+    return 0;
+
+Exit:
+    return error;
+}
+
 /* END */
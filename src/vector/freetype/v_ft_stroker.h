@@ -244,6 +244,34 @@
                              const SW_FT_Outline*  outline);
 
 
+  /**************************************************************
+   *
+   * @function:
+   *   SW_FT_Stroker_ParsePath
+   *
+   * @description:
+   *   A variant of @SW_FT_Stroker_ParseOutline that reads an
+   *   @SW_FT_Path directly.  A contour is opened unless it has a
+   *   close element.
+   *
+   * @input:
+   *   stroker ::
+   *     The target stroker handle.
+   *
+   *   path ::
+   *     The source path.
+   *
+   * @return:
+   *   FreeType error code.  0~means success.
+   *
+   * @note:
+   *   This function calls @SW_FT_Stroker_Rewind automatically.
+   */
+  SW_FT_Error
+  SW_FT_Stroker_ParsePath( SW_FT_Stroker      stroker,
+                           const SW_FT_Path*  path );
+
+
   /**************************************************************
    *
    * @function:
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "vbase64.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+static constexpr const unsigned char B64index[256] = {
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  62, 63, 62, 62, 63, 52, 53, 54, 55, 56, 57,
+    58, 59, 60, 61, 0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  3,  4,  5,  6,
+    7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 0,  0,  0,  0,  63, 0,  26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,
+    37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51};
+
+static inline void decodeQuad(const unsigned char *p, uint8_t *out)
+{
+    uint32_t n = B64index[p[0]] << 18 | B64index[p[1]] << 12 |
+                 B64index[p[2]] << 6 | B64index[p[3]];
+    out[0] = uint8_t(n >> 16);
+    out[1] = uint8_t(n >> 8);
+    out[2] = uint8_t(n);
+}
+
+/*
+ * The kernels only handle the standard alphabet (A-Z a-z 0-9 + /), a block
+ * with any other character (url safe alphabet, whitespace, garbage) is left
+ * to decodeQuad() so the result always matches the scalar decoder.
+ * Each kernel returns the number of characters it consumed.
+ */
+#if defined(__AVX2__)
+
+static inline bool translate(__m256i in, __m256i &out)
+{
+    // lo <= v <= hi as a single signed compare of v - lo - 128.
+    auto inRange = [](__m256i v, char lo, char hi) {
+        v = _mm256_add_epi8(v, _mm256_set1_epi8(char(128 - lo)));
+        return _mm256_cmpgt_epi8(_mm256_set1_epi8(char(-128 + hi - lo + 1)), v);
+    };
+    __m256i upper = inRange(in, 'A', 'Z');
+    __m256i lower = inRange(in, 'a', 'z');
+    __m256i digit = inRange(in, '0', '9');
+    __m256i plus = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('+'));
+    __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+
+    __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                    _mm256_or_si256(_mm256_or_si256(digit, plus), slash));
+    if (_mm256_movemask_epi8(valid) != -1) return false;
+
+    __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(19)));
+    shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(16)));
+    out = _mm256_add_epi8(in, shift);
+    return true;
+}
+
+static size_t decodeSimd(const unsigned char *p, size_t len, uint8_t *out)
+{
+    const __m256i pack = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32, out += 24) {
+        __m256i values;
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        if (!translate(in, values)) {
+            for (size_t k = 0; k < 32; k += 4) decodeQuad(p + i + k, out + k / 4 * 3);
+            continue;
+        }
+        // 4 x 6 bits -> 24 bits in every 32 bit lane
+        values = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        values = _mm256_madd_epi16(values, _mm256_set1_epi32(0x00011000));
+        values = _mm256_shuffle_epi8(values, pack);
+        values = _mm256_permutevar8x32_epi32(values, lanes);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                         _mm256_castsi256_si128(values));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + 16),
+                         _mm256_extracti128_si256(values, 1));
+    }
+    return i;
+}
+
+#elif defined(__SSE2__)
+
+static inline bool translate(__m128i in, __m128i &out)
+{
+    // lo <= v <= hi as a single signed compare of v - lo - 128.
+    auto inRange = [](__m128i v, char lo, char hi) {
+        v = _mm_add_epi8(v, _mm_set1_epi8(char(128 - lo)));
+        return _mm_cmplt_epi8(v, _mm_set1_epi8(char(-128 + hi - lo + 1)));
+    };
+    __m128i upper = inRange(in, 'A', 'Z');
+    __m128i lower = inRange(in, 'a', 'z');
+    __m128i digit = inRange(in, '0', '9');
+    __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+
+    __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                 _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    if (_mm_movemask_epi8(valid) != 0xFFFF) return false;
+
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-65));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(-71)));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(4)));
+    shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(19)));
+    shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(16)));
+    out = _mm_add_epi8(in, shift);
+    return true;
+}
+
+static size_t decodeSimd(const unsigned char *p, size_t len, uint8_t *out)
+{
+    const __m128i lo8 = _mm_set1_epi16(0x00FF);
+    const __m128i lo16 = _mm_set1_epi32(0x0000FFFF);
+    const __m128i byte0 = _mm_set1_epi32(0x000000FF);
+    const __m128i byte1 = _mm_set1_epi32(0x0000FF00);
+    const __m128i byte2 = _mm_set1_epi32(0x00FF0000);
+    const __m128i low24 = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF);
+    const __m128i high24 = _mm_set_epi32(0x0000FFFF, 0xFF000000, 0x0000FFFF,
+                                         0xFF000000);
+
+    // every block writes 14 bytes, keep one more quad for the overlap.
+    size_t i = 0;
+    for (; i + 20 <= len; i += 16, out += 12) {
+        __m128i values;
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        if (!translate(in, values)) {
+            for (size_t k = 0; k < 16; k += 4) decodeQuad(p + i + k, out + k / 4 * 3);
+            continue;
+        }
+        // 2 x 6 bits -> 12 bits in every 16 bit lane
+        values = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(values, lo8), 6),
+                              _mm_srli_epi16(values, 8));
+        // 2 x 12 bits -> 24 bits in every 32 bit lane
+        values = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(values, lo16), 12),
+                              _mm_srli_epi32(values, 16));
+        // big endian byte order
+        values = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(_mm_srli_epi32(values, 16), byte0),
+                         _mm_and_si128(values, byte1)),
+            _mm_and_si128(_mm_slli_epi32(values, 16), byte2));
+        // 2 x 3 bytes -> 6 bytes in every 64 bit lane
+        values = _mm_or_si128(_mm_and_si128(values, low24),
+                              _mm_and_si128(_mm_srli_epi64(values, 8), high24));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out), values);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + 6),
+                         _mm_srli_si128(values, 8));
+    }
+    return i;
+}
+
+#elif defined(__ARM_NEON__)
+
+static inline bool translate(uint8x16_t in, uint8x16_t &out)
+{
+    auto inRange = [](uint8x16_t v, uint8_t lo, uint8_t hi) {
+        return vandq_u8(vcgeq_u8(v, vdupq_n_u8(lo)), vcleq_u8(v, vdupq_n_u8(hi)));
+    };
+    uint8x16_t upper = inRange(in, 'A', 'Z');
+    uint8x16_t lower = inRange(in, 'a', 'z');
+    uint8x16_t digit = inRange(in, '0', '9');
+    uint8x16_t plus = vceqq_u8(in, vdupq_n_u8('+'));
+    uint8x16_t slash = vceqq_u8(in, vdupq_n_u8('/'));
+
+    uint8x16_t valid = vorrq_u8(vorrq_u8(upper, lower),
+                                vorrq_u8(vorrq_u8(digit, plus), slash));
+    uint8x8_t all = vand_u8(vget_low_u8(valid), vget_high_u8(valid));
+    all = vpmin_u8(all, all);
+    all = vpmin_u8(all, all);
+    all = vpmin_u8(all, all);
+    if (vget_lane_u8(all, 0) != 0xFF) return false;
+
+    uint8x16_t shift = vandq_u8(upper, vdupq_n_u8(uint8_t(-65)));
+    shift = vorrq_u8(shift, vandq_u8(lower, vdupq_n_u8(uint8_t(-71))));
+    shift = vorrq_u8(shift, vandq_u8(digit, vdupq_n_u8(4)));
+    shift = vorrq_u8(shift, vandq_u8(plus, vdupq_n_u8(19)));
+    shift = vorrq_u8(shift, vandq_u8(slash, vdupq_n_u8(16)));
+    out = vaddq_u8(in, shift);
+    return true;
+}
+
+static size_t decodeSimd(const unsigned char *p, size_t len, uint8_t *out)
+{
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64, out += 48) {
+        // deinterleaved: val[n] holds the n-th character of 16 quads.
+        uint8x16x4_t in = vld4q_u8(p + i);
+        uint8x16_t   a, b, c, d;
+        if (!translate(in.val[0], a) || !translate(in.val[1], b) ||
+            !translate(in.val[2], c) || !translate(in.val[3], d)) {
+            for (size_t k = 0; k < 64; k += 4) decodeQuad(p + i + k, out + k / 4 * 3);
+            continue;
+        }
+        uint8x16x3_t result;
+        result.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        result.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        result.val[2] = vorrq_u8(vshlq_n_u8(c, 6), d);
+        vst3q_u8(out, result);
+    }
+    return i;
+}
+
+#else
+
+static size_t decodeSimd(const unsigned char *, size_t, uint8_t *)
+{
+    return 0;
+}
+
+#endif
+
+/*
+ * Splits the input into full quads and the padded tail. The tail (missing
+ * or '=' padded characters) decodes to 1 or 2 bytes.
+ */
+static size_t decode(const char *data, size_t len, uint8_t *out, bool simd)
+{
+    auto         p = reinterpret_cast<const unsigned char *>(data);
+    size_t       pad = len > 0 && (len % 4 || p[len - 1] == '=');
+    const size_t L = ((len + 3) / 4 - pad) * 4;
+
+    size_t i = simd ? decodeSimd(p, L, out) : 0;
+    size_t j = i / 4 * 3;
+    for (; i < L; i += 4, j += 3) decodeQuad(p + i, out + j);
+
+    if (pad) {
+        uint32_t n = B64index[p[L]] << 18 |
+                     (L + 1 < len ? B64index[p[L + 1]] : 0) << 12;
+        out[j++] = uint8_t(n >> 16);
+
+        if (len > L + 2 && p[L + 2] != '=') {
+            n |= B64index[p[L + 2]] << 6;
+            out[j++] = uint8_t(n >> 8);
+        }
+    }
+    return j;
+}
+
+size_t vBase64Decode(const char *data, size_t len, uint8_t *out)
+{
+    return decode(data, len, out, true);
+}
+
+size_t vBase64DecodeScalar(const char *data, size_t len, uint8_t *out)
+{
+    return decode(data, len, out, false);
+}
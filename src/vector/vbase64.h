@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VBASE64_H
+#define VBASE64_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Base64 decoder for the embedded image data.
+ * The input is decoded straight into a caller provided buffer, using the
+ * SSE2/AVX2/NEON kernels when available and a scalar loop otherwise.
+ * Characters outside of the alphabet are decoded as zero bits, padding is
+ * optional.
+ */
+
+// upper bound of the decoded size of len base64 characters.
+inline size_t vBase64DecodedSize(size_t len)
+{
+    return (len + 3) / 4 * 3;
+}
+
+// decodes len characters into out (at least vBase64DecodedSize(len) bytes),
+// returns the number of bytes written.
+size_t vBase64Decode(const char *data, size_t len, uint8_t *out);
+
+// scalar reference implementation, same result as vBase64Decode().
+size_t vBase64DecodeScalar(const char *data, size_t len, uint8_t *out);
+
+#endif  // VBASE64_H
@@ -25,11 +25,17 @@
 
 #include <cassert>
 #include <atomic>
+#include "config.h"
 
 template <typename T>
 class vcow_ptr {
     struct model {
+#ifdef LOTTIE_THREAD_SUPPORT
+        // paths and rles are created on the loader / parser threads.
+        std::atomic<std::size_t> mRef{1};
+#else
         std::size_t mRef{1}; // Single-threaded version - no atomic needed
+#endif
 
         model() = default;
 
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "vdenseraster.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "vpath.h"
+#include "vrle.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+V_BEGIN_NAMESPACE
+
+// largest distance in pixels of a flattened cubic from the curve.
+static constexpr float kTolerance = 0.05f;
+static constexpr int   kMaxCubicLines = 256;
+// floats of the accumulation buffer swept at once, and the rows at most.
+static constexpr size_t kStripSize = 16384;
+static constexpr int    kStripRows = 64;
+// crossings per row from which the buffer is worth it, and the cost of a
+// crossing of an edge in the cells as the one of swept pixels, measured
+// with example/rasterperf.
+static constexpr float kCrossings = 8;
+static constexpr int   kMinWidth = 64;
+static constexpr float kCrossingCost = 16;
+
+VRect VDenseRaster::bounds(const VPath &path, const VRect &clip)
+{
+    const auto &points = path.points();
+    if (points.empty()) return {};
+
+    float l = points[0].x(), r = l;
+    float t = points[0].y(), b = t;
+    for (const auto &p : points) {
+        l = std::min(l, p.x());
+        r = std::max(r, p.x());
+        t = std::min(t, p.y());
+        b = std::max(b, p.y());
+    }
+    if (!std::isfinite(l) || !std::isfinite(r) || !std::isfinite(t) ||
+        !std::isfinite(b))
+        return {};
+
+    // same device as the cell rasterizer without a clip.
+    VRect device = clip.empty() ? VRect(-32768, -32768, 65535, 65535) : clip;
+    int   x1 = int(std::max(std::floor(l), float(device.left())));
+    int   y1 = int(std::max(std::floor(t), float(device.top())));
+    int   x2 = int(std::min(std::ceil(r), float(device.right())));
+    int   y2 = int(std::min(std::ceil(b), float(device.bottom())));
+    if (x1 >= x2 || y1 >= y2) return {};
+
+    return {x1, y1, x2 - x1, y2 - y1};
+}
+
+bool VDenseRaster::preferred(const VPath &path, const VRect &bounds)
+{
+    if (bounds.empty()) return false;
+
+    /*
+     * the cells of a row are a sorted list, each crossing of an edge walks
+     * it, so their cost grows with the square of the edges crossing a row
+     * where the buffer costs the same for each pixel of the bounds. The
+     * rows the control polygon spans inside bounds tell how many edges
+     * cross a row.
+     */
+    const float top = float(bounds.top());
+    const float bottom = float(bounds.bottom());
+    auto        clamp = [&](const VPointF &p) {
+        return std::min(std::max(p.y(), top), bottom);
+    };
+
+    const auto *pt = path.points().data();
+    float       start = 0, last = 0, rows = 0;
+    for (auto e : path.elements()) {
+        switch (e) {
+        case VPath::Element::MoveTo:
+            rows += std::fabs(start - last);
+            start = last = clamp(*pt++);
+            break;
+        case VPath::Element::LineTo:
+            rows += std::fabs(clamp(*pt) - last);
+            last = clamp(*pt++);
+            break;
+        case VPath::Element::CubicTo:
+            for (int i = 0; i < 3; i++) {
+                rows += std::fabs(clamp(*pt) - last);
+                last = clamp(*pt++);
+            }
+            break;
+        case VPath::Element::Close:
+            rows += std::fabs(start - last);
+            last = start;
+            break;
+        }
+    }
+    rows += std::fabs(start - last);
+
+    float crossings = rows / bounds.height();
+    return crossings >= kCrossings && bounds.width() >= kMinWidth &&
+           crossings * crossings * kCrossingCost >= bounds.width();
+}
+
+void VDenseRaster::pushEdge(float x0, float y0, float x1, float y1)
+{
+    // the x range is [0, width], an edge on the right border doesn't
+    // cover any pixel.
+    x0 = std::min(std::max(x0, 0.0f), float(mBounds.width()));
+    x1 = std::min(std::max(x1, 0.0f), float(mBounds.width()));
+    if (x0 == mBounds.width() && x1 == mBounds.width()) return;
+
+    if (y0 < y1)
+        mEdges.push_back({x0, y0, x1, y1, 1.0f});
+    else
+        mEdges.push_back({x1, y1, x0, y0, -1.0f});
+}
+
+void VDenseRaster::addLine(float x0, float y0, float x1, float y1)
+{
+    const float w = float(mBounds.width());
+    const float h = float(mBounds.height());
+
+    if (y0 == y1) return;
+    if (std::max(y0, y1) <= 0 || std::min(y0, y1) >= h) return;
+
+    /*
+     * the parts of the line out of the buffer become vertical lines on its
+     * borders, which covers the same pixels inside.
+     */
+    float t[2];
+    int   n = 0;
+    if ((x0 < 0) != (x1 < 0)) t[n++] = -x0 / (x1 - x0);
+    if ((x0 > w) != (x1 > w)) t[n++] = (w - x0) / (x1 - x0);
+    if (n == 2 && t[0] > t[1]) std::swap(t[0], t[1]);
+
+    float px = x0, py = y0;
+    for (int i = 0; i < n; i++) {
+        float x = x0 + t[i] * (x1 - x0);
+        float y = y0 + t[i] * (y1 - y0);
+        pushEdge(px, py, x, y);
+        px = x;
+        py = y;
+    }
+    pushEdge(px, py, x1, y1);
+}
+
+void VDenseRaster::addCubic(float x0, float y0, float x1, float y1, float x2,
+                            float y2, float x3, float y3)
+{
+    const float w = float(mBounds.width());
+    const float h = float(mBounds.height());
+
+    // above, below or right of the buffer.
+    if (std::max(std::max(y0, y1), std::max(y2, y3)) <= 0 ||
+        std::min(std::min(y0, y1), std::min(y2, y3)) >= h ||
+        std::min(std::min(x0, x1), std::min(x2, x3)) >= w)
+        return;
+
+    // left of the buffer, only the rows it spans count.
+    if (std::max(std::max(x0, x1), std::max(x2, x3)) <= 0) {
+        addLine(x0, y0, x3, y3);
+        return;
+    }
+
+    // the polyline of n lines is within 3/4 * dd / n^2 of the curve.
+    float ddx = std::max(std::fabs(x0 - 2 * x1 + x2),
+                         std::fabs(x1 - 2 * x2 + x3));
+    float ddy = std::max(std::fabs(y0 - 2 * y1 + y2),
+                         std::fabs(y1 - 2 * y2 + y3));
+    float dd = std::sqrt(ddx * ddx + ddy * ddy);
+    int   n = std::min(1 + int(std::sqrt(dd * (0.75f / kTolerance))),
+                     kMaxCubicLines);
+
+    float px = x0, py = y0;
+    for (int i = 1; i < n; i++) {
+        float t = float(i) / n;
+        float mt = 1 - t;
+        float a = mt * mt * mt;
+        float b = 3 * mt * mt * t;
+        float c = 3 * mt * t * t;
+        float d = t * t * t;
+        float x = a * x0 + b * x1 + c * x2 + d * x3;
+        float y = a * y0 + b * y1 + c * y2 + d * y3;
+        addLine(px, py, x, y);
+        px = x;
+        py = y;
+    }
+    addLine(px, py, x3, y3);
+}
+
+/*
+ * adds the area the edge covers right of it in each row of the strip, the
+ * pixel it crosses gets the part right of the edge and the next ones the
+ * rest, so the running sum of a row is the winding of each pixel weighted
+ * by its coverage.
+ */
+void VDenseRaster::accumulate(const Edge &e, int top, int rows)
+{
+    const float y0 = e.y0 - top;
+    const float y1 = e.y1 - top;
+    const int   ys = std::max(0, int(std::floor(y0)));
+    const int   ye = std::min(rows, int(std::ceil(y1)));
+    const float dxdy = (e.x1 - e.x0) / (e.y1 - e.y0);
+    // keeps the rounding of the steps inside the buffer.
+    const float xmin = std::min(e.x0, e.x1);
+    const float xmax = std::max(e.x0, e.x1);
+
+    float x = e.x0 + (std::max(y0, float(ys)) - y0) * dxdy;
+    x = std::min(std::max(x, xmin), xmax);
+    for (int y = ys; y < ye; y++) {
+        float *row = mAccumulation.data() + y * mStride;
+        float  dy = std::min(float(y + 1), y1) - std::max(float(y), y0);
+        float  xnext = std::min(std::max(x + dxdy * dy, xmin), xmax);
+        float  d = dy * e.dir;
+
+        float xa = std::min(x, xnext);
+        float xb = std::max(x, xnext);
+        float xaFloor = std::floor(xa);
+        float xbCeil = std::ceil(xb);
+        int   xai = int(xaFloor);
+        int   xbi = int(xbCeil);
+        if (xbi <= xai + 1) {
+            // within a pixel, split at the middle of the crossing.
+            float xm = 0.5f * (x + xnext) - xaFloor;
+            row[xai] += d - d * xm;
+            row[xai + 1] += d * xm;
+        } else {
+            float s = 1 / (xb - xa);
+            float xaFrac = xa - xaFloor;
+            float a0 = 0.5f * s * (1 - xaFrac) * (1 - xaFrac);
+            float xbFrac = xb - xbCeil + 1;
+            float am = 0.5f * s * xbFrac * xbFrac;
+            row[xai] += d * a0;
+            if (xbi == xai + 2) {
+                row[xai + 1] += d * (1 - a0 - am);
+            } else {
+                float a1 = s * (1.5f - xaFrac);
+                row[xai + 1] += d * (a1 - a0);
+                for (int xi = xai + 2; xi < xbi - 1; xi++) row[xi] += d * s;
+                float a2 = a1 + (xbi - xai - 3) * s;
+                row[xbi - 1] += d * (1 - a2 - am);
+            }
+            row[xbi] += d * am;
+        }
+        x = xnext;
+    }
+}
+
+/*
+ * coverage of an accumulated area, 0..255 as the cell rasterizer computes
+ * it from its 256 sub pixels.
+ */
+static inline uint8_t coverage(float area, bool evenOdd)
+{
+    int c = int(std::min(std::fabs(area), 127.0f) * 256);
+    if (evenOdd) {
+        c &= 511;
+        c = std::min(c, 512 - c);
+    }
+    return uint8_t(std::min(c, 255));
+}
+
+/*
+ * running sum of count accumulated areas from carry into their coverage,
+ * the areas are cleared for the next strip. Each kernel returns the number
+ * of pixels it wrote.
+ */
+#if defined(__SSE2__)
+
+static size_t coverageKernel(float *acc, uint8_t *cov, size_t count,
+                             float &carry, bool evenOdd)
+{
+    const __m128  signMask = _mm_set1_ps(-0.0f);
+    const __m128  maxArea = _mm_set1_ps(127.0f);
+    const __m128  scale = _mm_set1_ps(256.0f);
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i wrap = _mm_set1_epi16(511);
+    const __m128i period = _mm_set1_epi16(512);
+
+    __m128 sum = _mm_set1_ps(carry);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(acc + i);
+        x = _mm_add_ps(x, _mm_castsi128_ps(
+                              _mm_slli_si128(_mm_castps_si128(x), 4)));
+        x = _mm_add_ps(x, _mm_castsi128_ps(
+                              _mm_slli_si128(_mm_castps_si128(x), 8)));
+        x = _mm_add_ps(x, sum);
+        sum = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+        _mm_storeu_ps(acc + i, _mm_setzero_ps());
+
+        __m128  a = _mm_min_ps(_mm_andnot_ps(signMask, x), maxArea);
+        __m128i c = _mm_cvttps_epi32(_mm_mul_ps(a, scale));
+        c = _mm_packs_epi32(c, c);
+        if (evenOdd) {
+            c = _mm_and_si128(c, wrap);
+            c = _mm_min_epi16(c, _mm_sub_epi16(period, c));
+        }
+        c = _mm_min_epi16(c, full);
+        int v = _mm_cvtsi128_si32(_mm_packus_epi16(c, c));
+        memcpy(cov + i, &v, sizeof(v));
+    }
+    carry = _mm_cvtss_f32(sum);
+    return i;
+}
+
+#elif defined(__ARM_NEON__)
+
+static size_t coverageKernel(float *acc, uint8_t *cov, size_t count,
+                             float &carry, bool evenOdd)
+{
+    const float32x4_t zero = vdupq_n_f32(0);
+    const float32x4_t maxArea = vdupq_n_f32(127.0f);
+    const int16x4_t   full = vdup_n_s16(255);
+    const int16x4_t   wrap = vdup_n_s16(511);
+    const int16x4_t   period = vdup_n_s16(512);
+
+    float32x4_t sum = vdupq_n_f32(carry);
+    size_t      i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = vld1q_f32(acc + i);
+        x = vaddq_f32(x, vextq_f32(zero, x, 3));
+        x = vaddq_f32(x, vextq_f32(zero, x, 2));
+        x = vaddq_f32(x, sum);
+        sum = vdupq_n_f32(vgetq_lane_f32(x, 3));
+        vst1q_f32(acc + i, zero);
+
+        float32x4_t a = vmulq_n_f32(vminq_f32(vabsq_f32(x), maxArea), 256.0f);
+        int16x4_t   c = vmovn_s32(vcvtq_s32_f32(a));
+        if (evenOdd) {
+            c = vand_s16(c, wrap);
+            c = vmin_s16(c, vsub_s16(period, c));
+        }
+        c = vmin_s16(c, full);
+        uint8x8_t b = vmovn_u16(vreinterpretq_u16_s16(vcombine_s16(c, c)));
+        uint32_t  v = vget_lane_u32(vreinterpret_u32_u8(b), 0);
+        memcpy(cov + i, &v, sizeof(v));
+    }
+    carry = vgetq_lane_f32(sum, 0);
+    return i;
+}
+
+#else
+
+static size_t coverageKernel(float *, uint8_t *, size_t, float &, bool)
+{
+    return 0;
+}
+
+#endif
+
+void VDenseRaster::sweep(int top, int rows, bool evenOdd, VRle &rle)
+{
+    VRle::Span spans[256];
+    size_t     count = 0;
+    const int  width = mBounds.width();
+    uint8_t *  cov = mCoverage.data();
+
+    for (int r = 0; r < rows; r++) {
+        float *acc = mAccumulation.data() + r * mStride;
+        float  carry = 0;
+        size_t i = coverageKernel(acc, cov, mStride, carry, evenOdd);
+        for (; i < mStride; i++) {
+            carry += acc[i];
+            acc[i] = 0;
+            cov[i] = coverage(carry, evenOdd);
+        }
+
+        const short y = short(mBounds.top() + top + r);
+        for (int x = 0; x < width;) {
+            uint64_t word;
+            if (x + 8 <= width && (memcpy(&word, cov + x, 8), !word)) {
+                x += 8;
+                continue;
+            }
+            uint8_t c = cov[x];
+            if (!c) {
+                x++;
+                continue;
+            }
+            int start = x;
+            while (++x < width && cov[x] == c)
+                ;
+            if (count == sizeof(spans) / sizeof(spans[0])) {
+                rle.addSpan(spans, count);
+                count = 0;
+            }
+            VRle::Span &span = spans[count++];
+            span.x = short(mBounds.left() + start);
+            span.y = y;
+            span.len = uint16_t(x - start);
+            span.coverage = c;
+        }
+    }
+    if (count) rle.addSpan(spans, count);
+}
+
+void VDenseRaster::rasterize(const VPath &path, const VRect &bounds,
+                             FillRule fillRule, VRle &rle)
+{
+    rle.reset();
+    if (bounds.empty()) return;
+
+    mBounds = bounds;
+    mEdges.clear();
+
+    // the edges in buffer coordinates, every contour is closed.
+    const float dx = float(bounds.left());
+    const float dy = float(bounds.top());
+    const auto *pt = path.points().data();
+    float       sx = 0, sy = 0, cx = 0, cy = 0;
+    for (auto e : path.elements()) {
+        switch (e) {
+        case VPath::Element::MoveTo:
+            addLine(cx, cy, sx, sy);
+            sx = cx = pt->x() - dx;
+            sy = cy = pt->y() - dy;
+            pt++;
+            break;
+        case VPath::Element::LineTo:
+            addLine(cx, cy, pt->x() - dx, pt->y() - dy);
+            cx = pt->x() - dx;
+            cy = pt->y() - dy;
+            pt++;
+            break;
+        case VPath::Element::CubicTo:
+            addCubic(cx, cy, pt[0].x() - dx, pt[0].y() - dy, pt[1].x() - dx,
+                     pt[1].y() - dy, pt[2].x() - dx, pt[2].y() - dy);
+            cx = pt[2].x() - dx;
+            cy = pt[2].y() - dy;
+            pt += 3;
+            break;
+        case VPath::Element::Close:
+            addLine(cx, cy, sx, sy);
+            cx = sx;
+            cy = sy;
+            break;
+        }
+    }
+    addLine(cx, cy, sx, sy);
+    if (mEdges.empty()) return;
+
+    std::sort(mEdges.begin(), mEdges.end(),
+              [](const Edge &a, const Edge &b) { return a.y0 < b.y0; });
+
+    // two more floats for the pixels right of the last crossing.
+    mStride = (size_t(bounds.width()) + 2 + 3) & ~size_t(3);
+    const int strip =
+        std::min(std::max(int(kStripSize / mStride), 1), kStripRows);
+    // left cleared by each sweep.
+    if (mAccumulation.size() < mStride * strip)
+        mAccumulation.resize(mStride * strip);
+    if (mCoverage.size() < mStride) mCoverage.resize(mStride);
+
+    const bool evenOdd = fillRule == FillRule::EvenOdd;
+    size_t     next = 0;
+    mActive.clear();
+    for (int top = 0; top < bounds.height(); top += strip) {
+        const int rows = std::min(strip, bounds.height() - top);
+        const int bottom = top + rows;
+
+        mActive.erase(std::remove_if(mActive.begin(), mActive.end(),
+                                     [top](const Edge *e) {
+                                         return e->y1 <= top;
+                                     }),
+                      mActive.end());
+        for (; next < mEdges.size() && mEdges[next].y0 < bottom; next++) {
+            if (mEdges[next].y1 > top) mActive.push_back(&mEdges[next]);
+        }
+        if (mActive.empty()) continue;
+
+        for (auto e : mActive) accumulate(*e, top, rows);
+        sweep(top, rows, evenOdd, rle);
+    }
+}
+
+V_END_NAMESPACE
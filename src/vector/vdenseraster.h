@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VDENSERASTER_H
+#define VDENSERASTER_H
+#include <cstdint>
+#include <vector>
+#include "vglobal.h"
+#include "vrect.h"
+
+V_BEGIN_NAMESPACE
+
+class VPath;
+class VRle;
+
+/*
+ * Scan converter on a dense accumulation buffer (as in font-rs). Every edge
+ * adds the signed area it covers to the pixels of a strip of rows and the
+ * running sum along a row is the coverage of its pixels. It writes the same
+ * spans as the cell rasterizer of v_ft_raster, but walks the path once
+ * where the cells walk it once per band and again on each pool overflow,
+ * its cost follows the pixel area of the path instead.
+ */
+class VDenseRaster {
+public:
+    // the pixels of clip under the control points of path, an empty clip
+    // is the whole device.
+    static VRect bounds(const VPath &path, const VRect &clip);
+    // whether path is cheaper to scan convert over bounds here than in the
+    // cell rasterizer.
+    static bool preferred(const VPath &path, const VRect &bounds);
+    void rasterize(const VPath &path, const VRect &bounds, FillRule fillRule,
+                   VRle &rle);
+
+private:
+    struct Edge {
+        float x0, y0, x1, y1;  // y0 < y1
+        float dir;
+    };
+    void addLine(float x0, float y0, float x1, float y1);
+    void addCubic(float x0, float y0, float x1, float y1, float x2, float y2,
+                  float x3, float y3);
+    void pushEdge(float x0, float y0, float x1, float y1);
+    void accumulate(const Edge &e, int top, int rows);
+    void sweep(int y, int rows, bool evenOdd, VRle &rle);
+
+private:
+    std::vector<Edge>         mEdges;
+    std::vector<const Edge *> mActive;
+    std::vector<float>        mAccumulation;
+    std::vector<uint8_t>      mCoverage;
+    VRect                     mBounds;
+    size_t                    mStride{0};
+};
+
+V_END_NAMESPACE
+
+#endif  // VDENSERASTER_H
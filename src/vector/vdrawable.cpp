@@ -21,6 +21,8 @@
  */
 
 #include "vdrawable.h"
+#include <algorithm>
+#include <cmath>
 #include "vdasher.h"
 #include "vraster.h"
 #include "vpainter.h"
@@ -51,27 +53,145 @@ void VDrawable::setType(VDrawable::Type type)
     }
 }
 
+// dashes path by the pattern in local units scaled to the path.
+static void dashed(const std::vector<float> &pattern, float scale, VPath &path)
+{
+    if (pattern.empty()) return;
+    std::vector<float> dash(pattern);
+    for (auto &elm : dash) elm *= scale;
+    VDasher dasher(dash.data(), dash.size());
+    path.clone(dasher.dashed(path));
+}
+
 void VDrawable::applyDashOp()
 {
-    if (mStrokeInfo && (mType == Type::StrokeWithDash)) {
-        auto obj = static_cast<StrokeWithDashInfo *>(mStrokeInfo);
-        if (!obj->mDash.empty()) {
-            VDasher dasher(obj->mDash.data(), obj->mDash.size());
-            mPath.clone(dasher.dashed(mPath));
-        }
+    if (!mStrokeInfo || (mType != Type::StrokeWithDash)) return;
+
+    auto obj = static_cast<StrokeWithDashInfo *>(mStrokeInfo);
+    if (!mLocal) {
+        dashed(obj->mDash, obj->mScale, mPath);
+        return;
+    }
+
+    // the path is dashed without the translation of the matrix, so a
+    // matrix that only moves it reuses the dashed path as it is.
+    if (!mDashValid) {
+        VMatrix m;
+        m.translate(-mMatrix.m_tx(), -mMatrix.m_ty());
+        mDashedPath.reset();
+        mDashedPath.addPath(mLocalPath, mMatrix * m);
+        dashed(obj->mDash, obj->mScale, mDashedPath);
+        mDashValid = true;
+    }
+    VMatrix m;
+    m.translate(mMatrix.m_tx(), mMatrix.m_ty());
+    mPath.reset();
+    mPath.addPath(mDashedPath, m);
+}
+
+/*
+ * conservative check if the path coverage reaches out of the clip, the
+ * control points bound the curves and the stroke grows the outline by at
+ * most half the width times the miter limit (or the square cap).
+ */
+static bool clipped(const VPath &path, const VRect &clip, float extent)
+{
+    if (clip.empty()) return false;
+    if (path.points().empty()) return false;
+
+    float left = path.points().front().x(), right = left;
+    float top = path.points().front().y(), bottom = top;
+    for (const auto &pt : path.points()) {
+        left = std::min(left, pt.x());
+        right = std::max(right, pt.x());
+        top = std::min(top, pt.y());
+        bottom = std::max(bottom, pt.y());
+    }
+    // one more pixel for the antialiasing.
+    extent += 1;
+    return left - extent < clip.left() || top - extent < clip.top() ||
+           right + extent > clip.right() || bottom + extent > clip.bottom();
+}
+
+void VDrawable::setSource(VDrawable *source, const VMatrix &m)
+{
+    if (source && !source->mShared) {
+        source->mShared = true;
+        if (source->mType != Type::Fill) source->mRasterizer.keepOutline(true);
+    }
+    mSource = source;
+    mSourceMatrix = m;
+}
+
+static bool aligned(float v)
+{
+    return std::fabs(v - std::round(v)) < 1e-3f;
+}
+
+/*
+ * reuse the raster work of the source, a pixel aligned move of an unclipped
+ * source is a move of its coverage and a rotation or reflection of a stroke
+ * is the same transform of the stroked outline.
+ * Both drawables have to stay inside the clip: the rasterizer truncates the
+ * coordinates to 26.6 towards zero, so a path crossing the surface origin
+ * doesn't rasterize as its move. A scaled outline shows the flattening of
+ * the source curves, a scaled copy is stroked on its own.
+ */
+bool VDrawable::rasterizeFromSource(const VRect &clip)
+{
+    if (mClipped || mSource->mClipped) return false;
+
+    const VMatrix &m = mSourceMatrix;
+    bool translate = std::fabs(m.m_11() - 1) < 1e-4f &&
+                     std::fabs(m.m_22() - 1) < 1e-4f &&
+                     std::fabs(m.m_12()) < 1e-4f && std::fabs(m.m_21()) < 1e-4f;
+    if (translate && aligned(m.m_tx()) && aligned(m.m_ty())) {
+        mRasterizer.rasterize(
+            mSource->mRasterizer,
+            VPoint(int(std::round(m.m_tx())), int(std::round(m.m_ty()))), clip);
+        return true;
     }
+
+    const float eps = 1e-4f;
+    float det = m.m_11() * m.m_22() - m.m_12() * m.m_21();
+    bool  orthogonal = (std::fabs(m.m_11() - m.m_22()) < eps &&
+                       std::fabs(m.m_12() + m.m_21()) < eps) ||
+                      (std::fabs(m.m_11() + m.m_22()) < eps &&
+                       std::fabs(m.m_12() - m.m_21()) < eps);
+    if (mType != Type::Fill && orthogonal &&
+        std::fabs(std::fabs(det) - 1) < eps &&
+        mSource->mRasterizer.hasOutline()) {
+        mRasterizer.rasterize(mSource->mRasterizer, m, clip);
+        return true;
+    }
+    return false;
 }
 
 void VDrawable::preprocess(const VRect &clip)
 {
     if (mFlag & (DirtyState::Path)) {
-        // 保存原始路径副本，用于矢量渲染
+        if (mType != Type::Fill) applyDashOp();
+
+        // 保存最终路径副本（已应用虚线），用于矢量渲染
         mOriginalPath = mPath;
-        
+
+        if (mShared || mSource) {
+            float extent = 0;
+            if (mStrokeInfo)
+                extent = mStrokeInfo->width / 2 *
+                         std::max(mStrokeInfo->miterLimit, 1.5f);
+            mClipped = clipped(mPath, clip, extent);
+        }
+
+        if (mSource && rasterizeFromSource(clip)) {
+            mPath = {};
+            mFlag &= ~DirtyFlag(DirtyState::Path);
+            return;
+        }
+
         if (mType == Type::Fill) {
             mRasterizer.rasterize(std::move(mPath), mFillRule, clip);
         } else {
-            applyDashOp();
             mRasterizer.rasterize(std::move(mPath), mStrokeInfo->cap, mStrokeInfo->join,
                                   mStrokeInfo->width, mStrokeInfo->miterLimit, clip);
         }
@@ -88,21 +208,11 @@ VRle VDrawable::rle()
 // 添加直接绘制VPath的方法，用于矢量渲染器
 void VDrawable::drawPath(VPainter *painter)
 {
-    // 使用原始路径进行矢量渲染
-    VPath pathToUse = mOriginalPath.empty() ? mPath : mOriginalPath;
-    
-    if (pathToUse.empty()) return;
-    
-    // 应用虚线操作（如果需要）
-    VPath finalPath = pathToUse;
-    if (mStrokeInfo && (mType == Type::StrokeWithDash)) {
-        auto obj = static_cast<StrokeWithDashInfo *>(mStrokeInfo);
-        if (!obj->mDash.empty()) {
-            VDasher dasher(obj->mDash.data(), obj->mDash.size());
-            finalPath = dasher.dashed(pathToUse);
-        }
-    }
-    
+    // 使用预处理后的路径进行矢量渲染，虚线已在 preprocess() 中应用
+    const VPath &finalPath = mOriginalPath.empty() ? mPath : mOriginalPath;
+
+    if (finalPath.empty()) return;
+
     // 根据类型绘制
     if (mType == Type::Fill) {
         painter->drawPath(finalPath, mBrush);
@@ -128,7 +238,7 @@ void VDrawable::setStrokeInfo(CapStyle cap, JoinStyle join, float miterLimit,
     mFlag |= DirtyState::Path;
 }
 
-void VDrawable::setDashInfo(std::vector<float> &dashInfo)
+void VDrawable::setDashInfo(std::vector<float> &dashInfo, float scale)
 {
     assert(mStrokeInfo);
     assert(mType == VDrawable::Type::StrokeWithDash);
@@ -147,9 +257,15 @@ void VDrawable::setDashInfo(std::vector<float> &dashInfo)
         hasChanged = true;
     }
 
-    if (!hasChanged) return;
-
-    obj->mDash = dashInfo;
+    if (hasChanged) {
+        obj->mDash = dashInfo;
+    } else if (obj->mScale == scale) {
+        // exact, a scale kept within the fuzz would make the dash depend
+        // on the frames drawn before.
+        return;
+    }
+    obj->mScale = scale;
+    mDashValid = false;
 
     mFlag |= DirtyState::Path;
 }
@@ -157,5 +273,23 @@ void VDrawable::setDashInfo(std::vector<float> &dashInfo)
 void VDrawable::setPath(const VPath &path)
 {
     mPath = path;
+    mLocal = false;
+    mFlag |= DirtyState::Path;
+}
+
+// the dashed path only moves with the translation, any other change of the
+// matrix dashes again.
+static bool sameLinear(const VMatrix &a, const VMatrix &b)
+{
+    return a.m_11() == b.m_11() && a.m_12() == b.m_12() &&
+           a.m_21() == b.m_21() && a.m_22() == b.m_22();
+}
+
+void VDrawable::setPath(const VPath &path, const VMatrix &m, bool changed)
+{
+    if (changed || !mLocal) mLocalPath = path;
+    if (changed || !mLocal || !sameLinear(m, mMatrix)) mDashValid = false;
+    mMatrix = m;
+    mLocal = true;
     mFlag |= DirtyState::Path;
 }
@@ -53,12 +53,17 @@ public:
 
     typedef vFlag<DirtyState> DirtyFlag;
     void setPath(const VPath &path);
+    // the path in local coordinates and the matrix that maps it, changed
+    // tells if the local path differs from the one of the last call.
+    void setPath(const VPath &path, const VMatrix &m, bool changed);
     void setFillRule(FillRule rule) { mFillRule = rule; }
     void setBrush(const VBrush &brush) { mBrush = brush; }
     void setStrokeInfo(CapStyle cap, JoinStyle join, float miterLimit,
                        float strokeWidth);
-    void setDashInfo(std::vector<float> &dashInfo);
+    void setDashInfo(std::vector<float> &dashInfo, float scale = 1.0f);
     void preprocess(const VRect &clip);
+    void setSource(VDrawable *source, const VMatrix &m = VMatrix());
+    bool rasterizeFromSource(const VRect &clip);
     void applyDashOp();
     VRle rle();
     
@@ -82,12 +87,13 @@ public:
     };
 
     struct StrokeWithDashInfo : public StrokeInfo{
-        std::vector<float> mDash;
+        std::vector<float> mDash;  // in local units, mScale maps them
+        float              mScale{1.0f};
     };
 
 public:
     VPath                    mPath;
-    VPath                    mOriginalPath; // 保留原始路径，用于矢量渲染
+    VPath                    mOriginalPath; // 保留最终路径（含虚线），用于矢量渲染
     VBrush                   mBrush;
     VRasterizer              mRasterizer;
     StrokeInfo              *mStrokeInfo{nullptr};
@@ -96,6 +102,22 @@ public:
     FillRule                 mFillRule{FillRule::Winding};
     VDrawable::Type          mType{Type::Fill};
 
+    // a dashed stroke set by a local path dashes it again only when the
+    // path, the pattern or the matrix other than its translation change,
+    // mDashedPath is the result without the translation.
+    VPath                    mLocalPath;
+    VPath                    mDashedPath;
+    VMatrix                  mMatrix;
+    bool                     mLocal{false};
+    bool                     mDashValid{false};
+
+    // the path is the source path mapped by mSourceMatrix, so the raster
+    // work of the source is reused when the transform allows it.
+    VDrawable               *mSource{nullptr};
+    VMatrix                  mSourceMatrix;
+    bool                     mShared{false};
+    bool                     mClipped{true};
+
     const char              *mName{nullptr};
 };
 
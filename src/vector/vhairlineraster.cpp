@@ -0,0 +1,554 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "vhairlineraster.h"
+#include <algorithm>
+#include <cmath>
+#include "vpath.h"
+#include "vrle.h"
+
+V_BEGIN_NAMESPACE
+
+// largest distance in pixels of a flattened cubic from the curve.
+static constexpr float kTolerance = 0.05f;
+static constexpr int   kMaxCubicLines = 256;
+static constexpr float kPi = 3.14159265f;
+// the sine of the largest turn along one axis drawn without a join.
+static constexpr float kFlatJoin = 0.1f;
+
+// the length of the control polygon and the cubics from which a path is
+// drawn here, measured with example/rasterperf.
+static constexpr float kMinLength = 1024;
+static constexpr int   kMinCubics = 16;
+
+// points closer than this are one, a line between them has no direction.
+static constexpr float kSame = 1.0f / 1024;
+
+static inline bool vSame(const VPointF &a, const VPointF &b)
+{
+    return std::fabs(a.x() - b.x()) < kSame && std::fabs(a.y() - b.y()) < kSame;
+}
+
+static inline float vDot(const VPointF &a, const VPointF &b)
+{
+    return a.x() * b.x() + a.y() * b.y();
+}
+
+static inline VPointF vUnit(const VPointF &d)
+{
+    return d * (1 / std::sqrt(vDot(d, d)));
+}
+
+// the axis a line is walked along, towards the direction of the line.
+static inline VPointF vMajor(const VPointF &d)
+{
+    if (std::fabs(d.y()) > std::fabs(d.x()))
+        return {0, d.y() > 0 ? 1.0f : -1.0f};
+    return {d.x() > 0 ? 1.0f : -1.0f, 0};
+}
+
+/*
+ * a cell is the pixel in the upper half, y before x so they sort by rows,
+ * and its signed area in 1/65536 of a pixel in the lower half.
+ */
+void VHairlineRaster::plot(int x, int y, float area)
+{
+    int32_t a = int32_t(std::lround(area * 65536));
+    if (!a) return;
+    uint64_t key = (uint64_t(uint16_t(y + 32768)) << 16) | uint16_t(x + 32768);
+    mCells.push_back((key << 32) | uint32_t(a));
+}
+
+/*
+ * the mean over a pixel of clamp(l, y, y + 1) - y, l going linearly from l0
+ * to l1. With phi(t) the integral of the clamp from y to t, it is
+ * (phi(l1) - phi(l0)) / (l1 - l0), and the middle value when l is flat.
+ */
+static inline float clampedMean(float l0, float l1, float y)
+{
+    const float d = l1 - l0;
+    if (std::fabs(d) < 1e-3f)
+        return std::min(std::max(0.5f * (l0 + l1) - y, 0.0f), 1.0f);
+
+    auto phi = [y](float t) {
+        t -= y;
+        return t <= 0 ? 0 : t >= 1 ? t - 0.5f : 0.5f * t * t;
+    };
+    return (phi(l1) - phi(l0)) / d;
+}
+
+/*
+ * walks the line along its major axis one pixel at a time, the band of the
+ * stroke is as thick as the width across the minor axis and a pixel gets
+ * the area between the sides of the band over it. The band ends across the
+ * major axis, recut() moves the ends where they belong.
+ */
+void VHairlineRaster::addLine(VPointF p0, VPointF p1)
+{
+    float dx = p1.x() - p0.x();
+    float dy = p1.y() - p0.y();
+    if (dx == 0 && dy == 0) return;
+
+    const bool steep = std::fabs(dy) > std::fabs(dx);
+    float      x0 = p0.x(), y0 = p0.y(), x1 = p1.x(), y1 = p1.y();
+    int        cs = mClip.left(), ce = mClip.right();
+    int        rs = mClip.top(), re = mClip.bottom();
+    if (steep) {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+        std::swap(dx, dy);
+        std::swap(cs, rs);
+        std::swap(ce, re);
+    }
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+        dx = -dx;
+        dy = -dy;
+    }
+
+    const float slope = dy / dx;
+    const float half = 0.5f * mWidth * std::sqrt(dx * dx + dy * dy) / dx;
+    const int   xs = std::max(int(std::floor(x0)), cs);
+    const int   xe = std::min(int(std::ceil(x1)), ce);
+    for (int x = xs; x < xe; x++) {
+        const float a = std::max(x0, float(x));
+        const float b = std::min(x1, float(x + 1));
+        const float ya = y0 + (a - x0) * slope;
+        const float yb = y0 + (b - x0) * slope;
+        const int   ys =
+            std::max(int(std::floor(std::min(ya, yb) - half)), rs);
+        const int ye = std::min(int(std::ceil(std::max(ya, yb) + half)), re);
+        for (int y = ys; y < ye; y++) {
+            float area = (b - a) * (clampedMean(ya + half, yb + half, y) -
+                                    clampedMean(ya - half, yb - half, y));
+            if (steep)
+                plot(y, x, area);
+            else
+                plot(x, y, area);
+        }
+    }
+}
+
+/*
+ * the part of the polygon on one side of the line at v across x, or across
+ * y when not vertical, the side below v or above it. Returns the number of
+ * points written to out, one more than in at most.
+ */
+static int clipPolygon(const VPointF *in, int n, VPointF *out, bool vertical,
+                       float v, bool below)
+{
+    auto side = [=](const VPointF &p) {
+        const float c = vertical ? p.x() : p.y();
+        return below ? c <= v : c >= v;
+    };
+
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        const VPointF &p = in[i];
+        const VPointF &q = in[i + 1 == n ? 0 : i + 1];
+        const bool     inside = side(p);
+        if (inside) out[m++] = p;
+        if (inside != side(q)) {
+            const float pv = vertical ? p.x() : p.y();
+            const float qv = vertical ? q.x() : q.y();
+            out[m++] = p + (q - p) * ((v - pv) / (qv - pv));
+        }
+    }
+    return m;
+}
+
+static float polygonArea(const VPointF *p, int n)
+{
+    float area = 0;
+    for (int i = 0; i < n; i++) {
+        const VPointF &q = p[i + 1 == n ? 0 : i + 1];
+        area += p[i].x() * q.y() - q.x() * p[i].y();
+    }
+    return 0.5f * std::fabs(area);
+}
+
+/*
+ * the area of the triangle over each pixel, with sign. The triangle is cut
+ * to a row first and the row to each pixel, most are within one.
+ */
+void VHairlineRaster::addTriangle(const VPointF &a, const VPointF &b,
+                                  const VPointF &c, float sign)
+{
+    const VPointF tri[3] = {a, b, c};
+    int xs = int(std::floor(std::min(std::min(a.x(), b.x()), c.x())));
+    int xe = int(std::ceil(std::max(std::max(a.x(), b.x()), c.x())));
+    int ys = int(std::floor(std::min(std::min(a.y(), b.y()), c.y())));
+    int ye = int(std::ceil(std::max(std::max(a.y(), b.y()), c.y())));
+    if (xe - xs <= 1 && ye - ys <= 1) {
+        if (xs >= mClip.left() && xs < mClip.right() && ys >= mClip.top() &&
+            ys < mClip.bottom())
+            plot(xs, ys, sign * polygonArea(tri, 3));
+        return;
+    }
+    xs = std::max(xs, mClip.left());
+    xe = std::min(xe, mClip.right());
+    ys = std::max(ys, mClip.top());
+    ye = std::min(ye, mClip.bottom());
+
+    VPointF top[4], row[5], left[6], pixel[7];
+    for (int y = ys; y < ye; y++) {
+        int n = clipPolygon(tri, 3, top, false, float(y), false);
+        n = clipPolygon(top, n, row, false, float(y + 1), true);
+        if (!n) continue;
+
+        float x0 = row[0].x(), x1 = row[0].x();
+        for (int i = 1; i < n; i++) {
+            x0 = std::min(x0, row[i].x());
+            x1 = std::max(x1, row[i].x());
+        }
+        const int rs = std::max(int(std::floor(x0)), xs);
+        const int re = std::min(int(std::ceil(x1)), xe);
+        for (int x = rs; x < re; x++) {
+            int m = clipPolygon(row, n, left, true, float(x), false);
+            m = clipPolygon(left, m, pixel, true, float(x + 1), true);
+            if (m) plot(x, y, sign * polygonArea(pixel, m));
+        }
+    }
+}
+
+/*
+ * one side of the end of a band at j, d the unit direction into its body
+ * and side the distance of the side along the left normal of d. The end is
+ * cut along the line of normal to instead of the one of normal from, the
+ * two lines and the side make a triangle, added when it is inside the new
+ * cut and taken away when it was inside the old one.
+ */
+void VHairlineRaster::recut(const VPointF &j, const VPointF &d, float side,
+                            const VPointF &from, const VPointF &to)
+{
+    const VPointF n(-d.y(), d.x());
+    const float   t1 = -side * vDot(n, from) / vDot(d, from);
+    const float   t2 = -side * vDot(n, to) / vDot(d, to);
+    if (t1 == t2) return;
+
+    const VPointF q = j + n * side;
+    addTriangle(j, q + d * t1, q + d * t2, t1 > t2 ? 1 : -1);
+}
+
+// the open end of a band at j, cut across its direction d.
+void VHairlineRaster::end(const VPointF &j, const VPointF &d)
+{
+    const float half = mWidth / 2;
+    recut(j, d, -half, vMajor(d), d);
+    recut(j, d, half, vMajor(d), d);
+}
+
+/*
+ * the join at j of the line of direction a, at most len long, to the one
+ * of direction b. Both are cut on the bisector, the miter, and a bevel or
+ * round join is cut across the lines on the outer side and filled with the
+ * triangle between them, or two for the round one. When a line is too
+ * short for the bisector the inner sides still overlap a little. A small
+ * turn along the same axis keeps the cut the lines already share.
+ */
+void VHairlineRaster::join(const VPointF &j, const VPointF &a,
+                           const VPointF &b, float len)
+{
+    const float cross = a.x() * b.y() - a.y() * b.x();
+    const float dot = vDot(a, b);
+    if (dot > 0 && std::fabs(cross) < kFlatJoin && vSame(vMajor(a), vMajor(b)))
+        return;
+
+    const float   half = mWidth / 2;
+    const float   outer = cross > 0 ? -half : half;
+    const VPointF back(-a.x(), -a.y());
+    const VPointF bisector = a + b;
+    const VPointF na(-a.y(), a.x());
+    const VPointF nb(-b.y(), b.x());
+
+    // on the inner side the bisector, or as far back as the line reaches.
+    const bool reach = half * std::fabs(cross) < len * (1 + dot);
+    auto       inner = [&](const VPointF &d, float side) {
+        if (reach) return bisector;
+        const VPointF u = VPointF(-d.y(), d.x()) * side + d * len;
+        return VPointF(-u.y(), u.x());
+    };
+
+    // the sides of the line before are the other way round from j.
+    recut(j, back, outer, vMajor(a), inner(back, outer));
+    recut(j, b, -outer, vMajor(b), inner(b, -outer));
+    if (mJoin == JoinStyle::Miter &&
+        mMiterLimit * mMiterLimit * (1 + dot) >= 2) {
+        recut(j, back, -outer, vMajor(a), bisector);
+        recut(j, b, outer, vMajor(b), bisector);
+        return;
+    }
+
+    recut(j, back, -outer, vMajor(a), a);
+    recut(j, b, outer, vMajor(b), b);
+    const VPointF pa = j + na * outer;
+    const VPointF pb = j + nb * outer;
+    if (mJoin == JoinStyle::Round) {
+        const VPointF pm = j + vUnit(na + nb) * outer;
+        addTriangle(j, pa, pm, 1);
+        addTriangle(j, pm, pb, 1);
+    } else {
+        addTriangle(j, pa, pb, 1);
+    }
+}
+
+void VHairlineRaster::addCubic(VPointF p0, const VPointF &p1,
+                               const VPointF &p2, const VPointF &p3)
+{
+    // the polyline of n lines is within 3/4 * dd / n^2 of the curve.
+    float ddx = std::max(std::fabs(p0.x() - 2 * p1.x() + p2.x()),
+                         std::fabs(p1.x() - 2 * p2.x() + p3.x()));
+    float ddy = std::max(std::fabs(p0.y() - 2 * p1.y() + p2.y()),
+                         std::fabs(p1.y() - 2 * p2.y() + p3.y()));
+    float dd = std::sqrt(ddx * ddx + ddy * ddy);
+    int   n = std::min(1 + int(std::sqrt(dd * (0.75f / kTolerance))),
+                     kMaxCubicLines);
+
+    for (int i = 1; i < n; i++) {
+        float t = float(i) / n;
+        float mt = 1 - t;
+        float a = mt * mt * mt;
+        float b = 3 * mt * mt * t;
+        float c = 3 * mt * t * t;
+        float d = t * t * t;
+        addPoint({a * p0.x() + b * p1.x() + c * p2.x() + d * p3.x(),
+                  a * p0.y() + b * p1.y() + c * p2.y() + d * p3.y()});
+    }
+    addPoint(p3);
+}
+
+void VHairlineRaster::addPoint(const VPointF &p)
+{
+    if (mPoints.empty() || !vSame(mPoints.back(), p)) mPoints.push_back(p);
+}
+
+/*
+ * the lines of the polyline in mPoints, joined where they turn. The caps
+ * move the open ends outwards and an open polyline of no length is a dot
+ * of the cap.
+ */
+void VHairlineRaster::stroke(bool closed)
+{
+    if (closed && mPoints.size() > 1 && vSame(mPoints.front(), mPoints.back()))
+        mPoints.pop_back();
+
+    const size_t n = mPoints.size();
+    if (n == 1) {
+        const VPointF &p = mPoints[0];
+        if (!closed && mCap > 0)
+            addLine({p.x() - mCap, p.y()}, {p.x() + mCap, p.y()});
+        return;
+    }
+
+    auto &pts = mPoints;
+    if (!closed && mCap > 0) {
+        pts[0] += vUnit(pts[0] - pts[1]) * mCap;
+        pts[n - 1] += vUnit(pts[n - 1] - pts[n - 2]) * mCap;
+    }
+
+    // direction and length of the line from point i.
+    auto line = [&pts, n](size_t i, float &len) {
+        VPointF d = pts[(i + 1) % n] - pts[i];
+        len = std::sqrt(vDot(d, d));
+        return d * (1 / len);
+    };
+
+    const size_t lines = closed ? n : n - 1;
+    float        la = 0, lb = 0;
+    VPointF      a, b;
+    if (closed) a = line(n - 1, la);
+    for (size_t i = 0; i < lines; i++) {
+        addLine(pts[i], pts[(i + 1) % n]);
+        b = line(i, lb);
+        if (i > 0 || closed)
+            join(pts[i], a, b, std::min(la, lb));
+        else
+            end(pts[0], b);
+        a = b;
+        la = lb;
+    }
+    if (!closed) end(pts[n - 1], -a);
+}
+
+void VHairlineRaster::sort()
+{
+    /*
+     * two counting sorts, by x and then by y keeping the order of x, over
+     * the range of the cells.
+     */
+    uint32_t minX = 0xffff, maxX = 0, minY = 0xffff, maxY = 0;
+    for (uint64_t cell : mCells) {
+        uint32_t x = uint32_t(cell >> 32) & 0xffff;
+        uint32_t y = uint32_t(cell >> 48);
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+
+    mSorted.resize(mCells.size());
+    auto pass = [this](std::vector<uint64_t> &from, std::vector<uint64_t> &to,
+                       int shift, uint32_t min, uint32_t max) {
+        mCount.assign(max - min + 2, 0);
+        for (uint64_t cell : from)
+            mCount[((uint32_t(cell >> shift) & 0xffff) - min) + 1]++;
+        for (size_t i = 1; i < mCount.size(); i++) mCount[i] += mCount[i - 1];
+        for (uint64_t cell : from)
+            to[mCount[(uint32_t(cell >> shift) & 0xffff) - min]++] = cell;
+    };
+    pass(mCells, mSorted, 32, minX, maxX);
+    pass(mSorted, mCells, 48, minY, maxY);
+}
+
+bool VHairlineRaster::preferred(const VPath &path)
+{
+    /*
+     * a pixel here costs more than a cell of the stroker, whose outline
+     * only gets expensive with its joins and the offsets of its curves, so
+     * a short path of a few lines is left to the stroker.
+     */
+    const auto *pt = path.points().data();
+    VPointF     start, last;
+    float       length = 0;
+    int         cubics = 0;
+    for (auto e : path.elements()) {
+        switch (e) {
+        case VPath::Element::MoveTo:
+            start = last = *pt++;
+            break;
+        case VPath::Element::LineTo:
+            length += std::sqrt(vDot(*pt - last, *pt - last));
+            last = *pt++;
+            break;
+        case VPath::Element::CubicTo:
+            for (int i = 0; i < 3; i++) {
+                length += std::sqrt(vDot(*pt - last, *pt - last));
+                last = *pt++;
+            }
+            cubics++;
+            break;
+        case VPath::Element::Close:
+            length += std::sqrt(vDot(start - last, start - last));
+            last = start;
+            break;
+        }
+        if (length >= kMinLength || cubics >= kMinCubics) return true;
+    }
+    return false;
+}
+
+void VHairlineRaster::rasterize(const VPath &path, CapStyle cap,
+                                JoinStyle join, float width, float miterLimit,
+                                const VRect &clip, VRle &rle)
+{
+    rle.reset();
+
+    // same device as the cell rasterizer without a clip.
+    mClip = clip.empty() ? VRect(-32768, -32768, 65535, 65535) : clip;
+    mWidth = width;
+    mJoin = join;
+    mMiterLimit = miterLimit;
+    switch (cap) {
+    case CapStyle::Square:
+        mCap = width / 2;
+        break;
+    case CapStyle::Round:
+        // as long as the half disc.
+        mCap = kPi * width / 8;
+        break;
+    default:
+        mCap = 0;
+        break;
+    }
+    mCells.clear();
+    mPoints.clear();
+
+    // a contour is drawn once it has a line, and closed or not by what
+    // ends it.
+    const auto *pt = path.points().data();
+    VPointF     start;
+    bool        drawn = false;
+    for (auto e : path.elements()) {
+        switch (e) {
+        case VPath::Element::MoveTo:
+            if (drawn) stroke(false);
+            drawn = false;
+            mPoints.clear();
+            start = *pt++;
+            mPoints.push_back(start);
+            break;
+        case VPath::Element::LineTo:
+            addPoint(*pt++);
+            drawn = true;
+            break;
+        case VPath::Element::CubicTo:
+            addCubic(mPoints.back(), pt[0], pt[1], pt[2]);
+            pt += 3;
+            drawn = true;
+            break;
+        case VPath::Element::Close:
+            if (drawn) stroke(true);
+            drawn = false;
+            mPoints.clear();
+            mPoints.push_back(start);
+            break;
+        }
+    }
+    if (drawn) stroke(false);
+    if (mCells.empty()) return;
+
+    sort();
+
+    VRle::Span spans[256];
+    size_t     count = 0;
+    for (size_t i = 0; i < mCells.size();) {
+        const uint64_t key = mCells[i] >> 32;
+        int64_t        area = 0;
+        for (; i < mCells.size() && (mCells[i] >> 32) == key; i++)
+            area += int32_t(uint32_t(mCells[i]));
+
+        const uint8_t c =
+            uint8_t(std::min<int64_t>(std::max<int64_t>(area >> 8, 0), 255));
+        if (!c) continue;
+        const short x = short(int(key & 0xffff) - 32768);
+        const short y = short(int(key >> 16) - 32768);
+        if (count) {
+            VRle::Span &span = spans[count - 1];
+            if (span.y == y && span.x + span.len == x && span.coverage == c) {
+                span.len++;
+                continue;
+            }
+        }
+        if (count == sizeof(spans) / sizeof(spans[0])) {
+            rle.addSpan(spans, count);
+            count = 0;
+        }
+        VRle::Span &span = spans[count++];
+        span.x = x;
+        span.y = y;
+        span.len = 1;
+        span.coverage = c;
+    }
+    if (count) rle.addSpan(spans, count);
+}
+
+V_END_NAMESPACE
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VHAIRLINERASTER_H
+#define VHAIRLINERASTER_H
+#include <cstdint>
+#include <vector>
+#include "vglobal.h"
+#include "vpoint.h"
+#include "vrect.h"
+
+V_BEGIN_NAMESPACE
+
+class VPath;
+class VRle;
+
+/*
+ * Thin strokes drawn straight from the flattened path, without the outline
+ * of the stroker. Each line is a band of the stroke width and a pixel gets
+ * the area of the band over it, the lines of the path add up and the caps
+ * lengthen the open ends by the area they would cover. Where the lines
+ * turn their ends are cut again for the join.
+ */
+class VHairlineRaster {
+public:
+    // the widest stroke in pixels drawn here.
+    static constexpr float kMaxWidth = 1.5f;
+
+    // whether path is worth drawing here rather than with the stroker.
+    static bool preferred(const VPath &path);
+
+    void rasterize(const VPath &path, CapStyle cap, JoinStyle join,
+                   float width, float miterLimit, const VRect &clip, VRle &rle);
+
+private:
+    void addPoint(const VPointF &p);
+    void addCubic(VPointF p0, const VPointF &p1, const VPointF &p2,
+                  const VPointF &p3);
+    void stroke(bool closed);
+    void addLine(VPointF p0, VPointF p1);
+    void recut(const VPointF &j, const VPointF &d, float side,
+               const VPointF &from, const VPointF &to);
+    void end(const VPointF &j, const VPointF &d);
+    void join(const VPointF &j, const VPointF &a, const VPointF &b, float len);
+    void addTriangle(const VPointF &a, const VPointF &b, const VPointF &c,
+                     float sign);
+    void plot(int x, int y, float area);
+    void sort();
+
+private:
+    std::vector<VPointF>  mPoints;
+    std::vector<uint64_t> mCells;
+    std::vector<uint64_t> mSorted;
+    std::vector<uint32_t> mCount;
+    VRect                 mClip;
+    float                 mWidth{0};
+    float                 mCap{0};
+    float                 mMiterLimit{0};
+    JoinStyle             mJoin{JoinStyle::Miter};
+};
+
+V_END_NAMESPACE
+
+#endif  // VHAIRLINERASTER_H
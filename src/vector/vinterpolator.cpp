@@ -49,9 +49,44 @@ float VInterpolator::value(float aX) const
 {
     if (mX1 == mY1 && mX2 == mY2) return aX;
 
+    if (mTable && aX >= 0.0f && aX <= 1.0f) {
+        float pos = aX * kTableSize;
+        int   i = int(pos);
+        if (i == kTableSize) return mTable[kTableSize];
+        return mTable[i] + (pos - float(i)) * (mTable[i + 1] - mTable[i]);
+    }
+
+    return exactValue(aX);
+}
+
+float VInterpolator::exactValue(float aX) const
+{
     return CalcBezier(GetTForX(aX), mY1, mY2);
 }
 
+bool VInterpolator::buildTable(float maxError)
+{
+    if (mX1 == mY1 && mX2 == mY2) return false;
+
+    std::unique_ptr<float[]> table(new float[kTableSize + 1]);
+    for (int i = 0; i <= kTableSize; ++i) {
+        table[i] = exactValue(float(i) / kTableSize);
+    }
+
+    // the linear interpolation error is largest inside the intervals,
+    // check a few points of each one.
+    for (int i = 0; i < kTableSize; ++i) {
+        for (float f : {0.25f, 0.5f, 0.75f}) {
+            float x = (float(i) + f) / kTableSize;
+            float y = table[i] + f * (table[i + 1] - table[i]);
+            if (std::fabs(y - exactValue(x)) > maxError) return false;
+        }
+    }
+
+    mTable = std::move(table);
+    return true;
+}
+
 float VInterpolator::GetTForX(float aX) const
 {
     // Find interval where t lies
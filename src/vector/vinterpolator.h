@@ -23,6 +23,7 @@
 #ifndef VINTERPOLATOR_H
 #define VINTERPOLATOR_H
 
+#include <memory>
 #include "vpoint.h"
 
 V_BEGIN_NAMESPACE
@@ -47,6 +48,15 @@ public:
 
     float value(float aX) const;
 
+    /**
+     * Samples the easing curve in a table of kTableSize + 1 values so that
+     * value() becomes a lookup with linear interpolation instead of solving
+     * the bezier. The table is only kept if its error, checked between the
+     * samples, stays below maxError. Returns true if the table is used.
+     */
+    bool buildTable(float maxError = kTableMaxError);
+    bool hasTable() const { return bool(mTable); }
+
     void GetSplineDerivativeValues(float aX, float& aDX, float& aDY) const;
 
 private:
@@ -64,6 +74,8 @@ private:
 
     float GetTForX(float aX) const;
 
+    float exactValue(float aX) const;
+
     float NewtonRaphsonIterate(float aX, float aGuessT) const;
 
     float BinarySubdivide(float aX, float aA, float aB) const;
@@ -81,6 +93,10 @@ private:
     enum { kSplineTableSize = 11 };
     float              mSampleValues[kSplineTableSize];
     static const float kSampleStepSize;
+
+    enum { kTableSize = 256 };
+    static constexpr float   kTableMaxError = 0.0001f;
+    std::unique_ptr<float[]> mTable;
 };
 
 V_END_NAMESPACE
@@ -22,9 +22,16 @@
 
 #include "vmatrix.h"
 #include <vglobal.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 V_BEGIN_NAMESPACE
 
 /*  m11  m21  mtx
@@ -681,4 +688,93 @@ VPointF VMatrix::map(const VPointF &p) const
     return {x, y};
 }
 
+/*
+ * Affine map of an interleaved x,y array, the kernels keep the operation
+ * order of map() so the result is the same as mapping point by point.
+ * Each kernel returns the number of points it mapped.
+ */
+#if defined(__SSE2__)
+
+static size_t mapAffineKernel(const float *src, float *dst, size_t count,
+                              const float *m)
+{
+    const __m128 a = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    const __m128 b = _mm_setr_ps(m[2], m[3], m[2], m[3]);
+    const __m128 t = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128 p = _mm_loadu_ps(src + 2 * i);
+        __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+        p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, a), _mm_mul_ps(y, b)), t);
+        _mm_storeu_ps(dst + 2 * i, p);
+    }
+    return i;
+}
+
+#elif defined(__ARM_NEON__)
+
+static size_t mapAffineKernel(const float *src, float *dst, size_t count,
+                              const float *m)
+{
+    const float32x4_t tx = vdupq_n_f32(m[4]);
+    const float32x4_t ty = vdupq_n_f32(m[5]);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4x2_t p = vld2q_f32(src + 2 * i);
+        float32x4x2_t r;
+        r.val[0] = vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], m[0]),
+                                       vmulq_n_f32(p.val[1], m[2])),
+                             tx);
+        r.val[1] = vaddq_f32(vaddq_f32(vmulq_n_f32(p.val[0], m[1]),
+                                       vmulq_n_f32(p.val[1], m[3])),
+                             ty);
+        vst2q_f32(dst + 2 * i, r);
+    }
+    return i;
+}
+
+#else
+
+static size_t mapAffineKernel(const float *, float *, size_t, const float *)
+{
+    return 0;
+}
+
+#endif
+
+void VMatrix::map(const VPointF *src, VPointF *dst, size_t count) const
+{
+    VMatrix::MatrixType t = type();
+    if (t == MatrixType::None) {
+        if (src != dst) std::copy(src, src + count, dst);
+        return;
+    }
+    if (t == MatrixType::Project) {
+        for (size_t i = 0; i < count; i++) dst[i] = map(src[i]);
+        return;
+    }
+
+    // translate and scale are the affine map with the terms map() ignores
+    // for them set to 0 (type() treats the almost 0 ones as 0).
+    float m[6] = {1, 0, 0, 1, mtx, mty};
+    if (t != MatrixType::Translate) {
+        m[0] = m11;
+        m[3] = m22;
+    }
+    if (t != MatrixType::Translate && t != MatrixType::Scale) {
+        m[1] = m12;
+        m[2] = m21;
+    }
+    size_t i = mapAffineKernel(reinterpret_cast<const float *>(src),
+                               reinterpret_cast<float *>(dst), count, m);
+    for (; i < count; i++) {
+        float fx = src[i].x();
+        float fy = src[i].y();
+        dst[i] = {m[0] * fx + m[2] * fy + m[4], m[1] * fx + m[3] * fy + m[5]};
+    }
+}
+
 V_END_NAMESPACE
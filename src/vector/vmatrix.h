@@ -73,6 +73,8 @@ public:
     VPointF        map(const VPointF &p) const;
     inline VPointF map(float x, float y) const;
     VRect          map(const VRect &r) const;
+    // maps count points from src to dst, src and dst can be the same array.
+    void           map(const VPointF *src, VPointF *dst, size_t count) const;
 
     V_REQUIRED_RESULT VMatrix inverted(bool *invertible = nullptr) const;
     V_REQUIRED_RESULT VMatrix adjoint() const;
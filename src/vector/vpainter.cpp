@@ -49,18 +49,14 @@ namespace std {
 #endif
 
 // 引入Qt渲染器头文件，处理条件编译
-#if defined(LOTTIE_QT) || defined(__has_include)
-#  if defined(LOTTIE_QT) || __has_include("vpainter_qt.h")
-#    include "vpainter_qt.h"
-#    define HAS_QT_PAINTER 1
-#  endif
+#ifdef LOTTIE_QT
+#  include "vpainter_qt.h"
+#  define HAS_QT_PAINTER 1
 #endif
 
-#if defined(LOTTIE_VGLITE) || defined(__has_include)
-#  if defined(LOTTIE_VGLITE) || __has_include("vpainter_vglite.h")
-#    include "vpainter_vglite.h"
-#    define HAS_VGLITE_PAINTER 1
-#  endif
+#ifdef LOTTIE_VGLITE
+#  include "vpainter_vglite.h"
+#  define HAS_VGLITE_PAINTER 1
 #endif
 
 V_BEGIN_NAMESPACE
@@ -28,13 +28,17 @@
 #include "vline.h"
 #include "vrect.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 V_BEGIN_NAMESPACE
 
 void VPath::VPathData::transform(const VMatrix &m)
 {
-    for (auto &i : m_points) {
-        i = m.map(i);
-    }
+    m.map(m_points.data(), m_points.data(), m_points.size());
     mLengthDirty = true;
 }
 
@@ -691,9 +695,10 @@ void VPath::VPathData::addPath(const VPathData &path, const VMatrix *m)
         m_elements.reserve(m_elements.size() + path.m_elements.size());
 
     if (m) {
-        for (const auto &i : path.m_points) {
-            m_points.push_back(m->map(i));
-        }
+        size_t offset = m_points.size();
+        m_points.resize(offset + path.m_points.size());
+        m->map(path.m_points.data(), m_points.data() + offset,
+               path.m_points.size());
     } else {
         std::copy(path.m_points.begin(), path.m_points.end(),
                   back_inserter(m_points));
@@ -706,4 +711,82 @@ void VPath::VPathData::addPath(const VPathData &path, const VMatrix *m)
     mLengthDirty = true;
 }
 
+/*
+ * dst = start + t * (end - start) over an interleaved x,y array, the same
+ * operations as the VPointF lerp. Each kernel returns the number of floats
+ * it wrote.
+ */
+#if defined(__SSE2__)
+
+static size_t lerpKernel(float *dst, const float *start, const float *end,
+                         size_t count, float t)
+{
+    const __m128 vt = _mm_set1_ps(t);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 a = _mm_loadu_ps(start + i);
+        __m128 b = _mm_loadu_ps(end + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), vt)));
+    }
+    return i;
+}
+
+#elif defined(__ARM_NEON__)
+
+static size_t lerpKernel(float *dst, const float *start, const float *end,
+                         size_t count, float t)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t a = vld1q_f32(start + i);
+        float32x4_t b = vld1q_f32(end + i);
+        vst1q_f32(dst + i, vaddq_f32(a, vmulq_n_f32(vsubq_f32(b, a), t)));
+    }
+    return i;
+}
+
+#else
+
+static size_t lerpKernel(float *, const float *, const float *, size_t, float)
+{
+    return 0;
+}
+
+#endif
+
+void VPath::VPathData::addSpline(const VPointF *start, const VPointF *end,
+                                 size_t size, float t, bool closed)
+{
+    if (!size) return;
+
+    size_t cubics = (size - 1) / 3;
+    size = 1 + 3 * cubics;
+
+    // write the point and the element list once.
+    size_t offset = m_points.size();
+    reserve(size + 1, cubics + 3);
+    m_points.resize(offset + size);
+    VPointF *dst = m_points.data() + offset;
+    if (end) {
+        auto d = reinterpret_cast<float *>(dst);
+        auto s = reinterpret_cast<const float *>(start);
+        auto e = reinterpret_cast<const float *>(end);
+        for (size_t i = lerpKernel(d, s, e, 2 * size, t); i < 2 * size; i++)
+            d[i] = s[i] + (e[i] - s[i]) * t;
+    } else {
+        std::copy(start, start + size, dst);
+    }
+
+    m_elements.push_back(VPath::Element::MoveTo);
+    m_elements.insert(m_elements.end(), cubics, VPath::Element::CubicTo);
+
+    mStartPoint = dst[0];
+    mNewSegment = false;
+    m_segments++;
+    mLengthDirty = true;
+
+    if (closed) close();
+}
+
 V_END_NAMESPACE
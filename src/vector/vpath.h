@@ -68,6 +68,11 @@ public:
                      VPath::Direction dir = Direction::CW);
     void addPath(const VPath &path);
     void  addPath(const VPath &path, const VMatrix &m);
+    // adds a moveTo and the cubics of size bezier points (1 + 3 * n).
+    void  addSpline(const VPointF *points, size_t size, bool closed);
+    // same as above with the points lerped from start to end at t.
+    void  addSpline(const VPointF *start, const VPointF *end, size_t size,
+                    float t, bool closed);
     void  transform(const VMatrix &m);
     float length() const;
     const std::vector<VPath::Element> &elements() const;
@@ -104,6 +109,8 @@ private:
                          float startAngle, float cx, float cy,
                          VPath::Direction dir = Direction::CW);
         void  addPath(const VPathData &path, const VMatrix *m = nullptr);
+        void  addSpline(const VPointF *start, const VPointF *end, size_t size,
+                        float t, bool closed);
         void  clone(const VPath::VPathData &o) { *this = o;}
         const std::vector<VPath::Element> &elements() const
         {
@@ -197,6 +204,17 @@ inline void VPath::transform(const VMatrix &m)
     d.write().transform(m);
 }
 
+inline void VPath::addSpline(const VPointF *points, size_t size, bool closed)
+{
+    d.write().addSpline(points, nullptr, size, 0, closed);
+}
+
+inline void VPath::addSpline(const VPointF *start, const VPointF *end,
+                             size_t size, float t, bool closed)
+{
+    d.write().addSpline(start, end, size, t, closed);
+}
+
 inline void VPath::arcTo(const VRectF &rect, float startAngle,
                          float sweepLength, bool forceMoveTo)
 {
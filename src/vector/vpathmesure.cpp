@@ -21,17 +21,131 @@
  */
 
 #include "vpathmesure.h"
-#include <limits>
+#include <algorithm>
 #include "vbezier.h"
-#include "vdasher.h"
+#include "vline.h"
 
 V_BEGIN_NAMESPACE
 
+float VPathMesure::length(const VPath &path)
+{
+    if (!valid(path)) measure(path);
+    return mLength;
+}
+
+/*
+ * builds the cumulative length of the segments of each contour, the total
+ * length adds the segments in the same order as VPath::length().
+ */
+void VPathMesure::measure(const VPath &path)
+{
+    mMeasured = true;
+    mPointCount = path.points().size();
+    mLength = 0;
+    mSegments.clear();
+    mContours.clear();
+
+    const auto &pts = path.points();
+    size_t      i = 0;
+    float       length = 0;
+    for (auto e : path.elements()) {
+        switch (e) {
+        case VPath::Element::MoveTo:
+            mContours.push_back({mSegments.size(), mSegments.size()});
+            length = 0;
+            i++;
+            break;
+        case VPath::Element::LineTo: {
+            float len = VLine(pts[i - 1], pts[i]).length();
+            length += len;
+            mLength += len;
+            mSegments.push_back({length, i - 1, false});
+            mContours.back().mLast = mSegments.size();
+            i++;
+            break;
+        }
+        case VPath::Element::CubicTo: {
+            float len =
+                VBezier::fromPoints(pts[i - 1], pts[i], pts[i + 1], pts[i + 2])
+                    .length();
+            length += len;
+            mLength += len;
+            mSegments.push_back({length, i - 1, true});
+            mContours.back().mLast = mSegments.size();
+            i += 3;
+            break;
+        }
+        case VPath::Element::Close:
+            break;
+        }
+    }
+}
+
+/*
+ * adds the part [start --> end] of the segment, both are lengths from the
+ * segment start.
+ */
+void VPathMesure::addSegment(const VPath &path, const Segment &segment,
+                             float start, float end, float length, bool first)
+{
+    const VPointF *pt = path.points().data() + segment.mPoint;
+
+    if (segment.mCubic) {
+        VBezier b = VBezier::fromPoints(pt[0], pt[1], pt[2], pt[3]);
+        VBezier left;
+        if (end < length) {
+            b.parameterSplitLeft(b.tAtLength(end, length), &left);
+            b = left;
+        }
+        if (start > 0) b.parameterSplitLeft(b.tAtLength(start, end), &left);
+
+        if (first) mScratchObject.moveTo(b.pt1());
+        mScratchObject.cubicTo(b.pt2(), b.pt3(), b.pt4());
+    } else {
+        VLine line(pt[0], pt[1]), left, right;
+        if (end < length) {
+            line.splitAtLength(end, left, right);
+            line = left;
+        }
+        if (start > 0) {
+            line.splitAtLength(start, left, right);
+            line = right;
+        }
+
+        if (first) mScratchObject.moveTo(line.p1());
+        mScratchObject.lineTo(line.p2());
+    }
+}
+
+/*
+ * adds the part [start --> end] of the contour, the segments before start
+ * are skipped by a binary search over the length table.
+ */
+void VPathMesure::addRange(const VPath &path, const Contour &contour,
+                           float start, float end)
+{
+    if (!(start < end)) return;
+
+    auto first = mSegments.cbegin() + contour.mFirst;
+    auto last = mSegments.cbegin() + contour.mLast;
+    auto it = std::upper_bound(
+        first, last, start,
+        [](float length, const Segment &s) { return length < s.mEnd; });
+
+    for (bool head = true; it != last; ++it, head = false) {
+        float from = (it == first) ? 0 : (it - 1)->mEnd;
+        if (from >= end) break;
+        addSegment(path, *it, std::max(start, from) - from,
+                   std::min(end, it->mEnd) - from, it->mEnd - from, head);
+    }
+}
+
 /*
  * start and end value must be normalized to [0 - 1]
  * Path mesure trims the path from [start --> end]
  * if start > end it treates as a loop and trims as two segment
  *  [0-->end] and [start --> 1]
+ * like a dash pattern the range applies to each contour of the path.
  */
 VPath VPathMesure::trim(const VPath &path)
 {
@@ -41,27 +155,18 @@ VPath VPathMesure::trim(const VPath &path)
         (vCompare(mStart, 1.0f) && (vCompare(mEnd, 0.0f))))
         return path;
 
-    float length = path.length();
-
-    if (mStart < mEnd) {
-        float array[4] = {
-            0.0f, length * mStart,  // 1st segment
-            (mEnd - mStart) * length,
-            std::numeric_limits<float>::max(),  // 2nd segment
-        };
-        VDasher dasher(array, 4);
-        dasher.dashed(path, mScratchObject);
-        return mScratchObject;
-    } else {
-        float array[4] = {
-            length * mEnd, (mStart - mEnd) * length,  // 1st segment
-            (1 - mStart) * length,
-            std::numeric_limits<float>::max(),  // 2nd segment
-        };
-        VDasher dasher(array, 4);
-        dasher.dashed(path, mScratchObject);
-        return mScratchObject;
+    if (!valid(path)) measure(path);
+
+    mScratchObject.reset();
+    for (const auto &contour : mContours) {
+        if (mStart < mEnd) {
+            addRange(path, contour, mLength * mStart, mLength * mEnd);
+        } else {
+            addRange(path, contour, 0, mLength * mEnd);
+            addRange(path, contour, mLength * mStart, mLength);
+        }
     }
+    return mScratchObject;
 }
 
 V_END_NAMESPACE
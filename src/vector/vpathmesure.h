@@ -32,11 +32,43 @@ public:
     void setRange(float start, float end) {mStart = start; mEnd = end;}
     void  setStart(float start){mStart = start;}
     void  setEnd(float end){mEnd = end;}
+    /*
+     * the path is measured on the first use, the following calls reuse
+     * the length table till it is invalidated, so call invalidate()
+     * whenever the path passed in is not the same as the last time.
+     */
+    void  invalidate() { mMeasured = false; }
+    float length(const VPath &path);
     VPath trim(const VPath &path);
 private:
-    float mStart{0.0f};
-    float mEnd{1.0f};
-    VPath mScratchObject;
+    struct Segment {
+        float  mEnd;    // length from the contour start to the segment end
+        size_t mPoint;  // index of the segment start point
+        bool   mCubic;
+    };
+    struct Contour {
+        size_t mFirst;  // range of the contour in mSegments
+        size_t mLast;
+    };
+    // a table of another path must never be used to index its points.
+    bool valid(const VPath &path) const
+    {
+        return mMeasured && mPointCount == path.points().size();
+    }
+    void measure(const VPath &path);
+    void addRange(const VPath &path, const Contour &contour, float start,
+                  float end);
+    void addSegment(const VPath &path, const Segment &segment, float start,
+                    float end, float length, bool first);
+
+    float                mStart{0.0f};
+    float                mEnd{1.0f};
+    float                mLength{0.0f};
+    size_t               mPointCount{0};
+    bool                 mMeasured{false};
+    std::vector<Segment> mSegments;
+    std::vector<Contour> mContours;
+    VPath                mScratchObject;
 };
 
 V_END_NAMESPACE
@@ -20,16 +20,21 @@
  * SOFTWARE.
  */
 #include "vraster.h"
-#include <climits>
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <memory>
+#include <vector>
 #include "config.h"
 #include "v_ft_raster.h"
 #include "v_ft_stroker.h"
 #include "vdebug.h"
+#include "vdenseraster.h"
+#include "vhairlineraster.h"
 #include "vmatrix.h"
 #include "vpath.h"
 #include "vrle.h"
+#include "vshaperaster.h"
 
 V_BEGIN_NAMESPACE
 
@@ -58,27 +63,15 @@ struct FTOutline {
 public:
     void reset();
     void grow(size_t, size_t);
-    void convert(const VPath &path);
     void convert(CapStyle, JoinStyle, float, float);
-    void moveTo(const VPointF &pt);
-    void lineTo(const VPointF &pt);
-    void cubicTo(const VPointF &ctr1, const VPointF &ctr2, const VPointF end);
-    void close();
-    void end();
-    void transform(const VMatrix &m);
-    SW_FT_Pos TO_FT_COORD(float x)
-    {
-        return SW_FT_Pos(x * 64);
-    }  // to freetype 26.6 coordinate.
     SW_FT_Outline           ft;
-    bool                    closed{false};
     SW_FT_Stroker_LineCap   ftCap;
     SW_FT_Stroker_LineJoin  ftJoin;
     SW_FT_Fixed             ftWidth;
     SW_FT_Fixed             ftMiterLimit;
     dyn_array<SW_FT_Vector> mPointMemory{100};
     dyn_array<char>         mTagMemory{100};
-    dyn_array<short>        mContourMemory{10};
+    dyn_array<int>          mContourMemory{10};
     dyn_array<char>         mContourFlagMemory{10};
 };
 
@@ -102,36 +95,6 @@ void FTOutline::grow(size_t points, size_t segments)
     ft.contours_flag = mContourFlagMemory.data();
 }
 
-void FTOutline::convert(const VPath &path)
-{
-    const std::vector<VPath::Element> &elements = path.elements();
-    const std::vector<VPointF> &       points = path.points();
-
-    grow(points.size(), path.segments());
-
-    size_t index = 0;
-    for (auto element : elements) {
-        switch (element) {
-        case VPath::Element::MoveTo:
-            moveTo(points[index]);
-            index++;
-            break;
-        case VPath::Element::LineTo:
-            lineTo(points[index]);
-            index++;
-            break;
-        case VPath::Element::CubicTo:
-            cubicTo(points[index], points[index + 1], points[index + 2]);
-            index = index + 3;
-            break;
-        case VPath::Element::Close:
-            close();
-            break;
-        }
-    }
-    end();
-}
-
 void FTOutline::convert(CapStyle cap, JoinStyle join, float width,
                         float miterLimit)
 {
@@ -169,88 +132,27 @@ void FTOutline::convert(CapStyle cap, JoinStyle join, float width,
     }
 }
 
-void FTOutline::moveTo(const VPointF &pt)
-{
-    assert(ft.n_points <= SHRT_MAX - 1);
-
-    ft.points[ft.n_points].x = TO_FT_COORD(pt.x());
-    ft.points[ft.n_points].y = TO_FT_COORD(pt.y());
-    ft.tags[ft.n_points] = SW_FT_CURVE_TAG_ON;
-    if (ft.n_points) {
-        ft.contours[ft.n_contours] = ft.n_points - 1;
-        ft.n_contours++;
-    }
-    // mark the current contour as open
-    // will be updated if ther is a close tag at the end.
-    ft.contours_flag[ft.n_contours] = 1;
-
-    ft.n_points++;
-}
-
-void FTOutline::lineTo(const VPointF &pt)
-{
-    assert(ft.n_points <= SHRT_MAX - 1);
-
-    ft.points[ft.n_points].x = TO_FT_COORD(pt.x());
-    ft.points[ft.n_points].y = TO_FT_COORD(pt.y());
-    ft.tags[ft.n_points] = SW_FT_CURVE_TAG_ON;
-    ft.n_points++;
-}
-
-void FTOutline::cubicTo(const VPointF &cp1, const VPointF &cp2,
-                        const VPointF ep)
-{
-    assert(ft.n_points <= SHRT_MAX - 3);
-
-    ft.points[ft.n_points].x = TO_FT_COORD(cp1.x());
-    ft.points[ft.n_points].y = TO_FT_COORD(cp1.y());
-    ft.tags[ft.n_points] = SW_FT_CURVE_TAG_CUBIC;
-    ft.n_points++;
-
-    ft.points[ft.n_points].x = TO_FT_COORD(cp2.x());
-    ft.points[ft.n_points].y = TO_FT_COORD(cp2.y());
-    ft.tags[ft.n_points] = SW_FT_CURVE_TAG_CUBIC;
-    ft.n_points++;
-
-    ft.points[ft.n_points].x = TO_FT_COORD(ep.x());
-    ft.points[ft.n_points].y = TO_FT_COORD(ep.y());
-    ft.tags[ft.n_points] = SW_FT_CURVE_TAG_ON;
-    ft.n_points++;
-}
-void FTOutline::close()
-{
-    assert(ft.n_points <= SHRT_MAX - 1);
-
-    // mark the contour as a close path.
-    ft.contours_flag[ft.n_contours] = 0;
-
-    int index;
-    if (ft.n_contours) {
-        index = ft.contours[ft.n_contours - 1] + 1;
-    } else {
-        index = 0;
-    }
-
-    // make sure atleast 1 point exists in the segment.
-    if (ft.n_points == index) {
-        closed = false;
-        return;
-    }
-
-    ft.points[ft.n_points].x = ft.points[index].x;
-    ft.points[ft.n_points].y = ft.points[index].y;
-    ft.tags[ft.n_points] = SW_FT_CURVE_TAG_ON;
-    ft.n_points++;
-}
-
-void FTOutline::end()
+/*
+ * the path as the rasterizer and the stroker read it, the points are
+ * converted to 26.6 while they walk it.
+ */
+static_assert(uint8_t(VPath::Element::MoveTo) == SW_FT_PATH_MOVE_TO &&
+                  uint8_t(VPath::Element::LineTo) == SW_FT_PATH_LINE_TO &&
+                  uint8_t(VPath::Element::CubicTo) == SW_FT_PATH_CUBIC_TO &&
+                  uint8_t(VPath::Element::Close) == SW_FT_PATH_CLOSE,
+              "VPath elements don't match the SW_FT_Path ones");
+static_assert(sizeof(VPointF) == 2 * sizeof(float),
+              "VPointF isn't a pair of floats");
+
+static SW_FT_Path toFtPath(const VPath &path, int flags = 0)
 {
-    assert(ft.n_contours <= SHRT_MAX - 1);
-
-    if (ft.n_points) {
-        ft.contours[ft.n_contours] = ft.n_points - 1;
-        ft.n_contours++;
-    }
+    SW_FT_Path ftPath;
+    ftPath.n_elements = int(path.elements().size());
+    ftPath.elements =
+        reinterpret_cast<const unsigned char *>(path.elements().data());
+    ftPath.points = reinterpret_cast<const float *>(path.points().data());
+    ftPath.flags = flags;
+    return ftPath;
 }
 
 static void rleGenerationCb(int count, const SW_FT_Span *spans, void *user)
@@ -280,8 +182,56 @@ private:
     VRle _rle;
 };
 
+/*
+ * stroked outline in 26.6 kept after the rasterization, the stroker is the
+ * costly part of a stroke task and the outline of a copy that only differs
+ * by a similarity transform is the same outline transformed.
+ */
+struct StrokeOutline {
+    std::vector<SW_FT_Vector> mPoints;
+    std::vector<char>         mTags;
+    std::vector<int>          mContours;
+    std::vector<char>         mContourFlags;
+    int                       mFlags{0};
+    bool                      mValid{false};
+
+    void save(const SW_FT_Outline &ft)
+    {
+        mPoints.assign(ft.points, ft.points + ft.n_points);
+        mTags.assign(ft.tags, ft.tags + ft.n_points);
+        mContours.assign(ft.contours, ft.contours + ft.n_contours);
+        mContourFlags.assign(ft.contours_flag,
+                             ft.contours_flag + ft.n_contours);
+        mFlags = ft.flags;
+        mValid = true;
+    }
+
+    void load(FTOutline &outRef, const VMatrix &m) const
+    {
+        outRef.grow(mPoints.size(), mContours.size());
+        auto *pt = outRef.ft.points;
+        for (const auto &p : mPoints) {
+            float x = float(p.x), y = float(p.y);
+            pt->x = SW_FT_Pos(
+                std::lround(m.m_11() * x + m.m_21() * y + m.m_tx() * 64));
+            pt->y = SW_FT_Pos(
+                std::lround(m.m_12() * x + m.m_22() * y + m.m_ty() * 64));
+            pt++;
+        }
+        std::copy(mTags.begin(), mTags.end(), outRef.ft.tags);
+        std::copy(mContours.begin(), mContours.end(), outRef.ft.contours);
+        std::copy(mContourFlags.begin(), mContourFlags.end(),
+                  outRef.ft.contours_flag);
+        outRef.ft.n_points = int(mPoints.size());
+        outRef.ft.n_contours = int(mContours.size());
+        outRef.ft.flags = mFlags;
+    }
+};
+
 struct VRleTask {
-    SharedRle mRle;
+    SharedRle     mRle;
+    StrokeOutline mOutline;
+    bool          mKeepOutline{false};
     VPath     mPath;
     float     mStrokeWidth;
     float     mMiterLimit;
@@ -314,17 +264,17 @@ struct VRleTask {
         mClip = clip;
         mGenerateStroke = true;
     }
-    void render(FTOutline &outRef)
+    void render(const void *source, int flags)
     {
         SW_FT_Raster_Params params;
 
         mRle.unsafe().reset();
 
-        params.flags = SW_FT_RASTER_FLAG_DIRECT | SW_FT_RASTER_FLAG_AA;
+        params.flags = SW_FT_RASTER_FLAG_DIRECT | SW_FT_RASTER_FLAG_AA | flags;
         params.gray_spans = &rleGenerationCb;
         params.bbox_cb = &bboxCb;
         params.user = &mRle.unsafe();
-        params.source = &outRef.ft;
+        params.source = source;
 
         if (!mClip.empty()) {
             params.flags |= SW_FT_RASTER_FLAG_CLIP;
@@ -338,44 +288,90 @@ struct VRleTask {
         sw_ft_grays_raster.raster_render(nullptr, &params);
     }
 
-    void operator()(FTOutline &outRef, SW_FT_Stroker &stroker)
+    void render(FTOutline &outRef) { render(&outRef.ft, 0); }
+
+    bool renderShape()
     {
-        if (mPath.points().size() > SHRT_MAX ||
-            mPath.points().size() + mPath.segments() > SHRT_MAX) {
-            return;
-        }
+        VShapeRaster shape;
+        if (!shape.setPath(mPath) || !shape.preferred()) return false;
 
-        if (mGenerateStroke) {  // Stroke Task
-            outRef.convert(mPath);
-            outRef.convert(mCap, mJoin, mStrokeWidth, mMiterLimit);
+        shape.rasterize(mClip, mRle.unsafe());
+        return true;
+    }
 
-            uint32_t points, contors;
+    bool renderDense(VDenseRaster &dense, VRasterizer::Scanner scanner)
+    {
+        VRect bounds = VDenseRaster::bounds(mPath, mClip);
+        if (scanner == VRasterizer::Scanner::Auto &&
+            !VDenseRaster::preferred(mPath, bounds))
+            return false;
 
-            SW_FT_Stroker_Set(stroker, outRef.ftWidth, outRef.ftCap,
-                              outRef.ftJoin, outRef.ftMiterLimit);
-            SW_FT_Stroker_ParseOutline(stroker, &outRef.ft);
-            SW_FT_Stroker_GetCounts(stroker, &points, &contors);
+        dense.rasterize(mPath, bounds, mFillRule, mRle.unsafe());
+        return true;
+    }
 
-            outRef.grow(points, contors);
+    void renderStroke(FTOutline &outRef, SW_FT_Stroker &stroker)
+    {
+        SW_FT_Path path = toFtPath(mPath);
+        outRef.convert(mCap, mJoin, mStrokeWidth, mMiterLimit);
+
+        uint32_t points, contors;
+
+        SW_FT_Stroker_Set(stroker, outRef.ftWidth, outRef.ftCap, outRef.ftJoin,
+                          outRef.ftMiterLimit);
+        SW_FT_Stroker_ParsePath(stroker, &path);
+        SW_FT_Stroker_GetCounts(stroker, &points, &contors);
+
+        outRef.grow(points, contors);
+
+        SW_FT_Stroker_Export(stroker, &outRef.ft);
+
+        if (mKeepOutline) mOutline.save(outRef.ft);
 
-            SW_FT_Stroker_Export(stroker, &outRef.ft);
+        render(outRef);
+    }
+
+    bool renderHairline(VHairlineRaster &hairline, VRasterizer::Scanner scanner)
+    {
+        if (scanner != VRasterizer::Scanner::Auto ||
+            mStrokeWidth > VHairlineRaster::kMaxWidth ||
+            !VHairlineRaster::preferred(mPath))
+            return false;
+
+        hairline.rasterize(mPath, mCap, mJoin, mStrokeWidth, mMiterLimit, mClip,
+                           mRle.unsafe());
+        return true;
+    }
 
+    void operator()(FTOutline &outRef, SW_FT_Stroker &stroker,
+                    VDenseRaster &dense, VHairlineRaster &hairline,
+                    VRasterizer::Scanner scanner)
+    {
+        mOutline.mValid = false;
+
+        if (mGenerateStroke) {  // Stroke Task
+            if (!renderHairline(hairline, scanner))
+                renderStroke(outRef, stroker);
         } else {  // Fill Task
-            outRef.convert(mPath);
-            int fillRuleFlag = SW_FT_OUTLINE_NONE;
-            switch (mFillRule) {
-            case FillRule::EvenOdd:
-                fillRuleFlag = SW_FT_OUTLINE_EVEN_ODD_FILL;
-                break;
-            default:
-                fillRuleFlag = SW_FT_OUTLINE_NONE;
-                break;
+            bool done = false;
+            if (scanner == VRasterizer::Scanner::Auto) done = renderShape();
+            if (!done && scanner != VRasterizer::Scanner::Cell)
+                done = renderDense(dense, scanner);
+            if (!done) {
+                int fillRuleFlag = SW_FT_OUTLINE_NONE;
+                switch (mFillRule) {
+                case FillRule::EvenOdd:
+                    fillRuleFlag = SW_FT_OUTLINE_EVEN_ODD_FILL;
+                    break;
+                default:
+                    fillRuleFlag = SW_FT_OUTLINE_NONE;
+                    break;
+                }
+                SW_FT_Path path = toFtPath(mPath, fillRuleFlag);
+                render(&path, SW_FT_RASTER_FLAG_PATH);
             }
-            outRef.ft.flags = fillRuleFlag;
         }
 
-        render(outRef);
-
         mPath = VPath();
 
         mRle.notify();
@@ -387,8 +383,11 @@ using VTask = std::shared_ptr<VRleTask>;
 // 单线程版本：简化的光栅化任务调度器
 class RleTaskScheduler {
 public:
-    FTOutline     outlineRef{};
-    SW_FT_Stroker stroker;
+    FTOutline            outlineRef{};
+    SW_FT_Stroker        stroker;
+    VDenseRaster         dense;
+    VHairlineRaster      hairline;
+    VRasterizer::Scanner scanner{VRasterizer::Scanner::Auto};
 
 public:
     static bool IsRunning;
@@ -405,7 +404,10 @@ public:
 
     ~RleTaskScheduler() { SW_FT_Stroker_Done(stroker); }
 
-    void process(VTask task) { (*task)(outlineRef, stroker); }
+    void process(VTask task)
+    {
+        (*task)(outlineRef, stroker, dense, hairline, scanner);
+    }
 };
 
 bool RleTaskScheduler::IsRunning{false};
@@ -417,7 +419,12 @@ struct VRasterizer::VRasterizerImpl {
     VRleTask &task() { return mTask; }
 };
 
-VRle VRasterizer::rle()
+void VRasterizer::setScanner(Scanner scanner)
+{
+    RleTaskScheduler::instance().scanner = scanner;
+}
+
+VRle VRasterizer::rle() const
 {
     if (!d) return VRle();
     return d->rle();
@@ -451,12 +458,86 @@ void VRasterizer::rasterize(VPath path, CapStyle cap, JoinStyle join,
     init();
     if (path.empty() || vIsZero(width)) {
         d->rle().reset();
+        d->task().mOutline.mValid = false;
         return;
     }
     d->task().update(std::move(path), cap, join, width, miterLimit, clip);
     updateRequest();
 }
 
+struct TranslateData {
+    VRle * rle;
+    VPoint offset;
+};
+
+static void translateCb(size_t count, const VRle::Span *spans, void *user)
+{
+    auto          data = static_cast<TranslateData *>(user);
+    VRle::Span    buffer[256];
+    const short   dx = short(data->offset.x());
+    const short   dy = short(data->offset.y());
+    while (count) {
+        size_t n = std::min(count, sizeof(buffer) / sizeof(buffer[0]));
+        for (size_t i = 0; i < n; i++) {
+            buffer[i] = spans[i];
+            buffer[i].x += dx;
+            buffer[i].y += dy;
+        }
+        data->rle->addSpan(buffer, n);
+        spans += n;
+        count -= n;
+    }
+}
+
+void VRasterizer::rasterize(const VRasterizer &source, const VPoint &offset,
+                            const VRect &clip)
+{
+    init();
+    VRle &rle = d->rle();
+    rle.reset();
+    d->task().mOutline.mValid = false;
+
+    VRle src = source.rle();
+    if (src.empty()) return;
+
+    // only the spans that land inside the clip after the move.
+    VRect         rect = clip.empty() ? src.boundingRect()
+                                      : clip.translated(-offset.x(), -offset.y());
+    TranslateData data{&rle, offset};
+    src.intersect(rect, translateCb, &data);
+}
+
+void VRasterizer::keepOutline(bool keep)
+{
+    init();
+    d->task().mKeepOutline = keep;
+    if (!keep) d->task().mOutline = StrokeOutline();
+}
+
+bool VRasterizer::hasOutline() const
+{
+    return d && d->task().mOutline.mValid;
+}
+
+void VRasterizer::rasterize(const VRasterizer &source, const VMatrix &m,
+                            const VRect &clip)
+{
+    init();
+    if (!source.hasOutline()) {
+        d->rle().reset();
+        return;
+    }
+    auto &outRef = RleTaskScheduler::instance().outlineRef;
+    source.d->task().mOutline.load(outRef, m);
+
+    auto &task = d->task();
+    task.mClip = clip;
+    task.mOutline.mValid = false;
+    if (task.mKeepOutline) task.mOutline.save(outRef.ft);
+    task.render(outRef);
+    task.mRle.notify();
+}
+
 void lottieShutdownRasterTaskScheduler()
 {
     // 单线程版本：不需要关闭操作
@@ -30,14 +30,31 @@ V_BEGIN_NAMESPACE
 
 class VPath;
 class VRle;
+class VMatrix;
 
 class VRasterizer
 {
 public:
+    // scan converter of the fills, Auto picks one per path by its size and
+    // takes the coverage of rectangles and small corners from their area.
+    // Auto also draws the thin strokes without the stroker.
+    enum class Scanner { Auto, Cell, Dense };
+    static void setScanner(Scanner scanner);
+
     void rasterize(VPath path, FillRule fillRule = FillRule::Winding, const VRect &clip = VRect());
     void rasterize(VPath path, CapStyle cap, JoinStyle join, float width,
                    float miterLimit, const VRect &clip = VRect());
-    VRle rle();
+    // takes the coverage of source moved by offset, for the copies of a
+    // path that only differ from it by a pixel aligned translation.
+    void rasterize(const VRasterizer &source, const VPoint &offset,
+                   const VRect &clip = VRect());
+    // takes the stroke outline kept by source mapped by m, for the copies
+    // of a stroke that only differ from it by a similarity transform.
+    void rasterize(const VRasterizer &source, const VMatrix &m,
+                   const VRect &clip = VRect());
+    void keepOutline(bool keep);
+    bool hasOutline() const;
+    VRle rle() const;
 private:
     struct VRasterizerImpl;
     void init();
@@ -32,14 +32,18 @@
 #include "vdebug.h"
 #include "vglobal.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 V_BEGIN_NAMESPACE
 
 using Result = std::array<VRle::Span, 255>;
 using rle_view = VRle::View;
-static size_t _opGeneric(rle_view &a, rle_view &b, Result &result,
-                         VRle::Data::Op op);
 static size_t _opIntersect(const VRect &, rle_view &, Result &);
-static size_t _opIntersect(rle_view &, rle_view &, Result &);
+static size_t _opIntersect(rle_view &, rle_view &, VRle::Span *, size_t);
 
 static inline uint8_t divBy255(int x)
 {
@@ -56,10 +60,32 @@ inline static void copy(const VRle::Span *span, size_t count,
 
 void VRle::Data::addSpan(const VRle::Span *span, size_t count)
 {
+    // spans come row by row, the row index grows with them.
+    auto offset = uint32_t(mSpans.size());
     copy(span, count, mSpans);
+    for (size_t i = 0; i < count; i++) addRow(span[i].y, offset + uint32_t(i));
     mBboxDirty = true;
 }
 
+// the spans of row y start at offset, the rows skipped up to it are empty.
+void VRle::Data::addRow(int y, uint32_t offset)
+{
+    if (mRows.empty()) mTop = y;
+    while (bottom() <= y) mRows.push_back(offset);
+}
+
+VRle::View VRle::Data::rows(int top, int bottom) const
+{
+    auto start = [this](int y) -> size_t {
+        if (y <= mTop) return 0;
+        if (y >= this->bottom()) return mSpans.size();
+        return mRows[size_t(y - mTop)];
+    };
+    size_t first = start(top);
+    size_t last = std::max(start(bottom), first);
+    return VRle::View(mSpans.data() + first, last - first);
+}
+
 VRect VRle::Data::bbox() const
 {
     updateBbox();
@@ -75,6 +101,8 @@ void VRle::Data::setBbox(const VRect &bbox) const
 void VRle::Data::reset()
 {
     mSpans.clear();
+    mRows.clear();
+    mTop = 0;
     mBbox = VRect();
     mOffset = VPoint();
     mBboxDirty = false;
@@ -95,6 +123,7 @@ void VRle::Data::translate(const VPoint &p)
         i.x = i.x + x;
         i.y = i.y + y;
     }
+    mTop += y;
     updateBbox();
     mBbox.translate(mOffset.x(), mOffset.y());
 }
@@ -114,9 +143,10 @@ void VRle::Data::addRect(const VRect &rect)
         span.y = y + i;
         span.len = width;
         span.coverage = 255;
-        mSpans.push_back(span);
+        addSpan(&span, 1);
     }
     mBbox = rect;
+    mBboxDirty = false;
 }
 
 void VRle::Data::updateBbox() const
@@ -125,21 +155,19 @@ void VRle::Data::updateBbox() const
 
     mBboxDirty = false;
 
-    int               l = std::numeric_limits<int>::max();
-    const VRle::Span *span = mSpans.data();
-
     mBbox = VRect();
-    size_t sz = mSpans.size();
-    if (sz) {
-        int t = span[0].y;
-        int b = span[sz - 1].y;
-        int r = 0;
-        for (size_t i = 0; i < sz; i++) {
-            if (span[i].x < l) l = span[i].x;
-            if (span[i].x + span[i].len > r) r = span[i].x + span[i].len;
-        }
-        mBbox = VRect(l, t, r - l, b - t + 1);
+    if (mSpans.empty()) return;
+
+    // the spans of a row go left to right, its first and last bound it.
+    int l = std::numeric_limits<int>::max();
+    int r = std::numeric_limits<int>::min();
+    for (size_t i = 0; i < mRows.size(); i++) {
+        size_t last = (i + 1 < mRows.size()) ? mRows[i + 1] : mSpans.size();
+        if (last == mRows[i]) continue;
+        l = std::min(l, int(mSpans[mRows[i]].x));
+        r = std::max(r, mSpans[last - 1].x + mSpans[last - 1].len);
     }
+    mBbox = VRect(l, top(), r - l, bottom() - top());
 }
 
 void VRle::Data::operator*=(uint8_t alpha)
@@ -159,7 +187,8 @@ void VRle::Data::opIntersect(const VRect &r, VRle::VRleSpanCb cb,
         return;
     }
 
-    auto   obj = view();
+    // only the rows of the rect.
+    auto   obj = rows(r.top(), r.bottom());
     Result result;
     // run till all the spans are processed
     while (obj.size()) {
@@ -168,189 +197,84 @@ void VRle::Data::opIntersect(const VRect &r, VRle::VRleSpanCb cb,
     }
 }
 
-// res = a - b;
-void VRle::Data::opSubstract(const VRle::Data &aObj, const VRle::Data &bObj)
+/*
+ * This function will clip the rows of a rle with another rle, only the
+ * rows they both have spans in are visited.
+ * obj       : holds the list of spans that has to be clipped
+ * clip      : The rle that will be use to clip the rle
+ * NOTE: the result is handed to cb each time the buffer is full.
+ */
+static void _opIntersect(const VRle::Data &obj, const VRle::Data &clip,
+                         VRle::VRleSpanCb cb, void *userData)
 {
-    // if two rle are disjoint
-    if (!aObj.bbox().intersects(bObj.bbox())) {
-        mSpans = aObj.mSpans;
-    } else {
-        auto a = aObj.view();
-        auto b = bObj.view();
-
-        auto aPtr = a.data();
-        auto aEnd = a.data() + a.size();
-        auto bPtr = b.data();
-        auto bEnd = b.data() + b.size();
-
-        // 1. forward a till it intersects with b
-        while ((aPtr != aEnd) && (aPtr->y < bPtr->y)) aPtr++;
-        auto count = aPtr - a.data();
-        if (count) copy(a.data(), count, mSpans);
+    const int top = std::max(obj.top(), clip.top());
+    const int bottom = std::min(obj.bottom(), clip.bottom());
 
-        // 2. forward b till it intersects with a
-        if (aPtr != aEnd)
-            while ((bPtr != bEnd) && (bPtr->y < aPtr->y)) bPtr++;
-
-        // update a and b object
-        a = {aPtr, size_t(aEnd - aPtr)};
-        b = {bPtr, size_t(bEnd - bPtr)};
-
-        // 3. calculate the intersect region
-        Result result;
-
-        // run till all the spans are processed
+    Result result;
+    size_t count = 0;
+    for (int y = top; y < bottom; y++) {
+        auto a = obj.rows(y, y + 1);
+        auto b = clip.rows(y, y + 1);
         while (a.size() && b.size()) {
-            auto count = _opGeneric(a, b, result, Op::Substract);
-            if (count) copy(result.data(), count, mSpans);
+            count += _opIntersect(a, b, result.data() + count,
+                                  result.size() - count);
+            if (count == result.size()) {
+                cb(count, result.data(), userData);
+                count = 0;
+            }
         }
-
-        // 4. copy the rest of a
-        if (a.size()) copy(a.data(), a.size(), mSpans);
     }
-
-    mBboxDirty = true;
+    if (count) cb(count, result.data(), userData);
 }
 
-void VRle::Data::opGeneric(const VRle::Data &aObj, const VRle::Data &bObj,
-                           Op op)
+void VRle::Data::opIntersect(const VRle::Data &a, const VRle::Data &b)
 {
-    // This routine assumes, obj1(span_y) < obj2(span_y).
-
-    auto a = aObj.view();
-    auto b = bObj.view();
-
-    // reserve some space for the result vector.
-    mSpans.reserve(a.size() + b.size());
-
-    // if two rle are disjoint
-    if (!aObj.bbox().intersects(bObj.bbox())) {
-        if (a.data()[0].y < b.data()[0].y) {
-            copy(a.data(), a.size(), mSpans);
-            copy(b.data(), b.size(), mSpans);
-        } else {
-            copy(b.data(), b.size(), mSpans);
-            copy(a.data(), a.size(), mSpans);
-        }
-    } else {
-        auto aPtr = a.data();
-        auto aEnd = a.data() + a.size();
-        auto bPtr = b.data();
-        auto bEnd = b.data() + b.size();
-
-        // 1. forward a till it intersects with b
-        while ((aPtr != aEnd) && (aPtr->y < bPtr->y)) aPtr++;
-
-        auto count = aPtr - a.data();
-        if (count) copy(a.data(), count, mSpans);
-
-        // 2. forward b till it intersects with a
-        if (aPtr != aEnd)
-            while ((bPtr != bEnd) && (bPtr->y < aPtr->y)) bPtr++;
-
-        count = bPtr - b.data();
-        if (count) copy(b.data(), count, mSpans);
+    const int top = std::max(a.top(), b.top());
+    const int bottom = std::min(a.bottom(), b.bottom());
 
-        // update a and b object
-        a = {aPtr, size_t(aEnd - aPtr)};
-        b = {bPtr, size_t(bEnd - bPtr)};
-
-        // 3. calculate the intersect region
-        Result result;
-
-        // run till all the spans are processed
-        while (a.size() && b.size()) {
-            auto count = _opGeneric(a, b, result, op);
-            if (count) copy(result.data(), count, mSpans);
+    Result result;
+    for (int y = top; y < bottom; y++) {
+        auto rowA = a.row(y);
+        auto rowB = b.row(y);
+        auto offset = uint32_t(mSpans.size());
+        while (rowA.size() && rowB.size()) {
+            auto count =
+                _opIntersect(rowA, rowB, result.data(), result.size());
+            mSpans.insert(mSpans.end(), result.data(), result.data() + count);
         }
-        // 3. copy the rest
-        if (b.size()) copy(b.data(), b.size(), mSpans);
-        if (a.size()) copy(a.data(), a.size(), mSpans);
+        if (mSpans.size() > offset) addRow(y, offset);
     }
 
     mBboxDirty = true;
-}
-
-static inline V_ALWAYS_INLINE void _opIntersectPrepare(VRle::View &a,
-                                                       VRle::View &b)
-{
-    auto aPtr = a.data();
-    auto aEnd = a.data() + a.size();
-    auto bPtr = b.data();
-    auto bEnd = b.data() + b.size();
-
-    // 1. advance a till it intersects with b
-    while ((aPtr != aEnd) && (aPtr->y < bPtr->y)) aPtr++;
-
-    // 2. advance b till it intersects with a
-    if (aPtr != aEnd)
-        while ((bPtr != bEnd) && (bPtr->y < aPtr->y)) bPtr++;
-
-    // update a and b object
-    a = {aPtr, size_t(aEnd - aPtr)};
-    b = {bPtr, size_t(bEnd - bPtr)};
-}
-
-void VRle::Data::opIntersect(VRle::View a, VRle::View b)
-{
-    _opIntersectPrepare(a, b);
-    Result result;
-    while (a.size()) {
-        auto count = _opIntersect(a, b, result);
-        if (count) copy(result.data(), count, mSpans);
-    }
-
     updateBbox();
 }
 
-static void _opIntersect(rle_view a, rle_view b, VRle::VRleSpanCb cb,
-                         void *userData)
-{
-    if (!cb) return;
-
-    _opIntersectPrepare(a, b);
-    Result result;
-    while (a.size()) {
-        auto count = _opIntersect(a, b, result);
-        if (count) cb(count, result.data(), userData);
-    }
-}
-
 /*
- * This function will clip a rle list with another rle object
- * tmp_clip  : The rle list that will be use to clip the rle
- * tmp_obj   : holds the list of spans that has to be clipped
- * result    : will hold the result after the processing
- * NOTE: if the algorithm runs out of the result buffer list
- *       it will stop and update the tmp_obj with the span list
- *       that are yet to be processed as well as the tpm_clip object
+ * This function will clip a row of spans with the same row of another rle
+ * obj       : holds the list of spans that has to be clipped
+ * clip      : The spans of the row that will be use to clip the row
+ * out       : will hold the result after the processing
+ * NOTE: if the algorithm runs out of the available space
+ *       it will stop and update the obj with the span list
+ *       that are yet to be processed as well as the clip object
  *       with the unprocessed clip spans.
  */
 
-static size_t _opIntersect(rle_view &obj, rle_view &clip, Result &result)
+static size_t _opIntersect(rle_view &obj, rle_view &clip, VRle::Span *out,
+                           size_t available)
 {
-    auto out = result.data();
-    auto available = result.max_size();
-    auto spans = obj.data();
-    auto end = obj.data() + obj.size();
-    auto clipSpans = clip.data();
-    auto clipEnd = clip.data() + clip.size();
-    int  sx1, sx2, cx1, cx2, x, len;
+    const auto size = available;
+    auto       spans = obj.data();
+    auto       end = obj.data() + obj.size();
+    auto       clipSpans = clip.data();
+    auto       clipEnd = clip.data() + clip.size();
+    int        sx1, sx2, cx1, cx2, x, len;
 
     while (available && spans < end) {
         if (clipSpans >= clipEnd) {
             spans = end;
             break;
         }
-        if (clipSpans->y > spans->y) {
-            ++spans;
-            continue;
-        }
-        if (spans->y != clipSpans->y) {
-            ++clipSpans;
-            continue;
-        }
-        // assert(spans->y == (clipSpans->y + clip_offset_y));
         sx1 = spans->x;
         sx2 = sx1 + spans->len;
         cx1 = clipSpans->x;
@@ -386,7 +310,7 @@ static size_t _opIntersect(rle_view &obj, rle_view &clip, Result &result)
     // update the clip view yet to be processed
     clip = {clipSpans, size_t(clipEnd - clipSpans)};
 
-    return result.max_size() - available;
+    return size - available;
 }
 
 /*
@@ -442,12 +366,205 @@ static size_t _opIntersect(const VRect &clip, rle_view &obj, Result &result)
     return result.max_size() - available;
 }
 
+/*
+ * The line kernels blend the constant coverage of a span into len pixels
+ * of the 8-bit line, 16 at a time, the same math as the scalar loops of the
+ * blitters on 16-bit lanes. Each kernel returns the number of pixels it
+ * blended, the blitter finishes the rest.
+ */
+#if defined(__SSE2__)
+
+static inline __m128i divBy255(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_srli_epi16(x, 8));
+    x = _mm_add_epi16(x, _mm_set1_epi16(0x80));
+    return _mm_srli_epi16(x, 8);
+}
+
+// divBy255(d * a + (255 - d) * b) of the 16 pixels in d.
+static inline __m128i blend(__m128i d, __m128i a, __m128i b)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    __m128i       lo = _mm_unpacklo_epi8(d, zero);
+    __m128i       hi = _mm_unpackhi_epi8(d, zero);
+    lo = _mm_add_epi16(_mm_mullo_epi16(lo, a),
+                       _mm_mullo_epi16(_mm_sub_epi16(full, lo), b));
+    hi = _mm_add_epi16(_mm_mullo_epi16(hi, a),
+                       _mm_mullo_epi16(_mm_sub_epi16(full, hi), b));
+    return _mm_packus_epi16(divBy255(lo), divBy255(hi));
+}
+
+static int xorKernel(uint8_t *ptr, int len, uint8_t coverage)
+{
+    const __m128i a = _mm_set1_epi16(short(255 - coverage));
+    const __m128i b = _mm_set1_epi16(coverage);
+    int           i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(ptr + i));
+        _mm_storeu_si128((__m128i *)(ptr + i), blend(d, a, b));
+    }
+    return i;
+}
+
+static int destinationOutKernel(uint8_t *ptr, int len, uint8_t coverage)
+{
+    const __m128i a = _mm_set1_epi16(short(255 - coverage));
+    const __m128i b = _mm_setzero_si128();
+    int           i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(ptr + i));
+        _mm_storeu_si128((__m128i *)(ptr + i), blend(d, a, b));
+    }
+    return i;
+}
+
+static int srcOverKernel(uint8_t *ptr, int len, uint8_t coverage)
+{
+    const __m128i a = _mm_set1_epi16(short(255 - coverage));
+    const __m128i b = _mm_setzero_si128();
+    const __m128i c = _mm_set1_epi8(char(coverage));
+    int           i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(ptr + i));
+        _mm_storeu_si128((__m128i *)(ptr + i),
+                         _mm_add_epi8(c, blend(d, a, b)));
+    }
+    return i;
+}
+
+static int srcKernel(uint8_t *ptr, int len, uint8_t coverage)
+{
+    const __m128i c = _mm_set1_epi8(char(coverage));
+    int           i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(ptr + i));
+        _mm_storeu_si128((__m128i *)(ptr + i), _mm_max_epu8(c, d));
+    }
+    return i;
+}
+
+// the number of pixels in whole blocks of 16 from ptr that are all value.
+static int runKernel(const uint8_t *ptr, int len, uint8_t value)
+{
+    const __m128i v = _mm_set1_epi8(char(value));
+    int           i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(ptr + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(d, v)) != 0xffff) break;
+    }
+    return i;
+}
+
+#elif defined(__ARM_NEON__)
+
+static inline uint8x8_t divBy255(uint16x8_t x)
+{
+    x = vaddq_u16(x, vshrq_n_u16(x, 8));
+    return vshrn_n_u16(vaddq_u16(x, vdupq_n_u16(0x80)), 8);
+}
+
+// divBy255(d * a + (255 - d) * b) of the 16 pixels in d.
+static inline uint8x16_t blend(uint8x16_t d, uint8x8_t a, uint8x8_t b)
+{
+    uint8x16_t n = vmvnq_u8(d);
+    uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(d), a), vget_low_u8(n), b);
+    uint16x8_t hi =
+        vmlal_u8(vmull_u8(vget_high_u8(d), a), vget_high_u8(n), b);
+    return vcombine_u8(divBy255(lo), divBy255(hi));
+}
+
+static int xorKernel(uint8_t *ptr, int len, uint8_t coverage)
+{
+    const uint8x8_t a = vdup_n_u8(uint8_t(255 - coverage));
+    const uint8x8_t b = vdup_n_u8(coverage);
+    int             i = 0;
+    for (; i + 16 <= len; i += 16)
+        vst1q_u8(ptr + i, blend(vld1q_u8(ptr + i), a, b));
+    return i;
+}
+
+static int destinationOutKernel(uint8_t *ptr, int len, uint8_t coverage)
+{
+    const uint8x8_t a = vdup_n_u8(uint8_t(255 - coverage));
+    const uint8x8_t b = vdup_n_u8(0);
+    int             i = 0;
+    for (; i + 16 <= len; i += 16)
+        vst1q_u8(ptr + i, blend(vld1q_u8(ptr + i), a, b));
+    return i;
+}
+
+static int srcOverKernel(uint8_t *ptr, int len, uint8_t coverage)
+{
+    const uint8x8_t  a = vdup_n_u8(uint8_t(255 - coverage));
+    const uint8x8_t  b = vdup_n_u8(0);
+    const uint8x16_t c = vdupq_n_u8(coverage);
+    int              i = 0;
+    for (; i + 16 <= len; i += 16)
+        vst1q_u8(ptr + i, vaddq_u8(c, blend(vld1q_u8(ptr + i), a, b)));
+    return i;
+}
+
+static int srcKernel(uint8_t *ptr, int len, uint8_t coverage)
+{
+    const uint8x16_t c = vdupq_n_u8(coverage);
+    int              i = 0;
+    for (; i + 16 <= len; i += 16)
+        vst1q_u8(ptr + i, vmaxq_u8(c, vld1q_u8(ptr + i)));
+    return i;
+}
+
+// the number of pixels in whole blocks of 16 from ptr that are all value.
+static int runKernel(const uint8_t *ptr, int len, uint8_t value)
+{
+    const uint8x16_t v = vdupq_n_u8(value);
+    int              i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(ptr + i), v);
+        uint8x8_t  m = vand_u8(vget_low_u8(eq), vget_high_u8(eq));
+        if (vget_lane_u64(vreinterpret_u64_u8(m), 0) != ~uint64_t(0)) break;
+    }
+    return i;
+}
+
+#else
+
+static int xorKernel(uint8_t *, int, uint8_t)
+{
+    return 0;
+}
+
+static int destinationOutKernel(uint8_t *, int, uint8_t)
+{
+    return 0;
+}
+
+static int srcOverKernel(uint8_t *, int, uint8_t)
+{
+    return 0;
+}
+
+static int srcKernel(uint8_t *, int, uint8_t)
+{
+    return 0;
+}
+
+static int runKernel(const uint8_t *, int, uint8_t)
+{
+    return 0;
+}
+
+#endif
+
 static void blitXor(VRle::Span *spans, int count, uint8_t *buffer, int offsetX)
 {
     while (count--) {
         int    x = spans->x + offsetX;
         int    l = spans->len;
         uint8_t *ptr = buffer + x;
+        int    done = xorKernel(ptr, l, spans->coverage);
+        ptr += done;
+        l -= done;
         while (l--) {
             int da = *ptr;
             *ptr = divBy255((255 - spans->coverage) * (da) +
@@ -465,6 +582,9 @@ static void blitDestinationOut(VRle::Span *spans, int count, uint8_t *buffer,
         int    x = spans->x + offsetX;
         int    l = spans->len;
         uint8_t *ptr = buffer + x;
+        int    done = destinationOutKernel(ptr, l, spans->coverage);
+        ptr += done;
+        l -= done;
         while (l--) {
             *ptr = divBy255((255 - spans->coverage) * (*ptr));
             ptr++;
@@ -480,6 +600,9 @@ static void blitSrcOver(VRle::Span *spans, int count, uint8_t *buffer,
         int    x = spans->x + offsetX;
         int    l = spans->len;
         uint8_t *ptr = buffer + x;
+        int    done = srcOverKernel(ptr, l, spans->coverage);
+        ptr += done;
+        l -= done;
         while (l--) {
             *ptr = spans->coverage + divBy255((255 - spans->coverage) * (*ptr));
             ptr++;
@@ -494,6 +617,9 @@ void blitSrc(VRle::Span *spans, int count, uint8_t *buffer, int offsetX)
         int    x = spans->x + offsetX;
         int    l = spans->len;
         uint8_t *ptr = buffer + x;
+        int    done = srcKernel(ptr, l, spans->coverage);
+        ptr += done;
+        l -= done;
         while (l--) {
             *ptr = std::max(spans->coverage, *ptr);
             ptr++;
@@ -502,42 +628,48 @@ void blitSrc(VRle::Span *spans, int count, uint8_t *buffer, int offsetX)
     }
 }
 
+// a span for each run of the same non zero coverage in the buffer.
 size_t bufferToRle(uint8_t *buffer, int size, int offsetX, int y,
                    VRle::Span *out)
 {
     size_t count = 0;
-    uint8_t value = buffer[0];
-    int    curIndex = 0;
-
-    // size = offsetX < 0 ? size + offsetX : size;
-    for (int i = 0; i < size; i++) {
-        uint8_t curValue = buffer[0];
-        if (value != curValue) {
-            if (value) {
-                out->y = y;
-                out->x = offsetX + curIndex;
-                out->len = i - curIndex;
-                out->coverage = value;
-                out++;
-                count++;
-            }
-            curIndex = i;
-            value = curValue;
+    int    i = 0;
+    while (i < size) {
+        uint8_t value = buffer[i];
+        int     start = i++;
+        i += runKernel(buffer + i, size - i, value);
+        while (i < size && buffer[i] == value) i++;
+        if (value) {
+            out->y = y;
+            out->x = offsetX + start;
+            out->len = i - start;
+            out->coverage = value;
+            out++;
+            count++;
         }
-        buffer++;
-    }
-    if (value) {
-        out->y = y;
-        out->x = offsetX + curIndex;
-        out->len = size - curIndex;
-        out->coverage = value;
-        count++;
     }
     return count;
 }
 
+// copies the part of the spans of a row within [lo, hi) to out.
+static VRle::Span *clipRow(VRle::View row, int lo, int hi, VRle::Span *out)
+{
+    for (auto span = row.data(); span < row.data() + row.size(); span++) {
+        if (span->x >= hi) break;
+        int x1 = std::max(int(span->x), lo);
+        int x2 = std::min(span->x + span->len, hi);
+        if (x1 >= x2) continue;
+        *out = *span;
+        out->x = short(x1);
+        out->len = uint16_t(x2 - x1);
+        out++;
+    }
+    return out;
+}
+
 struct SpanMerger {
     explicit SpanMerger(VRle::Data::Op op)
+        : _keep(op != VRle::Data::Op::Substract)
     {
         switch (op) {
         case VRle::Data::Op::Add:
@@ -552,102 +684,134 @@ struct SpanMerger {
         }
     }
     using blitter = void (*)(VRle::Span *, int, uint8_t *, int);
-    blitter                     _blitter;
-    std::array<VRle::Span, 256> _result;
-    std::array<uint8_t, 1024>   _buffer;
-    VRle::Span *                _aStart{nullptr};
-    VRle::Span *                _bStart{nullptr};
+    blitter                 _blitter;
+    bool                    _keep;
+    std::vector<VRle::Span> _result;
+    std::vector<VRle::Span> _a;
+    std::vector<VRle::Span> _b;
+    std::vector<uint8_t>    _buffer;
 
-    void revert(VRle::Span *&aPtr, VRle::Span *&bPtr)
-    {
-        aPtr = _aStart;
-        bPtr = _bStart;
-    }
     VRle::Span *data() { return _result.data(); }
-    size_t merge(VRle::Span *&aPtr, const VRle::Span *aEnd, VRle::Span *&bPtr,
-                 const VRle::Span *bEnd);
+    size_t      merge(VRle::View a, VRle::View b);
 };
 
-size_t SpanMerger::merge(VRle::Span *&aPtr, const VRle::Span *aEnd,
-                         VRle::Span *&bPtr, const VRle::Span *bEnd)
+/*
+ * merges a row of a and the same row of b. Only where both have spans
+ * the coverage is combined in the buffer, the spans left and right of it
+ * are copied as they are.
+ */
+size_t SpanMerger::merge(VRle::View a, VRle::View b)
 {
-    assert(aPtr->y == bPtr->y);
+    assert(a.data()->y == b.data()->y);
 
-    _aStart = aPtr;
-    _bStart = bPtr;
-    int lb = std::min(aPtr->x, bPtr->x);
-    int y = aPtr->y;
+    const auto &aLast = a.data()[a.size() - 1];
+    const auto &bLast = b.data()[b.size() - 1];
+    int         left = std::min(a.data()->x, b.data()->x);
+    int         right = std::max(aLast.x + aLast.len, bLast.x + bLast.len);
+    int         lb = std::max(a.data()->x, b.data()->x);
+    int         ub = std::min(aLast.x + aLast.len, bLast.x + bLast.len);
+    int         length = ub - lb;
 
-    while (aPtr < aEnd && aPtr->y == y) aPtr++;
-    while (bPtr < bEnd && bPtr->y == y) bPtr++;
+    if (length <= 0) return 0;
 
-    int ub = std::max((aPtr - 1)->x + (aPtr - 1)->len,
-                      (bPtr - 1)->x + (bPtr - 1)->len);
-    int length = (lb < 0) ? ub + lb : ub - lb;
+    // the row splits a span at most twice, the buffer adds a span a pixel.
+    size_t spans = 2 * (a.size() + b.size()) + 2;
+    if (_result.size() < spans + size_t(length))
+        _result.resize(spans + size_t(length));
+    if (_a.size() < a.size()) _a.resize(a.size());
+    if (_b.size() < b.size()) _b.resize(b.size());
+    if (_buffer.size() < size_t(length)) _buffer.resize(length);
 
-    if (length <= 0 || size_t(length) >= _buffer.max_size()) {
-        // can't handle merge . skip
-        return 0;
-    }
+    auto out = clipRow(a, left, lb, _result.data());
+    if (_keep) out = clipRow(b, left, lb, out);
 
     // clear buffer
     memset(_buffer.data(), 0, length);
 
     // blit a to buffer
-    blitSrc(_aStart, aPtr - _aStart, _buffer.data(), -lb);
+    auto aEnd = clipRow(a, lb, ub, _a.data());
+    blitSrc(_a.data(), int(aEnd - _a.data()), _buffer.data(), -lb);
 
     // blit b to buffer
-    _blitter(_bStart, bPtr - _bStart, _buffer.data(), -lb);
+    auto bEnd = clipRow(b, lb, ub, _b.data());
+    _blitter(_b.data(), int(bEnd - _b.data()), _buffer.data(), -lb);
 
     // convert buffer to span
-    return bufferToRle(_buffer.data(), length, lb, y, _result.data());
+    out += bufferToRle(_buffer.data(), length, lb, a.data()->y, out);
+
+    out = clipRow(a, ub, right, out);
+    if (_keep) out = clipRow(b, ub, right, out);
+
+    return size_t(out - _result.data());
 }
 
-static size_t _opGeneric(rle_view &a, rle_view &b, Result &result,
-                         VRle::Data::Op op)
+// res = a - b;
+void VRle::Data::opSubstract(const VRle::Data &aObj, const VRle::Data &bObj)
 {
-    SpanMerger merger{op};
-
-    auto   out = result.data();
-    size_t available = result.max_size();
-    auto   aPtr = a.data();
-    auto   aEnd = a.data() + a.size();
-    auto   bPtr = b.data();
-    auto   bEnd = b.data() + b.size();
+    // if two rle are disjoint
+    if (!aObj.bbox().intersects(bObj.bbox())) {
+        addSpan(aObj.mSpans.data(), aObj.mSpans.size());
+    } else {
+        opGeneric(aObj, bObj, Op::Substract);
+    }
+}
 
+void VRle::Data::opGeneric(const VRle::Data &aObj, const VRle::Data &bObj,
+                           Op op)
+{
     // only logic change for substract operation.
-    const bool keep = op != (VRle::Data::Op::Substract);
-
-    while (available && aPtr < aEnd && bPtr < bEnd) {
-        if (aPtr->y < bPtr->y) {
-            *out++ = *aPtr++;
-            available--;
-        } else if (bPtr->y < aPtr->y) {
-            if (keep) {
-                *out++ = *bPtr;
-                available--;
-            }
-            bPtr++;
-        } else {  // same y
-            auto count = merger.merge(aPtr, aEnd, bPtr, bEnd);
-            if (available >= count) {
-                if (count) {
-                    memcpy(out, merger.data(), count * sizeof(VRle::Span));
-                    out += count;
-                    available -= count;
-                }
-            } else {
-                // not enough space try next time.
-                merger.revert(aPtr, bPtr);
-                break;
-            }
+    const bool keep = op != Op::Substract;
+
+    // reserve some space for the result vector.
+    mSpans.reserve(aObj.mSpans.size() + (keep ? bObj.mSpans.size() : 0));
+
+    auto copyRows = [this](const VRle::Data &obj, int top, int bottom) {
+        auto rows = obj.rows(top, bottom);
+        if (rows.size()) addSpan(rows.data(), rows.size());
+    };
+
+    /*
+     * the rows of one of them are taken as they are, the rows above and
+     * below the common ones in one go. The common rows are merged unless
+     * their spans are apart.
+     */
+    const int top = std::max(aObj.top(), bObj.top());
+    const int bottom = std::min(aObj.bottom(), bObj.bottom());
+
+    copyRows(aObj, aObj.top(), top);
+    if (keep) copyRows(bObj, bObj.top(), top);
+
+    SpanMerger merger{op};
+    for (int y = top; y < bottom; y++) {
+        auto a = aObj.rows(y, y + 1);
+        auto b = bObj.rows(y, y + 1);
+        if (!b.size()) {
+            if (a.size()) addSpan(a.data(), a.size());
+            continue;
+        }
+        if (!a.size()) {
+            if (keep) addSpan(b.data(), b.size());
+            continue;
+        }
+
+        const auto &aLast = a.data()[a.size() - 1];
+        const auto &bLast = b.data()[b.size() - 1];
+        if (aLast.x + aLast.len <= b.data()->x) {
+            addSpan(a.data(), a.size());
+            if (keep) addSpan(b.data(), b.size());
+        } else if (bLast.x + bLast.len <= a.data()->x) {
+            if (keep) addSpan(b.data(), b.size());
+            addSpan(a.data(), a.size());
+        } else {
+            auto count = merger.merge(a, b);
+            if (count) addSpan(merger.data(), count);
         }
     }
-    // update the span list that yet to be processed
-    a = {aPtr, size_t(aEnd - aPtr)};
-    b = {bPtr, size_t(bEnd - bPtr)};
 
-    return result.max_size() - available;
+    copyRows(aObj, std::max(top, bottom), aObj.bottom());
+    if (keep) copyRows(bObj, std::max(top, bottom), bObj.bottom());
+
+    mBboxDirty = true;
 }
 
 /*
@@ -692,7 +856,7 @@ VRle VRle::operator&(const VRle &o) const
     if (empty() || o.empty()) return {};
 
     Scratch_Object.reset();
-    Scratch_Object.opIntersect(d.read().view(), o.d.read().view());
+    Scratch_Object.opIntersect(d.read(), o.d.read());
 
     VRle result;
     result.d.write() = Scratch_Object;
@@ -708,7 +872,7 @@ void VRle::operator&=(const VRle &o)
         return;
     }
     Scratch_Object.reset();
-    Scratch_Object.opIntersect(d.read().view(), o.d.read().view());
+    Scratch_Object.opIntersect(d.read(), o.d.read());
     d.write() = Scratch_Object;
 }
 
@@ -733,7 +897,7 @@ VRle operator&(const VRect &rect, const VRle &o)
     Scratch_Object.addRect(rect);
 
     VRle result;
-    result.d.write().opIntersect(Scratch_Object.view(), o.d.read().view());
+    result.d.write().opIntersect(Scratch_Object, o.d.read());
 
     return result;
 }
@@ -742,7 +906,7 @@ void VRle::intersect(const VRle &clip, VRleSpanCb cb, void *userData) const
 {
     if (empty() || clip.empty()) return;
 
-    _opIntersect(d.read().view(), clip.d.read().view(), cb, userData);
+    _opIntersect(d.read(), clip.d.read(), cb, userData);
 }
 
 V_END_NAMESPACE
@@ -84,8 +84,20 @@ public:
         {
             return VRle::View(mSpans.data(), mSpans.size());
         }
+        VRle::View rows(int top, int bottom) const;
+        VRle::View row(int y) const
+        {
+            // y must be within [top, bottom).
+            auto   first = mRows[size_t(y - mTop)];
+            size_t last = (y + 1 < bottom()) ? mRows[size_t(y + 1 - mTop)]
+                                              : mSpans.size();
+            return VRle::View(mSpans.data() + first, last - first);
+        }
+        int   top() const { return mTop; }
+        int   bottom() const { return mTop + int(mRows.size()); }
         bool  empty() const { return mSpans.empty(); }
         void  addSpan(const VRle::Span *span, size_t count);
+        void  addRow(int y, uint32_t offset);
         void  updateBbox() const;
         VRect bbox() const;
         void  setBbox(const VRect &bbox) const;
@@ -94,12 +106,15 @@ public:
         void  operator*=(uint8_t alpha);
         void  opGeneric(const VRle::Data &, const VRle::Data &, Op code);
         void  opSubstract(const VRle::Data &, const VRle::Data &);
-        void  opIntersect(VRle::View a, VRle::View b);
+        void  opIntersect(const VRle::Data &, const VRle::Data &);
         void  opIntersect(const VRect &, VRle::VRleSpanCb, void *) const;
         void  addRect(const VRect &rect);
         void  clone(const VRle::Data &);
 
         std::vector<VRle::Span> mSpans;
+        // first span of each row from mTop, a row ends where the next starts.
+        std::vector<uint32_t>   mRows;
+        int                     mTop{0};
         VPoint                  mOffset;
         mutable VRect           mBbox;
         mutable bool            mBboxDirty = true;
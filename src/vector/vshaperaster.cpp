@@ -0,0 +1,479 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "vshaperaster.h"
+#include <algorithm>
+#include <cmath>
+#include "vpath.h"
+#include "vrle.h"
+
+V_BEGIN_NAMESPACE
+
+// how far the points may be off the shape, the precision of the cells.
+static constexpr float  kEpsilon = 1.0f / 64;
+static constexpr float  kKappa = 0.5522847498f;
+static constexpr double kPi = 3.14159265358979323846;
+static constexpr size_t kMaxElements = 32;
+
+static inline bool vNear(float a, float b)
+{
+    return std::fabs(a - b) < kEpsilon;
+}
+
+static inline bool vNear(const VPointF &a, const VPointF &b)
+{
+    return vNear(a.x(), b.x()) && vNear(a.y(), b.y());
+}
+
+namespace {
+
+/*
+ * the contour walked as the sides and corners of its bounds it goes along,
+ * in clockwise order. A shape visits each side (rectangle), each corner
+ * (ellipse) or both (rounded rectangle) once, in one direction.
+ */
+enum Position {
+    Top,
+    TopRight,
+    Right,
+    BottomRight,
+    Bottom,
+    BottomLeft,
+    Left,
+    TopLeft
+};
+
+struct Contour {
+    float    l, t, r, b;
+    float    rx{0}, ry{0};
+    int      orientation{0};
+    int      count{0};
+    Position positions[kMaxElements + 1];
+
+    bool add(Position position, int dir)
+    {
+        if (orientation && orientation != dir) return false;
+        orientation = dir;
+        if (!count || positions[count - 1] != position)
+            positions[count++] = position;
+        return true;
+    }
+
+    bool line(const VPointF &p, const VPointF &q)
+    {
+        if (vNear(p, q)) return true;
+
+        float dx = q.x() - p.x();
+        float dy = q.y() - p.y();
+        if (vNear(p.y(), q.y())) {
+            if (vNear(p.y(), t)) return add(Top, dx > 0 ? 1 : -1);
+            if (vNear(p.y(), b)) return add(Bottom, dx < 0 ? 1 : -1);
+        } else if (vNear(p.x(), q.x())) {
+            if (vNear(p.x(), r)) return add(Right, dy > 0 ? 1 : -1);
+            if (vNear(p.x(), l)) return add(Left, dy < 0 ? 1 : -1);
+        }
+        return false;
+    }
+
+    bool onHorizontal(const VPointF &p) const
+    {
+        return vNear(p.y(), t) || vNear(p.y(), b);
+    }
+
+    bool onVertical(const VPointF &p) const
+    {
+        return vNear(p.x(), l) || vNear(p.x(), r);
+    }
+
+    // a quarter of an ellipse from a side to the next one.
+    bool cubic(const VPointF &p, const VPointF &c1, const VPointF &c2,
+               const VPointF &q)
+    {
+        VPointF k;
+        if (onHorizontal(p) && onVertical(q))
+            k = VPointF(q.x(), p.y());
+        else if (onVertical(p) && onHorizontal(q))
+            k = VPointF(p.x(), q.y());
+        else
+            return false;
+
+        if (!vNear(c1, p + kKappa * (k - p)) || !vNear(c2, q + kKappa * (k - q)))
+            return false;
+
+        float cx = std::fabs(p.x() - q.x());
+        float cy = std::fabs(p.y() - q.y());
+        if (cx < kEpsilon || cy < kEpsilon) return false;
+        if (rx == 0) {
+            rx = cx;
+            ry = cy;
+        } else if (!vNear(rx, cx) || !vNear(ry, cy)) {
+            return false;
+        }
+
+        float    cross = (k.x() - p.x()) * (q.y() - k.y()) -
+                      (k.y() - p.y()) * (q.x() - k.x());
+        Position position;
+        if (vNear(k.y(), t))
+            position = vNear(k.x(), r) ? TopRight : TopLeft;
+        else
+            position = vNear(k.x(), r) ? BottomRight : BottomLeft;
+        return add(position, cross > 0 ? 1 : -1);
+    }
+
+    // one turn in one direction through all the sides or all the corners.
+    bool closed()
+    {
+        while (count > 1 && positions[0] == positions[count - 1]) count--;
+
+        int turn = 0, corners = 0, sides = 0;
+        for (int i = 0; i < count; i++) {
+            int step = (orientation * (positions[(i + 1) % count] -
+                                       positions[i]) + 8) % 8;
+            if (step != 1 && step != 2) return false;
+            turn += step;
+            (positions[i] % 2 ? corners : sides)++;
+        }
+        return turn == 8 && (rx > 0 ? corners == 4 : sides == 4);
+    }
+};
+
+}  // namespace
+
+bool VShapeRaster::setPath(const VPath &path)
+{
+    const auto &elements = path.elements();
+    const auto &points = path.points();
+    if (elements.size() < 3 || elements.size() > kMaxElements ||
+        elements[0] != VPath::Element::MoveTo)
+        return false;
+
+    Contour contour;
+    contour.l = contour.r = points[0].x();
+    contour.t = contour.b = points[0].y();
+    for (const auto &p : points) {
+        contour.l = std::min(contour.l, p.x());
+        contour.r = std::max(contour.r, p.x());
+        contour.t = std::min(contour.t, p.y());
+        contour.b = std::max(contour.b, p.y());
+    }
+    if (!std::isfinite(contour.l) || !std::isfinite(contour.r) ||
+        !std::isfinite(contour.t) || !std::isfinite(contour.b) ||
+        contour.r - contour.l < kEpsilon || contour.b - contour.t < kEpsilon)
+        return false;
+
+    const VPointF *pt = points.data() + 1;
+    VPointF        last = points[0];
+    for (size_t i = 1; i < elements.size(); i++) {
+        switch (elements[i]) {
+        case VPath::Element::MoveTo:
+            return false;
+        case VPath::Element::LineTo:
+            if (!contour.line(last, *pt)) return false;
+            last = *pt++;
+            break;
+        case VPath::Element::CubicTo:
+            if (!contour.cubic(last, pt[0], pt[1], pt[2])) return false;
+            last = pt[2];
+            pt += 3;
+            break;
+        case VPath::Element::Close:
+            if (i + 1 != elements.size()) return false;
+            break;
+        }
+    }
+    if (!contour.line(last, points[0]) || !contour.closed()) return false;
+
+    mLeft = contour.l;
+    mTop = contour.t;
+    mRight = contour.r;
+    mBottom = contour.b;
+    mRx = std::min(double(contour.rx), (mRight - mLeft) / 2);
+    mRy = std::min(double(contour.ry), (mBottom - mTop) / 2);
+    if (mRx == 0 || mRy == 0) mRx = mRy = 0;
+    return true;
+}
+
+bool VShapeRaster::preferred() const
+{
+    /*
+     * the rows of the straight part cost next to nothing but a pixel on
+     * the border of a corner integrates the ellipse, a few times the cost
+     * of a cell. Ellipses and large corners are left to the scan converters.
+     */
+    const double curved = kPi * (mRx + mRy);
+    const double straight =
+        2 * (mRight - mLeft - 2 * mRx) + 2 * (mBottom - mTop - 2 * mRy);
+    return 4 * curved <= straight;
+}
+
+// integral of sqrt(1 - v^2).
+static inline double halfChord(double v)
+{
+    return 0.5 * (v * std::sqrt(1 - v * v) + std::asin(v));
+}
+
+/*
+ * halfChord(b) - halfChord(a) from the two ends and their sqrt(1 - v^2),
+ * asin(b) - asin(a) is asin(b * sa - a * sb) which is a short series for
+ * the small steps from a pixel to the next.
+ */
+static inline double halfChordDelta(double a, double sa, double b, double sb)
+{
+    double z = b * sa - a * sb;
+    double angle;
+    if (std::fabs(z) > 0.125) {
+        angle = std::asin(z);
+    } else {
+        double z2 = z * z;
+        angle = z * (1 + z2 * (1.0 / 6 +
+                               z2 * (3.0 / 40 +
+                                     z2 * (5.0 / 112 + z2 * (35.0 / 1152)))));
+    }
+    return 0.5 * (b * sb - a * sa + angle);
+}
+
+struct VShapeRaster::Spans {
+    VRle::Span spans[256];
+    size_t     count{0};
+    VRle &     rle;
+
+    explicit Spans(VRle &rle) : rle(rle) {}
+    ~Spans() { flush(); }
+    void flush()
+    {
+        if (count) rle.addSpan(spans, count);
+        count = 0;
+    }
+    // room for n more spans in a row.
+    void reserve(size_t n)
+    {
+        if (count + n > sizeof(spans) / sizeof(spans[0])) flush();
+    }
+    void add(int x, int y, int len, int coverage)
+    {
+        if (count) {
+            VRle::Span &last = spans[count - 1];
+            if (last.y == y && last.x + last.len == x &&
+                last.coverage == coverage) {
+                last.len = uint16_t(last.len + len);
+                return;
+            }
+        }
+        reserve(1);
+        VRle::Span &span = spans[count++];
+        span.x = short(x);
+        span.y = short(y);
+        span.len = uint16_t(len);
+        span.coverage = uint8_t(coverage);
+    }
+};
+
+/*
+ * the rows of the corners are the same above and below the straight part,
+ * both are kept as a band of the lower half of the unit circle. The
+ * integrals at the ends of the bands carry on from the ones of the
+ * previous row.
+ */
+VShapeRaster::Row VShapeRaster::row(int y, const Row &prev) const
+{
+    const double top = mTop + mRy;
+    const double bottom = mBottom - mRy;
+
+    Row r;
+    r.y0 = std::max(double(y), mTop);
+    r.y1 = std::min(double(y + 1), mBottom);
+    r.straight = std::max(std::min(r.y1, bottom) - std::max(r.y0, top), 0.0);
+    r.bands = 0;
+    if (mRy == 0) return r;
+
+    const double scale = 1 / mRy;
+    // sqrt(1 - v^2) and its integral at v.
+    auto point = [&](double v, double &s, double &h) {
+        const Row::Band &p = prev.band[0];
+        if (prev.bands && v == p.v0) {
+            s = p.s0;
+            h = p.h0;
+        } else if (prev.bands && v == p.v1) {
+            s = p.s1;
+            h = p.h1;
+        } else {
+            s = std::sqrt(1 - v * v);
+            h = prev.bands ? p.h0 + halfChordDelta(p.v0, p.s0, v, s)
+                           : halfChord(v);
+        }
+    };
+    auto band = [&](double c0, double c1) {
+        if (c1 <= c0) return;
+        Row::Band &b = r.band[r.bands++];
+        b.v0 = std::min(c0 * scale, 1.0);
+        b.v1 = std::min(c1 * scale, 1.0);
+        point(b.v0, b.s0, b.h0);
+        point(b.v1, b.s1, b.h1);
+        b.height = c1 - c0;
+    };
+    band(std::max(top - r.y1, 0.0), top - r.y0);
+    band(std::max(r.y0 - bottom, 0.0), r.y1 - bottom);
+    return r;
+}
+
+/*
+ * the pixels of the row from the area of the shape left of each of their
+ * sides. The rounded rectangle is its straight part and, in the rows of the
+ * corners, a horizontal band between two halves of the ellipse of the
+ * corners. The unit circle is [-s, s] with s = sqrt(1 - v^2) in each row of
+ * a band, its area left of u is u + s up to v = w where the circle crosses
+ * u, and 0 (u < 0) or 2s (u > 0) from there. The walk starts left of the
+ * shape and jumps over the interior [fs, fe) where every band is crossed.
+ */
+void VShapeRaster::scanline(const Row &r, int xs, int fs, int fe, int xe,
+                            int y, Spans &spans) const
+{
+    const double left = mLeft + mRx;
+    const double right = mRight - mRx;
+    const double scale = mRx > 0 ? 1 / mRx : 0;
+    const double radii = mRx * mRy;
+    // where the crossing of each band ends and the integral up to there.
+    double end[2], send[2], crossed[2];
+
+    auto area = [&](double x) {
+        double a = (std::min(std::max(x, mLeft), mRight) - mLeft) * r.straight;
+        if (!r.bands) return a;
+
+        const double xc = std::min(std::max(x, left), right);
+        const double u = (x - xc) * scale;
+        const double au = std::min(std::fabs(u), 1.0);
+        const double w = au < 1 ? std::sqrt(1 - au * au) : 0;
+        for (int i = 0; i < r.bands; i++) {
+            const Row::Band &b = r.band[i];
+            const double     chord = b.h1 - b.h0;
+            const bool       below = w <= b.v0, above = w >= b.v1;
+            const double     e = below ? b.v0 : above ? b.v1 : w;
+            const double     se = below ? b.s0 : above ? b.s1 : au;
+            const double     c =
+                crossed[i] + halfChordDelta(end[i], send[i], e, se);
+            crossed[i] = below ? 0 : above ? chord : c;
+            end[i] = e;
+            send[i] = se;
+            double circle = u * (e - b.v0) + crossed[i] +
+                            (u > 0 ? 2 * (chord - crossed[i]) : 0);
+            a += (xc - left) * b.height + radii * circle;
+        }
+        return a;
+    };
+    auto border = [&](int x0, int x1, double prev) {
+        for (int x = x0; x < x1; x++) {
+            double next = area(x + 1);
+            int    coverage = std::min(int((next - prev) * 256), 255);
+            if (coverage > 0) spans.add(x, y, 1, coverage);
+            prev = next;
+        }
+        return prev;
+    };
+
+    // nothing of the shape is left of xs unless the clip is, the crossings
+    // start at the top of the bands.
+    double prev = 0;
+    for (int i = 0; i < r.bands; i++) {
+        end[i] = r.band[i].v0;
+        send[i] = r.band[i].s0;
+        crossed[i] = 0;
+    }
+    if (xs > std::floor(left - mRx)) prev = area(xs);
+    prev = border(xs, fs, prev);
+
+    if (fs < fe) {
+        const double height = r.y1 - r.y0;
+        const int    coverage = std::min(int(height * 256), 255);
+        if (coverage > 0) spans.add(fs, y, fe - fs, coverage);
+        prev += (fe - fs) * height;
+        for (int i = 0; i < r.bands; i++) {
+            end[i] = r.band[i].v1;
+            send[i] = r.band[i].s1;
+            crossed[i] = r.band[i].h1 - r.band[i].h0;
+        }
+    }
+    border(fe, xe, prev);
+}
+
+void VShapeRaster::rasterize(const VRect &clip, VRle &rle) const
+{
+    rle.reset();
+
+    // same device as the cell rasterizer without a clip.
+    const VRect device =
+        clip.empty() ? VRect(-32768, -32768, 65535, 65535) : clip;
+    const int    ys = std::max(int(std::floor(mTop)), device.top());
+    const int    ye = std::min(int(std::ceil(mBottom)), device.bottom());
+    const double left = mLeft + mRx;
+    const double right = mRight - mRx;
+
+    Spans spans(rle);
+    // the spans of a full row of the straight part, the same in all of them.
+    VRle::Span straight[5];
+    size_t     straightCount = 0;
+    bool       straightDone = false;
+
+    Row r;
+    r.bands = 0;
+    for (int y = ys; y < ye; y++) {
+        r = row(y, r);
+
+        const bool full = r.y0 == y && r.y1 == y + 1 && r.straight == 1;
+        if (full && straightDone) {
+            spans.reserve(straightCount);
+            for (size_t i = 0; i < straightCount; i++) {
+                spans.spans[spans.count] = straight[i];
+                spans.spans[spans.count++].y = short(y);
+            }
+            continue;
+        }
+
+        // the widest and the narrowest extent of the shape in the row.
+        double smin = 1, smax = r.straight > 0 ? 1 : 0;
+        for (int i = 0; i < r.bands; i++) {
+            smin = std::min(smin, r.band[i].s1);
+            smax = std::max(smax, r.band[i].s0);
+        }
+        const int xs =
+            std::max(int(std::floor(left - mRx * smax)), device.left());
+        const int xe =
+            std::min(int(std::ceil(right + mRx * smax)), device.right());
+        if (xs >= xe) continue;
+
+        int fs = std::max(int(std::ceil(left - mRx * smin)), xs);
+        int fe = std::min(int(std::floor(right + mRx * smin)), xe);
+        if (fs >= fe) fs = fe = xe;
+
+        spans.reserve(sizeof(straight) / sizeof(straight[0]));
+        size_t first = spans.count;
+        scanline(r, xs, fs, fe, xe, y, spans);
+
+        // at most two border pixels on each side of a straight row.
+        if (full && spans.count >= first &&
+            spans.count - first <= sizeof(straight) / sizeof(straight[0])) {
+            straightCount = spans.count - first;
+            std::copy(spans.spans + first, spans.spans + spans.count, straight);
+            straightDone = true;
+        }
+    }
+}
+
+V_END_NAMESPACE
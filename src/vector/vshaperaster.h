@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VSHAPERASTER_H
+#define VSHAPERASTER_H
+#include "vglobal.h"
+#include "vrect.h"
+
+V_BEGIN_NAMESPACE
+
+class VPath;
+class VRle;
+
+/*
+ * Coverage of the axis aligned rectangles, rounded rectangles and ellipses
+ * computed from their exact area in each pixel, the interior of a row is a
+ * single full span and only the pixels on the border are integrated. Meant
+ * for the paths of the rect, ellipse and solid layers under a scale and
+ * translate transform, the shape is recognized from the path itself so
+ * anything else is left to the scan converters.
+ */
+class VShapeRaster {
+public:
+    // false if path isn't a single contour of one of the shapes.
+    bool setPath(const VPath &path);
+    // whether the shape is cheaper to cover here than in the cell
+    // rasterizer.
+    bool preferred() const;
+    void rasterize(const VRect &clip, VRle &rle) const;
+
+private:
+    // a pixel row of the shape, the height of its straight part and the
+    // bands of the corner ellipses it crosses, in units of their radius.
+    struct Row {
+        double y0, y1;
+        double straight;
+        int    bands;
+        struct Band {
+            double v0, v1;  // 0 <= v0 < v1 <= 1
+            double s0, s1;  // sqrt(1 - v^2) at v0 and v1
+            double h0, h1;  // integral of sqrt(1 - v^2) up to v0 and v1
+            double height;
+        } band[2];
+    };
+    struct Spans;
+    Row  row(int y, const Row &prev) const;
+    void scanline(const Row &row, int xs, int fs, int fe, int xe, int y,
+                  Spans &spans) const;
+
+private:
+    // bounds of the shape and the radii of its corners, 0 for a rectangle.
+    double mLeft{0}, mTop{0}, mRight{0}, mBottom{0};
+    double mRx{0}, mRy{0};
+};
+
+V_END_NAMESPACE
+
+#endif  // VSHAPERASTER_H
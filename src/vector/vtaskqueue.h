@@ -23,7 +23,9 @@
 #ifndef VTASKQUEUE_H
 #define VTASKQUEUE_H
 
+#include <condition_variable>
 #include <deque>
+#include <mutex>
 
 template <typename Task>
 class TaskQueue {
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "vtaskscheduler.h"
+
+#ifdef LOTTIE_THREAD_SUPPORT
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "vtaskqueue.h"
+
+struct VTaskScheduler::Impl {
+    const unsigned               mCount{
+        std::max(1u, std::thread::hardware_concurrency())};
+    std::vector<std::thread>     mThreads;
+    std::vector<TaskQueue<Task>> mQueue{mCount};
+    std::atomic<unsigned>        mIndex{0};
+    std::atomic<bool>            mRunning{false};
+
+    void run(unsigned i)
+    {
+        Task task;
+        while (true) {
+            bool success = false;
+
+            for (unsigned n = 0; n != mCount * 2; ++n) {
+                if (mQueue[(i + n) % mCount].try_pop(task)) {
+                    success = true;
+                    break;
+                }
+            }
+
+            // pop() only fails once the queue is drained and stopped.
+            if (!success && !mQueue[i].pop(task)) break;
+
+            task();
+        }
+    }
+
+    Impl()
+    {
+        for (unsigned n = 0; n != mCount; ++n) {
+            mThreads.emplace_back([&, n] { run(n); });
+        }
+        mRunning = true;
+    }
+
+    void stop()
+    {
+        if (mRunning) {
+            mRunning = false;
+
+            for (auto &e : mQueue) e.done();
+            for (auto &e : mThreads) e.join();
+        }
+    }
+
+    void process(Task task)
+    {
+        if (!mRunning) {
+            task();
+            return;
+        }
+
+        auto i = mIndex++;
+
+        for (unsigned n = 0; n != mCount; ++n) {
+            if (mQueue[(i + n) % mCount].try_push(std::move(task))) return;
+        }
+
+        mQueue[i % mCount].push(std::move(task));
+    }
+};
+
+/*
+ * State of one parallelFor() call. Every participant (the caller and the
+ * helper tasks) claims indices until none are left, so the caller never
+ * depends on a free pool thread to make progress.
+ */
+struct ParallelJob {
+    const std::function<void(size_t)> *fn{nullptr};
+    size_t                             count{0};
+    std::atomic<size_t>                next{0};
+    std::atomic<size_t>                done{0};
+    std::mutex                         mutex;
+    std::condition_variable            finished;
+
+    void work()
+    {
+        size_t i;
+        while ((i = next++) < count) {
+            (*fn)(i);
+            if (++done == count) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+VTaskScheduler::VTaskScheduler() : mImpl(std::make_unique<Impl>()) {}
+
+VTaskScheduler::~VTaskScheduler()
+{
+    stop();
+}
+
+unsigned VTaskScheduler::concurrency() const
+{
+    return mImpl->mRunning ? mImpl->mCount : 1;
+}
+
+void VTaskScheduler::process(Task task)
+{
+    mImpl->process(std::move(task));
+}
+
+void VTaskScheduler::parallelFor(size_t                             count,
+                                 const std::function<void(size_t)> &fn)
+{
+    if (count == 0) return;
+
+    if (count == 1 || concurrency() == 1) {
+        for (size_t i = 0; i < count; i++) fn(i);
+        return;
+    }
+
+    auto job = std::make_shared<ParallelJob>();
+    job->fn = &fn;
+    job->count = count;
+
+    auto helpers = std::min<size_t>(count - 1, mImpl->mCount);
+    for (size_t i = 0; i < helpers; i++) {
+        process([job]() { job->work(); });
+    }
+
+    job->work();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&job]() { return job->done == job->count; });
+}
+
+void VTaskScheduler::stop()
+{
+    mImpl->stop();
+}
+
+#else
+
+struct VTaskScheduler::Impl {
+};
+
+VTaskScheduler::VTaskScheduler() = default;
+
+VTaskScheduler::~VTaskScheduler() = default;
+
+unsigned VTaskScheduler::concurrency() const
+{
+    return 1;
+}
+
+void VTaskScheduler::process(Task task)
+{
+    task();
+}
+
+void VTaskScheduler::parallelFor(size_t                             count,
+                                 const std::function<void(size_t)> &fn)
+{
+    for (size_t i = 0; i < count; i++) fn(i);
+}
+
+void VTaskScheduler::stop() {}
+
+#endif
+
+VTaskScheduler &VTaskScheduler::instance()
+{
+    static VTaskScheduler singleton;
+    return singleton;
+}
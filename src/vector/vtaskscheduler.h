@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020 Samsung Electronics Co., Ltd. All rights reserved.
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VTASKSCHEDULER_H
+#define VTASKSCHEDULER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "config.h"
+#include "vglobal.h"
+
+/*
+ * Shared worker pool used for load time work (parsing, image decoding).
+ * The render path stays single threaded.
+ * When the library is built without LOTTIE_THREAD_SUPPORT every task
+ * runs inline on the calling thread.
+ */
+class VTaskScheduler {
+public:
+    using Task = std::function<void()>;
+
+    static VTaskScheduler &instance();
+
+    // number of threads that can run tasks in parallel (1 when no threading).
+    unsigned concurrency() const;
+
+    // queue the task on the pool and return immediately.
+    void process(Task task);
+
+    /*
+     * run fn(0) .. fn(count - 1) and return when all of them are finished.
+     * The calling thread also runs the tasks, so it is safe to call this
+     * from inside a pool task.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)> &fn);
+
+    void stop();
+
+    ~VTaskScheduler();
+
+private:
+    VTaskScheduler();
+    struct Impl;
+    std::unique_ptr<Impl> mImpl;
+};
+
+#endif  // VTASKSCHEDULER_H
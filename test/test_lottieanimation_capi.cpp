@@ -29,10 +29,9 @@ TEST_F(AnimationCApiTest, loadFromFile_N)
 TEST_F(AnimationCApiTest, loadFromFile)
 {
     ASSERT_TRUE(animation);
-    ASSERT_EQ(lottie_animation_get_totalframe(animation), 30);
+    ASSERT_EQ(lottie_animation_get_totalframe(animation), 31);
     size_t width, height;
     lottie_animation_get_size(animation, &width, &height);
-        }
-    }
-    ASSERT_TRUE(has_visible_pixels);
+    ASSERT_EQ(width, 500);
+    ASSERT_EQ(height, 500);
 }
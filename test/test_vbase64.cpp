@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "vbase64.h"
+
+class VBase64Test : public ::testing::Test {
+public:
+    std::vector<uint8_t> decode(const std::string &input)
+    {
+        std::vector<uint8_t> out(vBase64DecodedSize(input.size()));
+        out.resize(vBase64Decode(input.c_str(), input.size(), out.data()));
+        return out;
+    }
+    std::vector<uint8_t> decodeScalar(const std::string &input)
+    {
+        std::vector<uint8_t> out(vBase64DecodedSize(input.size()));
+        out.resize(vBase64DecodeScalar(input.c_str(), input.size(), out.data()));
+        return out;
+    }
+    std::string text(const std::vector<uint8_t> &data)
+    {
+        return std::string(data.begin(), data.end());
+    }
+};
+
+TEST_F(VBase64Test, decode)
+{
+    ASSERT_EQ(text(decode("")), "");
+    ASSERT_EQ(text(decode("TQ==")), "M");
+    ASSERT_EQ(text(decode("TWE=")), "Ma");
+    ASSERT_EQ(text(decode("TWFu")), "Man");
+    ASSERT_EQ(text(decode("TWE")), "Ma");
+    ASSERT_EQ(text(decode("TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsuTWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsu")),
+              "Many hands make light work.Many hands make light work.");
+}
+
+TEST_F(VBase64Test, matchesScalar)
+{
+    const std::string alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::mt19937 rng(42);
+    for (size_t len = 0; len < 300; len++) {
+        std::string input;
+        for (size_t i = 0; i < len; i++) input += alphabet[rng() % 64];
+        ASSERT_EQ(decode(input), decodeScalar(input));
+
+        // url safe alphabet and garbage take the scalar path inside a block.
+        if (len > 8) {
+            input[rng() % len] = "-_ \n\x80"[rng() % 5];
+            ASSERT_EQ(decode(input), decodeScalar(input));
+        }
+        if (len > 2) {
+            input[len - 1] = '=';
+            ASSERT_EQ(decode(input), decodeScalar(input));
+        }
+    }
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "vinterpolator.h"
+
+class VInterpolatorTest : public ::testing::Test {
+public:
+    float maxError(const VInterpolator &a, const VInterpolator &b)
+    {
+        float error = 0;
+        for (int i = 0; i <= 4096; i++) {
+            float t = float(i) / 4096;
+            error = std::max(error, std::fabs(a.value(t) - b.value(t)));
+        }
+        return error;
+    }
+};
+
+TEST_F(VInterpolatorTest, linear)
+{
+    VInterpolator linear(0.5f, 0.5f, 0.5f, 0.5f);
+    ASSERT_FALSE(linear.buildTable());
+    ASSERT_EQ(linear.value(0.3f), 0.3f);
+}
+
+TEST_F(VInterpolatorTest, tableError)
+{
+    VInterpolator exact(0.333f, 0.0f, 0.667f, 1.0f);
+    VInterpolator table(0.333f, 0.0f, 0.667f, 1.0f);
+    ASSERT_TRUE(table.buildTable(0.0001f));
+    ASSERT_TRUE(table.hasTable());
+    ASSERT_LE(maxError(exact, table), 0.0001f);
+    ASSERT_FLOAT_EQ(table.value(0), exact.value(0));
+    ASSERT_FLOAT_EQ(table.value(1), exact.value(1));
+}
+
+TEST_F(VInterpolatorTest, tableRejected)
+{
+    // close to a step, a table can't follow it.
+    VInterpolator step(1.0f, 0.0f, 0.0f, 1.0f);
+    ASSERT_FALSE(step.buildTable(0.0001f));
+    ASSERT_FALSE(step.hasTable());
+}
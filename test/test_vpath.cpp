@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "vpath.h"
+#include "vpathmesure.h"
 
 class VPathTest : public ::testing::Test {
 public:
@@ -188,3 +189,59 @@ TEST_F(VPathTest, addPolystarZeroRoundness) {
     ASSERT_EQ(pathPolystarZero.elements().size() , pathPolystarZero.elements().capacity());
     ASSERT_EQ(pathPolystarZero.points().size() , pathPolystarZero.points().capacity());
 }
+
+TEST_F(VPathTest, addSpline) {
+    std::vector<VPointF> start, end;
+    for (int i = 0; i < 13; i++) {
+        start.emplace_back(i * 1.5f, -i * 2.0f);
+        end.emplace_back(i * 3.0f + 1, i * 0.5f);
+    }
+    VPath expected;
+    expected.moveTo(start[0] + 0.3f * (end[0] - start[0]));
+    for (size_t i = 1; i < start.size(); i += 3) {
+        expected.cubicTo(start[i] + 0.3f * (end[i] - start[i]),
+                         start[i + 1] + 0.3f * (end[i + 1] - start[i + 1]),
+                         start[i + 2] + 0.3f * (end[i + 2] - start[i + 2]));
+    }
+    expected.close();
+
+    VPath path;
+    path.addSpline(start.data(), end.data(), start.size(), 0.3f, true);
+    ASSERT_EQ(path.segments() , 1);
+    ASSERT_EQ(path.elements() , expected.elements());
+    ASSERT_EQ(path.points().size() , expected.points().size());
+    for (size_t i = 0; i < path.points().size(); i++) {
+        ASSERT_EQ(path.points()[i].x() , expected.points()[i].x());
+        ASSERT_EQ(path.points()[i].y() , expected.points()[i].y());
+    }
+}
+
+TEST_F(VPathTest, transform) {
+    VMatrix m;
+    m.translate(10, -5).rotate(30).scale(1.5, 0.5);
+    VPath path = pathPolystar;
+    path.transform(m);
+    ASSERT_EQ(path.points().size() , pathPolystar.points().size());
+    for (size_t i = 0; i < path.points().size(); i++) {
+        VPointF p = m.map(pathPolystar.points()[i]);
+        ASSERT_EQ(path.points()[i].x() , p.x());
+        ASSERT_EQ(path.points()[i].y() , p.y());
+    }
+}
+
+TEST_F(VPathTest, trimCachedLength) {
+    VPathMesure cached;
+    for (int i = 1; i < 10; i++) {
+        VPathMesure fresh;
+        fresh.setRange(0.05f * i, 0.1f * i);
+        cached.setRange(0.05f * i, 0.1f * i);
+        VPath expected = fresh.trim(pathPolystar);
+        VPath path = cached.trim(pathPolystar);
+        ASSERT_EQ(path.elements() , expected.elements());
+        ASSERT_EQ(path.points().size() , expected.points().size());
+        ASSERT_NEAR(path.length() , pathPolystar.length() * 0.05f * i, 0.5f);
+    }
+    cached.setRange(0.25f, 0.75f);
+    cached.invalidate();
+    ASSERT_NEAR(cached.trim(pathRect).length() , pathRect.length() / 2, 0.01f);
+}
@@ -0,0 +1,321 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "vbezier.h"
+#include "vpath.h"
+#include "vraster.h"
+#include "vrle.h"
+
+// the cell rasterizer rounds the points to 1/64 of a pixel, which moves an
+// edge by up to 4 levels of a pixel it crosses, twice at a vertex.
+static const int Tolerance = 8;
+// the dense one flattens a cubic to 0.05 pixel of the curve, up to 13 levels.
+static const int CurveTolerance = 16;
+
+class VRasterTest : public ::testing::Test {
+public:
+    void TearDown() { VRasterizer::setScanner(VRasterizer::Scanner::Auto); }
+
+    // the coverage of the spans of rle within rect, row by row.
+    static std::vector<int> coverage(const VRle &rle, const VRect &rect)
+    {
+        struct Grid {
+            std::vector<int> cov;
+            VRect            rect;
+        } grid{std::vector<int>(size_t(rect.width() * rect.height()), 0), rect};
+        rle.intersect(rect,
+                      [](size_t count, const VRle::Span *spans, void *data) {
+                          auto &g = *static_cast<Grid *>(data);
+                          for (size_t i = 0; i < count; i++) {
+                              auto row = size_t(spans[i].y - g.rect.top()) *
+                                         size_t(g.rect.width());
+                              for (int x = 0; x < spans[i].len; x++)
+                                  g.cov[row + size_t(spans[i].x + x -
+                                                     g.rect.left())] +=
+                                      spans[i].coverage;
+                          }
+                      },
+                      &grid);
+        return grid.cov;
+    }
+
+    static VRle fill(VRasterizer::Scanner scanner, const VPath &path,
+                     FillRule rule, const VRect &clip = VRect())
+    {
+        VRasterizer::setScanner(scanner);
+        VRasterizer raster;
+        raster.rasterize(path, rule, clip);
+        return raster.rle();
+    }
+
+    // the largest coverage difference of a pixel between scanner and the
+    // cell rasterizer.
+    static int difference(
+        const VPath &path, FillRule rule, const VRect &rect,
+        const VRect &        clip = VRect(),
+        VRasterizer::Scanner scanner = VRasterizer::Scanner::Dense)
+    {
+        // the cell rasterizer gives up on a row with more cells than its pool
+        // holds, it draws the reference a column at a time.
+        VRect            area = clip.empty() ? rect : clip;
+        std::vector<int> cell(size_t(rect.width() * rect.height()), 0);
+        for (int x = area.left(); x < area.right(); x += 1024) {
+            VRect column(x, area.top(), std::min(1024, area.right() - x),
+                         area.height());
+            auto  part = coverage(fill(VRasterizer::Scanner::Cell,
+                                      flatten(path), rule, column),
+                                 rect);
+            for (size_t i = 0; i < cell.size(); i++) cell[i] += part[i];
+        }
+        auto other = coverage(fill(scanner, path, rule, clip), rect);
+        int  max = 0;
+        for (size_t i = 0; i < cell.size(); i++)
+            max = std::max(max, std::abs(cell[i] - other[i]));
+        return max;
+    }
+
+    // the cubics of path as many short lines, the cell rasterizer flattens
+    // them coarser than the dense one, this way it takes the exact curve.
+    static VRle stroke(VRasterizer::Scanner scanner, const VPath &path,
+                       float width)
+    {
+        VRasterizer::setScanner(scanner);
+        VRasterizer raster;
+        raster.rasterize(path, CapStyle::Flat, JoinStyle::Miter, width, 4);
+        return raster.rle();
+    }
+
+    static VPath flatten(const VPath &path)
+    {
+        VPath       result;
+        const auto &points = path.points();
+        size_t      i = 0;
+        for (auto e : path.elements()) {
+            switch (e) {
+            case VPath::Element::MoveTo:
+                result.moveTo(points[i++]);
+                break;
+            case VPath::Element::LineTo:
+                result.lineTo(points[i++]);
+                break;
+            case VPath::Element::CubicTo: {
+                auto b = VBezier::fromPoints(points[i - 1], points[i],
+                                             points[i + 1], points[i + 2]);
+                for (int k = 1; k <= 256; k++)
+                    result.lineTo(b.pointAt(k / 256.0f));
+                i += 3;
+                break;
+            }
+            case VPath::Element::Close:
+                result.close();
+                break;
+            }
+        }
+        return result;
+    }
+
+    static VPath star(float cx, float cy, float radius, int points)
+    {
+        VPath path;
+        for (int i = 0; i < points; i++) {
+            // every second vertex, the edges cross each other.
+            float   a = 6.2831853f * float(i * 2 % points) / points;
+            VPointF pt(cx + radius * std::cos(a), cy + radius * std::sin(a));
+            if (i)
+                path.lineTo(pt);
+            else
+                path.moveTo(pt);
+        }
+        path.close();
+        return path;
+    }
+};
+
+TEST_F(VRasterTest, denseMatchesCellNonZero)
+{
+    VPath path = star(100, 100, 90, 7);
+    EXPECT_LE(difference(path, FillRule::Winding, VRect(0, 0, 200, 200)),
+              Tolerance);
+}
+
+TEST_F(VRasterTest, denseMatchesCellEvenOdd)
+{
+    VPath path = star(100, 100, 90, 7);
+    EXPECT_LE(difference(path, FillRule::EvenOdd, VRect(0, 0, 200, 200)),
+              Tolerance);
+
+    // the center of the star is out with even-odd, in with nonzero.
+    auto cov = coverage(
+        fill(VRasterizer::Scanner::Dense, path, FillRule::EvenOdd),
+        VRect(0, 0, 200, 200));
+    EXPECT_EQ(cov[100 * 200 + 100], 0);
+    cov = coverage(fill(VRasterizer::Scanner::Dense, path, FillRule::Winding),
+                   VRect(0, 0, 200, 200));
+    EXPECT_EQ(cov[100 * 200 + 100], 255);
+}
+
+TEST_F(VRasterTest, denseMatchesCellCubics)
+{
+    VPath path;
+    path.addCircle(100, 100, 73.3f);
+    path.addOval(VRectF(40.25f, 60.5f, 120, 80), VPath::Direction::CCW);
+    EXPECT_LE(difference(path, FillRule::Winding, VRect(0, 0, 200, 200)),
+              CurveTolerance);
+    EXPECT_LE(difference(path, FillRule::EvenOdd, VRect(0, 0, 200, 200)),
+              CurveTolerance);
+}
+
+TEST_F(VRasterTest, denseMatchesCellClipped)
+{
+    // the path crosses every side of the clip.
+    VPath path = star(100, 100, 140, 9);
+    path.addCircle(100, 100, 120);
+    VRect clip(30, 40, 120, 110);
+    EXPECT_LE(difference(path, FillRule::Winding, VRect(0, 0, 200, 200), clip),
+              CurveTolerance);
+    EXPECT_LE(difference(path, FillRule::EvenOdd, VRect(0, 0, 200, 200), clip),
+              CurveTolerance);
+
+    auto cov = coverage(
+        fill(VRasterizer::Scanner::Dense, path, FillRule::Winding, clip),
+        VRect(0, 0, 200, 200));
+    for (int y = 0; y < 200; y++)
+        for (int x = 0; x < 200; x++)
+            if (!clip.contains(VRect(x, y, 1, 1)))
+                ASSERT_EQ(cov[size_t(y * 200 + x)], 0);
+}
+
+TEST_F(VRasterTest, denseMatchesCellStrips)
+{
+    // taller than a strip of rows.
+    VPath tall;
+    tall.addCircle(60, 300, 50);
+    tall.addRect(VRectF(10.5f, 10.5f, 100, 580));
+    EXPECT_LE(difference(tall, FillRule::EvenOdd, VRect(0, 0, 120, 600)),
+              CurveTolerance);
+
+    // wider than the accumulation buffer of a strip, one row at a time.
+    VPath wide;
+    wide.moveTo(5.5f, 5);
+    wide.lineTo(19989.25f, 15.5f);
+    wide.lineTo(19000, 35.75f);
+    wide.cubicTo(12000, 50, 8000, -10, 5.5f, 30);
+    wide.close();
+    EXPECT_LE(difference(wide, FillRule::Winding, VRect(0, 0, 20000, 40)),
+              CurveTolerance);
+}
+
+TEST_F(VRasterTest, largePath)
+{
+    // more points than the 16 bit counts of the freetype outline could hold.
+    VPath     path;
+    const int count = 12000;
+    for (int i = 0; i < count; i++) {
+        float   a = 6.2831853f * i / count;
+        VPointF pt(50 + 40 * std::cos(a), 50 + 40 * std::sin(a));
+        if (i)
+            path.lineTo(pt);
+        else
+            path.moveTo(pt);
+    }
+    path.close();
+
+    auto cov =
+        coverage(fill(VRasterizer::Scanner::Cell, path, FillRule::Winding),
+                 VRect(0, 0, 100, 100));
+    EXPECT_EQ(cov[50 * 100 + 50], 255);
+    EXPECT_EQ(cov[50 * 100 + 91], 0);
+
+    cov = coverage(stroke(VRasterizer::Scanner::Cell, path, 4),
+                   VRect(0, 0, 100, 100));
+    EXPECT_EQ(cov[50 * 100 + 50], 0);
+    EXPECT_EQ(cov[50 * 100 + 90], 255);
+    EXPECT_EQ(cov[50 * 100 + 97], 0);
+}
+
+TEST_F(VRasterTest, rectCoverage)
+{
+    // a rect on half pixels, its edges get half of the coverage.
+    VPath path;
+    path.addRect(VRectF(10.5f, 10.5f, 79, 79));
+    auto cov =
+        coverage(fill(VRasterizer::Scanner::Auto, path, FillRule::Winding),
+                 VRect(0, 0, 100, 100));
+    EXPECT_NEAR(cov[50 * 100 + 10], 128, 1);
+    EXPECT_EQ(cov[50 * 100 + 11], 255);
+    EXPECT_NEAR(cov[50 * 100 + 89], 128, 1);
+    EXPECT_EQ(cov[50 * 100 + 90], 0);
+    EXPECT_NEAR(cov[10 * 100 + 10], 64, 1);
+
+    // the area of the rounded corners against the cells of a finely
+    // flattened copy.
+    VPath round;
+    round.addRoundRect(VRectF(10.25f, 20.75f, 150, 90), 12.5f);
+    EXPECT_LE(difference(round, FillRule::Winding, VRect(0, 0, 200, 200),
+                         VRect(), VRasterizer::Scanner::Auto),
+              CurveTolerance);
+}
+
+TEST_F(VRasterTest, thinStrokeCoverage)
+{
+    // a one pixel stroke on the pixel edges, half on each side of them.
+    VPath path;
+    path.addRect(VRectF(20, 20, 300, 300));
+    auto cov = coverage(stroke(VRasterizer::Scanner::Auto, path, 1),
+                        VRect(0, 0, 340, 340));
+    EXPECT_EQ(cov[150 * 340 + 18], 0);
+    EXPECT_NEAR(cov[150 * 340 + 19], 128, 1);
+    EXPECT_NEAR(cov[150 * 340 + 20], 128, 1);
+    EXPECT_EQ(cov[150 * 340 + 21], 0);
+    EXPECT_NEAR(cov[320 * 340 + 150], 128, 1);
+    // the miter corners, outside and inside.
+    EXPECT_NEAR(cov[19 * 340 + 19], 64, 1);
+    EXPECT_NEAR(cov[20 * 340 + 20], 191, 1);
+    EXPECT_NEAR(cov[320 * 340 + 320], 64, 1);
+}
+
+TEST_F(VRasterTest, thinStrokeCurves)
+{
+    // a circle of 16 cubic arcs, off the true one by far less than a level,
+    // against the area of the ring sampled 16x16 times a pixel. The stroker
+    // is off by about 30 levels here.
+    const float cx = 80.3f, cy = 70.6f, radius = 60;
+    const int   arcs = 16;
+    const float step = 6.2831853f / arcs;
+    const float k = 4.0f / 3 * std::tan(step / 4) * radius;
+    VPath       path;
+    path.moveTo(cx + radius, cy);
+    for (int i = 0; i < arcs; i++) {
+        float a0 = i * step, a1 = (i + 1) * step;
+        path.cubicTo(cx + radius * std::cos(a0) - k * std::sin(a0),
+                     cy + radius * std::sin(a0) + k * std::cos(a0),
+                     cx + radius * std::cos(a1) + k * std::sin(a1),
+                     cy + radius * std::sin(a1) - k * std::cos(a1),
+                     cx + radius * std::cos(a1), cy + radius * std::sin(a1));
+    }
+    path.close();
+
+    for (float width : {1.0f, 1.5f}) {
+        auto cov = coverage(stroke(VRasterizer::Scanner::Auto, path, width),
+                            VRect(0, 0, 160, 160));
+        int  max = 0;
+        for (int y = 0; y < 160; y++) {
+            for (int x = 0; x < 160; x++) {
+                int in = 0;
+                for (int j = 0; j < 16; j++) {
+                    for (int i = 0; i < 16; i++) {
+                        float dx = x + (i + 0.5f) / 16 - cx;
+                        float dy = y + (j + 0.5f) / 16 - cy;
+                        float d = std::sqrt(dx * dx + dy * dy) - radius;
+                        if (std::fabs(d) < width / 2) in++;
+                    }
+                }
+                int ref = (in * 255 + 128) / 256;
+                max = std::max(max, std::abs(cov[size_t(y * 160 + x)] - ref));
+            }
+        }
+        EXPECT_LE(max, CurveTolerance);
+    }
+}
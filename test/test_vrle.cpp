@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "vrle.h"
+
+class VRleTest : public ::testing::Test {
+public:
+    static const int Width = 1600;
+    static const int Height = 64;
+
+    // rows of random spans, some rows left out, some wider than 1024px.
+    VRle random(int width, int height, int length = 30)
+    {
+        VRle                    rle;
+        std::vector<VRle::Span> row;
+        int                     top = next(height / 2);
+        int                     bottom = top + next(height - top);
+        for (int y = top; y < bottom; y++) {
+            row.clear();
+            int x = next(width / 4);
+            while (x < width - 32) {
+                VRle::Span span;
+                span.x = short(x);
+                span.y = short(y);
+                span.len = uint16_t(1 + next(length));
+                span.coverage = uint8_t(next(3) ? 255 : next(256));
+                if (next(5)) row.push_back(span);
+                x += span.len + next(3) * next(20);
+            }
+            if (next(4) && !row.empty()) rle.addSpan(row.data(), row.size());
+        }
+        return rle;
+    }
+
+    std::vector<int> coverage(const VRle &rle)
+    {
+        std::vector<int> grid(size_t(Width * Height), 0);
+        rle.intersect(VRect(0, 0, Width, Height),
+                      [](size_t count, const VRle::Span *spans, void *data) {
+                          auto &grid = *static_cast<std::vector<int> *>(data);
+                          for (size_t i = 0; i < count; i++)
+                              for (int x = 0; x < spans[i].len; x++)
+                                  grid[size_t(spans[i].y * Width +
+                                              spans[i].x + x)] +=
+                                      spans[i].coverage;
+                      },
+                      &grid);
+        return grid;
+    }
+
+    // the coverage and the bounding rect of result against the one per pixel.
+    template <typename Fn>
+    void check(const VRle &a, const VRle &b, const VRle &result, Fn fn)
+    {
+        auto ca = coverage(a);
+        auto cb = coverage(b);
+        auto cr = coverage(result);
+        int  mismatch = 0;
+        int  l = Width, t = Height, r = 0, bt = 0;
+        for (int i = 0; i < Width * Height; i++) {
+            if (cr[size_t(i)] != fn(ca[size_t(i)], cb[size_t(i)])) mismatch++;
+            if (!cr[size_t(i)]) continue;
+            l = std::min(l, i % Width);
+            r = std::max(r, i % Width + 1);
+            t = std::min(t, i / Width);
+            bt = std::max(bt, i / Width + 1);
+        }
+        ASSERT_EQ(mismatch, 0);
+        if (l < r) {
+            ASSERT_TRUE(
+                result.boundingRect().contains(VRect(l, t, r - l, bt - t)));
+        }
+    }
+
+    static int divBy255(int x) { return (x + (x >> 8) + 0x80) >> 8; }
+
+private:
+    int next(int n)
+    {
+        seed = seed * 1103515245 + 12345;
+        return n > 0 ? int((seed >> 8) % unsigned(n)) : 0;
+    }
+    unsigned seed{1};
+};
+
+TEST_F(VRleTest, intersect) {
+    for (int i = 0; i < 50; i++) {
+        VRle a = random(Width, Height);
+        VRle b = random(Width, Height);
+        check(a, b, a & b, [](int a, int b) { return divBy255(a * b); });
+        VRle c = a;
+        c &= b;
+        check(a, b, c, [](int a, int b) { return divBy255(a * b); });
+    }
+}
+
+TEST_F(VRleTest, substract) {
+    for (int i = 0; i < 50; i++) {
+        VRle a = random(Width, Height);
+        VRle b = random(Width, Height);
+        check(a, b, a - b,
+              [](int a, int b) { return divBy255((255 - b) * a); });
+    }
+}
+
+TEST_F(VRleTest, add) {
+    for (int i = 0; i < 50; i++) {
+        VRle a = random(Width, Height);
+        VRle b = random(Width, Height);
+        check(a, b, a + b,
+              [](int a, int b) { return b + divBy255((255 - b) * a); });
+    }
+}
+
+TEST_F(VRleTest, xor) {
+    for (int i = 0; i < 50; i++) {
+        VRle a = random(Width, Height);
+        VRle b = random(Width, Height);
+        check(a, b, a ^ b, [](int a, int b) {
+            return divBy255((255 - b) * a + b * (255 - a));
+        });
+    }
+}
+
+TEST_F(VRleTest, rect) {
+    for (int i = 0; i < 50; i++) {
+        VRle rect;
+        for (int y = 10; y < 30; y++) {
+            VRle::Span span;
+            span.x = 100;
+            span.y = short(y);
+            span.len = 1200;
+            span.coverage = 255;
+            rect.addSpan(&span, 1);
+        }
+        VRle b = random(Width, Height);
+        check(rect, b, VRect(100, 10, 1200, 20) & b,
+              [](int a, int b) { return divBy255(a * b); });
+        check(rect, b, VRect(100, 10, 1200, 20) - b,
+              [](int a, int b) { return divBy255((255 - b) * a); });
+    }
+}
+
+TEST_F(VRleTest, band) {
+    VRle a = random(Width, Height);
+    VRle band;
+    a.intersect(VRect(0, 20, Width, 8),
+                [](size_t count, const VRle::Span *spans, void *data) {
+                    static_cast<VRle *>(data)->addSpan(spans, count);
+                },
+                &band);
+    auto ca = coverage(a);
+    auto cb = coverage(band);
+    for (int i = 0; i < Width * Height; i++) {
+        int y = i / Width;
+        ASSERT_EQ(cb[size_t(i)], (y >= 20 && y < 28) ? ca[size_t(i)] : 0);
+    }
+}
+
+// long spans of any coverage through the line kernels and their scalar tail,
+// the result has to match the scalar math exactly.
+TEST_F(VRleTest, kernels) {
+    for (int i = 0; i < 50; i++) {
+        VRle a = random(Width, Height, 200);
+        VRle b = random(Width, Height, 200);
+        a *= uint8_t(1 + i * 5);
+        check(a, b, a - b,
+              [](int a, int b) { return divBy255((255 - b) * a); });
+        check(a, b, a + b,
+              [](int a, int b) { return b + divBy255((255 - b) * a); });
+        check(a, b, a ^ b, [](int a, int b) {
+            return divBy255((255 - b) * a + b * (255 - a));
+        });
+    }
+}